@@ -1078,7 +1078,7 @@ void PaintToolWindow::Update(float dt)
 						wi::jobsystem::Execute(ctx, [=](wi::jobsystem::JobArgs args) {
 							if (mesh->bvh.IsValid())
 							{
-								mesh->BuildBVH();
+								mesh->BuildBVH(wi::BVH::BuildMode::FAST);
 							}
 
 							if (chunk_data != nullptr)
@@ -1783,7 +1783,7 @@ void PaintToolWindow::ConsumeHistoryOperation(wi::Archive& archive, bool undo)
 
 			if (mesh->bvh.IsValid())
 			{
-				mesh->BuildBVH();
+				mesh->BuildBVH(wi::BVH::BuildMode::FAST);
 			}
 
 			// refresh terrain heightmap in case this mesh was a terrain chunk:
@@ -1,4 +1,6 @@
 #include "stdafx.h"
+#include "ModelImporter.h"
+#include "VizEngineAPIs.h"
 
 #define CONTENT_DIR "../../Content/"
 
@@ -27,6 +29,12 @@ enum TEST_TYPE
 	INVERSEKINEMATICSTEST,
 	INSTANCESTEST,
 	CONTAINERPERF,
+	ECSPERF,
+	IMPORTPERF,
+	SCENELOOKUPPERF,
+	SCENEQUERYPERF,
+	BVHBUILDPERF,
+	CULLINGPERF,
 };
 
 // Controller Test UI Data, info down below will be using Xbox Controller as reference
@@ -159,6 +167,12 @@ void TestsRenderer::Load()
 	testSelector.AddItem("Inverse Kinematics", INVERSEKINEMATICSTEST);
 	testSelector.AddItem("65k Instances", INSTANCESTEST);
 	testSelector.AddItem("Container perf", CONTAINERPERF);
+	testSelector.AddItem("ECS perf", ECSPERF);
+	testSelector.AddItem("Import perf", IMPORTPERF);
+	testSelector.AddItem("Scene lookup perf", SCENELOOKUPPERF);
+	testSelector.AddItem("Scene query perf", SCENEQUERYPERF);
+	testSelector.AddItem("BVH build perf", BVHBUILDPERF);
+	testSelector.AddItem("Frustum culling perf", CULLINGPERF);
 	testSelector.SetMaxVisibleItemCount(10);
 	testSelector.OnSelect([=](wi::gui::EventArgs args) {
 
@@ -418,6 +432,30 @@ void TestsRenderer::Load()
 			ContainerTest();
 			break;
 
+		case ECSPERF:
+			ComponentManagerTest();
+			break;
+
+		case IMPORTPERF:
+			ImportTest();
+			break;
+
+		case SCENELOOKUPPERF:
+			SceneLookupTest();
+			break;
+
+		case SCENEQUERYPERF:
+			SceneQueryTest();
+			break;
+
+		case BVHBUILDPERF:
+			BVHBuildTest();
+			break;
+
+		case CULLINGPERF:
+			CullingTest();
+			break;
+
 		default:
 			assert(0);
 			break;
@@ -687,6 +725,92 @@ void TestsRenderer::RunJobSystemTest()
 		ss += "wi::jobsystem::Dispatch() took " + std::to_string(time) + " milliseconds\n";
 	}
 
+	ss += "\n3) Throughput test (small jobs submitted from 1-64 threads at the same time):\n";
+
+	for (uint32_t submitterCount = 1; submitterCount <= 64; submitterCount *= 2)
+	{
+		const uint32_t jobCount = 64 * 1024;
+		std::atomic<uint32_t> executed{ 0 };
+		wi::vector<std::thread> submitters;
+		timer.record();
+		for (uint32_t i = 0; i < submitterCount; ++i)
+		{
+			submitters.emplace_back([&] {
+				wi::jobsystem::context submitter_ctx;
+				for (uint32_t j = 0; j < jobCount / submitterCount; ++j)
+				{
+					wi::jobsystem::Execute(submitter_ctx, [&](wi::jobsystem::JobArgs args) { executed.fetch_add(1, std::memory_order_relaxed); });
+				}
+				wi::jobsystem::Wait(submitter_ctx);
+			});
+		}
+		for (auto& x : submitters)
+		{
+			x.join();
+		}
+		double time = timer.elapsed();
+		ss += std::to_string(submitterCount) + " threads: " + std::to_string(uint64_t(executed.load() / (time / 1000.0))) + " jobs/sec\n";
+	}
+
+	// Dispatch latency: time from Dispatch() until the first job starts, and until Wait() returns
+	{
+		const uint32_t iterations = 1000;
+		double latency_start = 0;
+		double latency_wait = 0;
+		for (uint32_t i = 0; i < iterations; ++i)
+		{
+			wi::Timer started;
+			timer.record();
+			wi::jobsystem::Dispatch(ctx, 64, 1, [&](wi::jobsystem::JobArgs args) {
+				if (args.jobIndex == 0)
+				{
+					started.record();
+				}
+			});
+			wi::jobsystem::Wait(ctx);
+			latency_wait += timer.elapsed();
+			latency_start += timer.elapsed() - started.elapsed();
+		}
+		ss += "Dispatch latency: first job started after " + std::to_string(latency_start / iterations * 1000.0) + " us, Wait() returned after " + std::to_string(latency_wait / iterations * 1000.0) + " us\n";
+	}
+
+	ss += "\n4) TaskGraph test (two independent chains: 10ms -> 2ms and 2ms -> 10ms):\n";
+
+	// Barrier test:
+	{
+		timer.record();
+		wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(10); });
+		wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(2); });
+		wi::jobsystem::Wait(ctx); // dependencies
+		wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(2); });
+		wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(10); });
+		wi::jobsystem::Wait(ctx);
+		double time = timer.elapsed();
+		ss += "Wait() barriers took " + std::to_string(time) + " milliseconds\n";
+	}
+
+	// Task graph test:
+	{
+		timer.record();
+		wi::jobsystem::TaskGraph graph;
+		const uint32_t a = graph.Add([](wi::jobsystem::context& ctx) {
+			wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(10); });
+		});
+		const uint32_t b = graph.Add([](wi::jobsystem::context& ctx) {
+			wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(2); });
+		});
+		graph.Add([](wi::jobsystem::context& ctx) {
+			wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(2); });
+		}, { a });
+		graph.Add([](wi::jobsystem::context& ctx) {
+			wi::jobsystem::Dispatch(ctx, 2, 1, [](wi::jobsystem::JobArgs args) { wi::helper::Spin(10); });
+		}, { b });
+		graph.Run(ctx);
+		wi::jobsystem::Wait(ctx);
+		double time = timer.elapsed();
+		ss += "wi::jobsystem::TaskGraph took " + std::to_string(time) + " milliseconds\n";
+	}
+
 	static wi::SpriteFont font;
 	font = wi::SpriteFont(ss);
 	font.params.posX = GetLogicalWidth() / 2;
@@ -1256,3 +1380,467 @@ void TestsRenderer::ContainerTest()
 	font.params.size = 24;
 	this->AddFont(&font);
 }
+
+void TestsRenderer::ComponentManagerTest()
+{
+	wi::Timer timer;
+
+	std::string ss = "ComponentManager test, hash / paged lookup:\n";
+
+	for (size_t elements : { 10000ull, 100000ull, 1000000ull })
+	{
+		ss += "\n" + std::to_string(elements) + " entities:\n";
+
+		// Entities are sequential like they would be created by CreateEntity():
+		wi::vector<Entity> entities(elements);
+		for (size_t i = 0; i < elements; ++i)
+		{
+			entities[i] = Entity(i + 1);
+		}
+
+		double create[2] = {};
+		double lookup[2] = {};
+		double merge[2] = {};
+		double remove[2] = {};
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			const LookupMode lookup_mode = mode == 0 ? LookupMode::HASH : LookupMode::PAGED;
+			ComponentManager<TransformComponent> manager(0, lookup_mode);
+			ComponentManager<TransformComponent> other(0, lookup_mode);
+
+			// Create the first half of entities directly:
+			timer.record();
+			for (size_t i = 0; i < elements / 2; ++i)
+			{
+				manager.Create(entities[i]);
+			}
+			create[mode] = timer.elapsed_milliseconds();
+
+			// Merge the second half from an other manager:
+			for (size_t i = elements / 2; i < elements; ++i)
+			{
+				other.Create(entities[i]);
+			}
+			timer.record();
+			manager.Merge(other);
+			merge[mode] = timer.elapsed_milliseconds();
+
+			// Lookup in shuffled order:
+			timer.record();
+			float sum = 0;
+			for (size_t i = 0; i < elements; ++i)
+			{
+				const TransformComponent* transform = manager.GetComponent(entities[(i * 7919) % elements]);
+				sum += transform->scale_local.x;
+			}
+			lookup[mode] = timer.elapsed_milliseconds();
+			assert(sum == float(elements));
+
+			timer.record();
+			for (size_t i = 0; i < elements; ++i)
+			{
+				manager.Remove(entities[(i * 7919) % elements]);
+			}
+			remove[mode] = timer.elapsed_milliseconds();
+		}
+
+		auto result = [](const char* name, const double* ms) {
+			return std::string(name) + ": " + std::to_string(ms[0]) + " ms / " + std::to_string(ms[1]) + " ms\n";
+		};
+		ss += result("create", create);
+		ss += result("merge", merge);
+		ss += result("lookup", lookup);
+		ss += result("remove", remove);
+	}
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
+
+void TestsRenderer::ImportTest()
+{
+	wi::Timer timer;
+
+	const char* files[] = {
+		CONTENT_DIR "models/DamagedHelmet.glb",
+		CONTENT_DIR "models/CesiumMan.glb",
+		CONTENT_DIR "models/gltf_KHR_lights_punctual_test.glb",
+		CONTENT_DIR "models/teapot.obj",
+	};
+	const int runs = 3;
+
+	std::string ss = "Model import test (best of " + std::to_string(runs) + " runs, " + std::to_string(wi::jobsystem::GetThreadCount()) + " job threads):\n";
+
+	for (const char* file : files)
+	{
+		const bool obj = wi::helper::toUpper(wi::helper::GetExtensionFromFileName(file)) == "OBJ";
+
+		ss += "\n" + wi::helper::GetFileNameFromPath(file) + ": ";
+
+		double best = std::numeric_limits<double>::max();
+		uint64_t peak = 0;
+		wi::vector<uint8_t> cache; // the scene with embedded resources and precomputed mesh data, like vzm::SaveSceneCache
+		for (int run = 0; run < runs && best > 0; ++run)
+		{
+			const uint64_t before = wi::helper::GetMemoryUsage().process_physical;
+			Scene scene; // the imported textures are released with the scene, so every run decodes them again
+			timer.record();
+			Entity root = obj ? ImportModel_OBJ(file, scene) : ImportModel_GLTF(file, scene);
+			best = std::min(best, timer.elapsed_milliseconds());
+			const wi::helper::MemoryUsage after = wi::helper::GetMemoryUsage();
+			peak = std::max(peak, after.process_physical_peak);
+			if (root == INVALID_ENTITY)
+			{
+				best = 0;
+			}
+			else if (run == 0)
+			{
+				ss += std::to_string(scene.meshes.GetCount()) + " meshes, " + std::to_string(scene.materials.GetCount()) + " materials, +" + wi::helper::GetMemorySizeText(after.process_physical > before ? after.process_physical - before : 0) + " resident";
+
+				const wi::resourcemanager::Mode mode = wi::resourcemanager::GetMode();
+				wi::resourcemanager::SetMode(wi::resourcemanager::Mode::EMBED_FILE_DATA);
+				wi::Archive archive;
+				scene.Serialize(archive, true);
+				archive.WriteData(cache);
+				wi::resourcemanager::SetMode(mode);
+			}
+		}
+		if (best == 0)
+		{
+			ss += "import failed\n";
+			continue;
+		}
+		ss += "\nwall time: " + std::to_string(best) + " ms, process peak memory: " + wi::helper::GetMemorySizeText(peak) + "\n";
+
+		double best_cache = std::numeric_limits<double>::max();
+		for (int run = 0; run < runs; ++run)
+		{
+			Scene scene;
+			timer.record();
+			wi::Archive archive(cache.data(), cache.size());
+			scene.Serialize(archive);
+			best_cache = std::min(best_cache, timer.elapsed_milliseconds());
+		}
+		ss += "scene cache (" + wi::helper::GetMemorySizeText(cache.size()) + "): " + std::to_string(best_cache) + " ms\n";
+	}
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
+
+void TestsRenderer::SceneLookupTest()
+{
+	// vzm shares the graphics device of this application, it is only initialized once
+	vzm::InitEngineLib();
+
+	wi::Timer timer;
+
+	// The vzm component getters resolve the VID to its owner scene with the global entity index of the scene manager
+	const size_t entities_per_scene = 1000;
+	const size_t lookups = 1000000;
+
+	std::string ss = "Scene lookup test, " + std::to_string(lookups) + " vzm transform getter calls:\n";
+
+	bool valid = true;
+	for (size_t scene_count : { 1ull, 8ull, 32ull, 64ull })
+	{
+		wi::vector<VID> scenes(scene_count);
+		wi::vector<vzm::VmActor*> actors;
+		for (size_t i = 0; i < scene_count; ++i)
+		{
+			scenes[i] = vzm::NewScene("SceneLookupTest_" + std::to_string(i));
+			for (size_t j = 0; j < entities_per_scene; ++j)
+			{
+				vzm::VmActor* actor = nullptr;
+				vzm::NewSceneComponent(vzm::COMPONENT_TYPE::ACTOR, scenes[i], "actor", 0, CMPP(actor));
+				if (actor == nullptr)
+				{
+					valid = false;
+					continue;
+				}
+				const float position[3] = { float(j), 0, 0 };
+				actor->SetTranslate(position);
+				actors.push_back(actor);
+			}
+		}
+
+		timer.record();
+		float sum = 0;
+		for (size_t i = 0; i < lookups && !actors.empty(); ++i)
+		{
+			vzm::VmActor* actor = actors[(i * 7919) % actors.size()];
+			float local[16];
+			actor->GetLocalTransform(local);
+			sum += local[12];
+		}
+		const double elapsed = timer.elapsed_milliseconds();
+
+		// Removing an entity must release its descendants too:
+		vzm::VmActor* parent = nullptr;
+		vzm::VmActor* child = nullptr;
+		const VID parentVid = vzm::NewSceneComponent(vzm::COMPONENT_TYPE::ACTOR, scenes[0], "parent", 0, CMPP(parent));
+		const VID childVid = vzm::NewSceneComponent(vzm::COMPONENT_TYPE::ACTOR, scenes[0], "child", parentVid, CMPP(child));
+		vzm::RemoveComponent(parentVid);
+		valid &= vzm::GetComponent(vzm::COMPONENT_TYPE::ACTOR, childVid) == nullptr;
+
+		for (VID sceneVid : scenes)
+		{
+			vzm::RemoveComponent(sceneVid);
+		}
+
+		ss += "\n" + std::to_string(scene_count) + " scenes: " + std::to_string(elapsed) + " ms (checksum: " + std::to_string(sum) + ")";
+	}
+	ss += "\n\nDescendants released with their removed parent: " + std::string(valid ? "yes" : "NO") + "\n";
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
+
+void TestsRenderer::SceneQueryTest()
+{
+	wi::Timer timer;
+	wi::random::RNG rng(1);
+
+	const uint32_t ray_count = 10000;
+	const float extent = 1000;
+
+	std::string ss = "Scene query test, " + std::to_string(ray_count) + " rays and spheres, linear / object BVH:\n";
+
+	for (uint32_t object_count : { 1000u, 10000u, 100000u })
+	{
+		Scene scene;
+		Entity cube = scene.Entity_CreateCube("");
+		scene.objects.Remove(cube); // only the mesh is used, shared by all the objects
+		for (uint32_t i = 0; i < object_count; ++i)
+		{
+			Entity entity = scene.Entity_CreateObject("");
+			scene.objects.GetComponent(entity)->meshID = cube;
+			TransformComponent& transform = *scene.transforms.GetComponent(entity);
+			transform.Translate(XMFLOAT3(rng.next_float(-extent, extent), rng.next_float(-extent, extent), rng.next_float(-extent, extent)));
+			transform.UpdateTransform();
+		}
+		scene.Update(0);
+
+		wi::vector<wi::primitive::Ray> rays(ray_count);
+		wi::vector<wi::primitive::Sphere> spheres(ray_count);
+		for (uint32_t i = 0; i < ray_count; ++i)
+		{
+			const XMFLOAT3 origin = XMFLOAT3(rng.next_float(-extent, extent), rng.next_float(-extent, extent), rng.next_float(-extent, extent));
+			const XMVECTOR direction = XMVector3Normalize(XMVectorSet(rng.next_float(-1, 1), rng.next_float(-1, 1), rng.next_float(-1, 1), 0));
+			rays[i] = wi::primitive::Ray(XMLoadFloat3(&origin), direction);
+			spheres[i] = wi::primitive::Sphere(origin, 10);
+		}
+
+		double ray_time[2] = {};
+		double sphere_time[2] = {};
+		uint32_t hits[2] = {};
+		wi::BVH bvh = std::move(scene.object_bvh);
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			if (mode == 1)
+			{
+				scene.object_bvh = std::move(bvh); // mode 0 ran without BVH, which is the linear fallback
+			}
+
+			timer.record();
+			for (const wi::primitive::Ray& ray : rays)
+			{
+				hits[mode] += scene.Intersects(ray).entity != INVALID_ENTITY ? 1 : 0;
+			}
+			ray_time[mode] = timer.elapsed_milliseconds();
+
+			timer.record();
+			for (const wi::primitive::Sphere& sphere : spheres)
+			{
+				hits[mode] += scene.Intersects(sphere).entity != INVALID_ENTITY ? 1 : 0;
+			}
+			sphere_time[mode] = timer.elapsed_milliseconds();
+		}
+		assert(hits[0] == hits[1]);
+
+		wi::vector<Scene::RayIntersectionResult> batch_results(ray_count);
+		timer.record();
+		scene.IntersectsBatch(rays.data(), rays.size(), batch_results.data());
+		const double batch_time = timer.elapsed_milliseconds();
+
+		ss += "\n" + std::to_string(object_count) + " objects:\n";
+		ss += "ray: " + std::to_string(ray_time[0]) + " ms / " + std::to_string(ray_time[1]) + " ms\n";
+		ss += "sphere: " + std::to_string(sphere_time[0]) + " ms / " + std::to_string(sphere_time[1]) + " ms\n";
+		ss += "ray batch (object BVH, multithreaded): " + std::to_string(batch_time) + " ms\n";
+	}
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
+
+void TestsRenderer::BVHBuildTest()
+{
+	wi::Timer timer;
+	wi::random::RNG rng(1);
+
+	const uint32_t ray_count = 10000;
+	const wi::BVH::BuildMode modes[] = { wi::BVH::BuildMode::FAST, wi::BVH::BuildMode::SAH };
+	const char* mode_names[] = { "fast", "SAH" };
+
+	std::string ss = "BVH build test, fast (midpoint) / SAH:\n";
+	ss += "build time, SAH cost, leaf tests per ray (" + std::to_string(ray_count) + " random rays)\n";
+
+	for (const char* file : { "teapot.wiscene", "suzanne.wiscene", "hairparticle_torus.wiscene", "shadows_test.wiscene", "lightmap_bake_test.wiscene" })
+	{
+		Scene scene;
+		wi::scene::LoadModel2(scene, std::string(CONTENT_DIR "models/") + file);
+
+		uint32_t triangle_count = 0;
+		double build_time[2] = {};
+		float cost[2] = {};
+		uint64_t leaf_tests[2] = {};
+		for (size_t i = 0; i < scene.meshes.GetCount(); ++i)
+		{
+			MeshComponent& mesh = scene.meshes[i];
+			mesh.BuildBVH(wi::BVH::BuildMode::FAST); // fills the triangle bounds
+			const uint32_t leaf_count = (uint32_t)mesh.bvh_leaf_aabbs.size();
+			if (leaf_count == 0)
+				continue;
+			triangle_count += leaf_count;
+
+			const wi::primitive::AABB bounds = mesh.bvh.nodes[0].aabb;
+			wi::vector<wi::primitive::Ray> rays(ray_count);
+			for (auto& ray : rays)
+			{
+				const XMFLOAT3 origin = XMFLOAT3(
+					rng.next_float(bounds._min.x, bounds._max.x),
+					rng.next_float(bounds._min.y, bounds._max.y),
+					rng.next_float(bounds._min.z, bounds._max.z)
+				);
+				ray = wi::primitive::Ray(XMLoadFloat3(&origin), XMVector3Normalize(XMVectorSet(rng.next_float(-1, 1), rng.next_float(-1, 1), rng.next_float(-1, 1), 0)));
+			}
+
+			for (size_t mode = 0; mode < arraysize(modes); ++mode)
+			{
+				wi::BVH bvh;
+				timer.record();
+				bvh.Build(mesh.bvh_leaf_aabbs.data(), leaf_count, modes[mode]);
+				build_time[mode] += timer.elapsed_milliseconds();
+				cost[mode] += bvh.GetSAHCost();
+				for (auto& ray : rays)
+				{
+					bvh.Intersects(ray, 0, [&](uint32_t) {
+						leaf_tests[mode]++;
+					});
+				}
+			}
+		}
+
+		ss += "\n" + std::string(file) + " (" + std::to_string(triangle_count) + " triangles):\n";
+		for (size_t mode = 0; mode < arraysize(modes); ++mode)
+		{
+			ss += std::string(mode_names[mode]) + ": " + std::to_string(build_time[mode]) + " ms, cost: " + std::to_string(cost[mode]) + ", leaf tests: " + std::to_string(double(leaf_tests[mode]) / ray_count) + "\n";
+		}
+	}
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
+
+void TestsRenderer::CullingTest()
+{
+	wi::Timer timer;
+	wi::random::RNG rng(1);
+
+	CameraComponent camera;
+	camera.CreatePerspective(16.0f, 9.0f, 0.1f, 500.0f);
+	camera.Eye = XMFLOAT3(0, 10, -100);
+	camera.At = XMFLOAT3(0, 0, 1);
+	camera.UpdateCamera();
+
+	std::string ss = "Frustum culling test, AABB array (CheckBoxFast) / SoA stream (CheckBoxesFast) / BVH (CullFrusta):\n";
+	ss += "objects are random boxes around the camera, every 7th box is in a different layer\n";
+
+	for (uint32_t object_count : { 10000u, 100000u, 1000000u })
+	{
+		wi::vector<wi::primitive::AABB> aabbs(object_count);
+		wi::primitive::AABBStream stream;
+		stream.resize(object_count);
+		for (uint32_t i = 0; i < object_count; ++i)
+		{
+			const XMFLOAT3 center = XMFLOAT3(rng.next_float(-1000, 1000), rng.next_float(-100, 100), rng.next_float(-1000, 1000));
+			const float extent = rng.next_float(0.1f, 10);
+			wi::primitive::AABB aabb;
+			aabb.createFromHalfWidth(center, XMFLOAT3(extent, extent, extent));
+			aabb.layerMask = (i % 7) == 0 ? 2 : 1;
+			aabbs[i] = aabb;
+			stream.set(i, aabb);
+		}
+		const uint32_t layerMask = 1;
+		wi::vector<uint32_t> visible(object_count);
+
+		timer.record();
+		uint32_t aos_count = 0;
+		for (uint32_t i = 0; i < object_count; ++i)
+		{
+			if ((aabbs[i].layerMask & layerMask) && camera.frustum.CheckBoxFast(aabbs[i]))
+			{
+				visible[aos_count++] = i;
+			}
+		}
+		const double aos_time = timer.elapsed_milliseconds();
+
+		timer.record();
+		const uint32_t soa_count = camera.frustum.CheckBoxesFast(stream, layerMask, 0, object_count, visible.data());
+		const double soa_time = timer.elapsed_milliseconds();
+
+		wi::BVH bvh;
+		bvh.Build(aabbs.data(), object_count);
+		timer.record();
+		uint32_t bvh_count = 0;
+		bvh.CullFrusta(&camera.frustum, 1, aabbs.data(), [&](uint32_t index, uint16_t) {
+			if (aabbs[index].layerMask & layerMask)
+			{
+				visible[bvh_count++] = index;
+			}
+		});
+		const double bvh_time = timer.elapsed_milliseconds();
+
+		ss += "\n" + std::to_string(object_count) + " objects, visible: " + std::to_string(aos_count) + " / " + std::to_string(soa_count) + " / " + std::to_string(bvh_count) + "\n";
+		ss += "AABB array: " + std::to_string(aos_time) + " ms, SoA stream: " + std::to_string(soa_time) + " ms, BVH: " + std::to_string(bvh_time) + " ms\n";
+	}
+
+	static wi::SpriteFont font;
+	font = wi::SpriteFont(ss);
+	font.params.posX = GetLogicalWidth() / 2;
+	font.params.posY = GetLogicalHeight() / 2;
+	font.params.h_align = wi::font::WIFALIGN_CENTER;
+	font.params.v_align = wi::font::WIFALIGN_CENTER;
+	font.params.size = 20;
+	this->AddFont(&font);
+}
@@ -15,6 +15,12 @@ public:
 	void RunSpriteTest();
 	void RunNetworkTest();
 	void ContainerTest();
+	void ComponentManagerTest();
+	void ImportTest();
+	void SceneLookupTest();
+	void SceneQueryTest();
+	void BVHBuildTest();
+	void CullingTest();
 };
 
 class Tests : public wi::Application
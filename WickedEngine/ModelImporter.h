@@ -1,5 +1,30 @@
 #pragma once
+#include <atomic>
+#include <algorithm>
 
-wi::ecs::Entity ImportModel_OBJ(const std::string& fileName, wi::scene::Scene& scene);
-wi::ecs::Entity ImportModel_GLTF(const std::string& fileName, wi::scene::Scene& scene);
+// Optional progress tracking of a model import
+//	- counters are written by the importing thread and can be read from any thread
+//	- setting cancelled makes the importer stop at the next checkpoint and return INVALID_ENTITY
+struct ModelImportProgress
+{
+	std::atomic<uint64_t> bytesTotal{ 0 };
+	std::atomic<uint64_t> bytesParsed{ 0 };
+	std::atomic<uint32_t> meshesTotal{ 0 };
+	std::atomic<uint32_t> meshesCreated{ 0 };
+	std::atomic<uint32_t> texturesTotal{ 0 };
+	std::atomic<uint32_t> texturesCreated{ 0 };
+	std::atomic_bool cancelled{ false };
+
+	bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+	// Advance the parsed bytes, they never exceed bytesTotal (can be called by multiple threads)
+	void AddBytesParsed(uint64_t bytes)
+	{
+		const uint64_t total = bytesTotal.load(std::memory_order_relaxed);
+		uint64_t parsed = bytesParsed.load(std::memory_order_relaxed);
+		while (!bytesParsed.compare_exchange_weak(parsed, std::min(total, parsed + bytes), std::memory_order_relaxed));
+	}
+};
+
+wi::ecs::Entity ImportModel_OBJ(const std::string& fileName, wi::scene::Scene& scene, ModelImportProgress* progress = nullptr);
+wi::ecs::Entity ImportModel_GLTF(const std::string& fileName, wi::scene::Scene& scene, ModelImportProgress* progress = nullptr);
 void ExportModel_GLTF(const std::string& filename, wi::scene::Scene& scene);
@@ -18,6 +18,12 @@ using namespace wi::ecs;
 
 namespace tinygltf
 {
+	// Passed as the userdata of the image loader
+	struct ImageLoaderUserData
+	{
+		wi::resourcemanager::ResourceSerializer* seri = nullptr;
+		ModelImportProgress* progress = nullptr;
+	};
 
 	bool FileExists(const std::string& abs_filename, void*) {
 		return wi::helper::FileExists(abs_filename);
@@ -72,8 +78,16 @@ namespace tinygltf
 	}
 
 	bool ReadWholeFile(std::vector<unsigned char>* out, std::string* err,
-		const std::string& filepath, void*) {
-		return wi::helper::FileRead(filepath, *out);
+		const std::string& filepath, void* userdata) {
+		if (!wi::helper::FileRead(filepath, *out))
+			return false;
+		// external buffers and images are part of the import, their bytes are parsed when they are consumed:
+		ModelImportProgress* progress = (ModelImportProgress*)userdata;
+		if (progress != nullptr)
+		{
+			progress->bytesTotal.fetch_add(out->size(), std::memory_order_relaxed);
+		}
+		return true;
 	}
 
 	bool WriteWholeFile(std::string* err, const std::string& filepath,
@@ -87,6 +101,20 @@ namespace tinygltf
 	{
 		(void)warn;
 
+		ImageLoaderUserData* loaderdata = (ImageLoaderUserData*)userdata;
+		if (loaderdata->progress != nullptr)
+		{
+			loaderdata->progress->AddBytesParsed((uint64_t)size);
+		}
+		if (loaderdata->progress != nullptr && loaderdata->progress->IsCancelled())
+		{
+			if (err)
+			{
+				*err += "Import cancelled\n";
+			}
+			return false;
+		}
+
 		if (image->uri.empty())
 		{
 			// Force some image resource name:
@@ -110,8 +138,7 @@ namespace tinygltf
 			return false;
 		}
 
-		wi::resourcemanager::ResourceSerializer* seri = (wi::resourcemanager::ResourceSerializer*)userdata;
-		seri->resources.push_back(resource);
+		loaderdata->seri->resources.push_back(resource); // the texture is created later by the material that uses it
 
 		return true;
 	}
@@ -283,9 +310,9 @@ void FlipZAxis(LoaderState& state)
 	Scene& wiscene = *state.scene;
 
 	// Flip mesh data first
-	for (size_t i = 0; i < wiscene.meshes.GetCount(); ++i)
-	{
-		auto& mesh = wiscene.meshes[i];
+	wi::jobsystem::context ctx;
+	wi::jobsystem::Dispatch(ctx, (uint32_t)wiscene.meshes.GetCount(), 1, [&](wi::jobsystem::JobArgs args) {
+		auto& mesh = wiscene.meshes[args.jobIndex];
 		for (auto& v_pos : mesh.vertex_positions)
 		{
 			v_pos.z *= -1.f;
@@ -310,7 +337,8 @@ void FlipZAxis(LoaderState& state)
 			}
 		}
 		mesh.FlipCulling(); // calls CreateRenderData
-	}
+	});
+	wi::jobsystem::Wait(ctx);
 
 	// Flip scene's transformComponents
 	bool state_restore = (state.transforms_original.size() > 0);
@@ -439,7 +467,7 @@ void FlipZAxis(LoaderState& state)
 	}
 }
 
-Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
+Entity ImportModel_GLTF(const std::string& fileName, Scene& scene, ModelImportProgress* progress)
 {
 	std::string directory = wi::helper::GetDirectoryFromPath(fileName);
 	std::string name = wi::helper::GetFileNameFromPath(fileName);
@@ -454,20 +482,47 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 	callbacks.WriteWholeFile = tinygltf::WriteWholeFile;
 	callbacks.FileExists = tinygltf::FileExists;
 	callbacks.ExpandFilePath = tinygltf::ExpandFilePath;
+	callbacks.user_data = progress;
 	loader.SetFsCallbacks(callbacks);
 
 	wi::resourcemanager::ResourceSerializer seri; // keep this alive to not delete loaded images while importing gltf
-	loader.SetImageLoader(tinygltf::LoadImageData, &seri);
+	tinygltf::ImageLoaderUserData imageLoaderData;
+	imageLoaderData.seri = &seri;
+	imageLoaderData.progress = progress;
+	loader.SetImageLoader(tinygltf::LoadImageData, &imageLoaderData);
 	loader.SetImageWriter(tinygltf::WriteImageData, nullptr);
 
 	LoaderState state;
 	state.scene = &scene;
 
+	// Binary files are memory mapped and their buffers are accessed in place by the importer instead of being copied,
+	//	text files (and binary files which can't be mapped) are read into memory
+	wi::helper::MappedFile mappedfile;
 	wi::vector<uint8_t> filedata;
-	bool ret = wi::helper::FileRead(fileName, filedata);
+	const uint8_t* filebytes = nullptr;
+	size_t filesize = 0;
+	bool ret = false;
+	if (extension.compare("GLTF") && wi::helper::FileMap(fileName, mappedfile))
+	{
+		loader.SetBinaryChunkInPlace(true);
+		filebytes = mappedfile.data;
+		filesize = mappedfile.size;
+		ret = true;
+	}
+	else if (wi::helper::FileRead(fileName, filedata))
+	{
+		filebytes = filedata.data();
+		filesize = filedata.size();
+		ret = true;
+	}
 
 	if (ret)
 	{
+		if (progress != nullptr)
+		{
+			progress->bytesTotal.store(filesize, std::memory_order_relaxed);
+		}
+
 		std::string basedir = tinygltf::GetBaseDir(fileName);
 
 		if (!extension.compare("GLTF"))
@@ -476,8 +531,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				&state.gltfModel,
 				&err,
 				&warn,
-				reinterpret_cast<const char*>(filedata.data()),
-				static_cast<unsigned int>(filedata.size()),
+				reinterpret_cast<const char*>(filebytes),
+				static_cast<unsigned int>(filesize),
 				basedir
 			);
 		}
@@ -487,8 +542,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				&state.gltfModel,
 				&err,
 				&warn,
-				filedata.data(),
-				static_cast<unsigned int>(filedata.size()),
+				filebytes,
+				static_cast<unsigned int>(filesize),
 				basedir
 			);
 		}
@@ -498,6 +553,18 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 		err = "Failed to read file: " + fileName;
 	}
 
+	if (progress != nullptr)
+	{
+		if (progress->IsCancelled())
+		{
+			return INVALID_ENTITY;
+		}
+		if (ret)
+		{
+			progress->meshesTotal.store((uint32_t)state.gltfModel.meshes.size(), std::memory_order_relaxed);
+		}
+	}
+
 	if (!ret)
 	{
 		wi::helper::messageBox(err, "GLTF error!");
@@ -509,6 +576,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 	state.name = name;
 
 	// Create materials:
+	const size_t materialOffset = scene.materials.GetCount();
 	for (auto& x : state.gltfModel.materials)
 	{
 		Entity materialEntity = scene.Entity_CreateMaterial(x.name);
@@ -1007,27 +1075,80 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				material.textures[MaterialComponent::ANISOTROPYMAP].uvset = (uint32_t)param.Get("texCoord").Get<int>();
 			}
 		}
+	}
 
-		material.CreateRenderData();
+	// The textures of the materials are decoded concurrently (the images were only stored while parsing with IMPORT_DELAY):
+	//	images are shared by materials, a texture is counted as created by the first material that finishes creating it
+	wi::unordered_map<std::string, uint32_t> imageIndices;
+	for (uint32_t i = 0; i < (uint32_t)state.gltfModel.images.size(); ++i)
+	{
+		imageIndices[state.gltfModel.images[i].uri] = i;
+	}
+	std::unique_ptr<std::atomic_bool[]> imageCreated(new std::atomic_bool[state.gltfModel.images.size() + 1]());
+	if (progress != nullptr)
+	{
+		uint32_t texturesTotal = 0;
+		wi::vector<bool> imageUsed(state.gltfModel.images.size());
+		for (size_t i = materialOffset; i < scene.materials.GetCount(); ++i)
+		{
+			for (const MaterialComponent::TextureMap& textureslot : scene.materials[i].textures)
+			{
+				auto it = imageIndices.find(textureslot.name);
+				if (it != imageIndices.end() && !imageUsed[it->second])
+				{
+					imageUsed[it->second] = true;
+					texturesTotal++;
+				}
+			}
+		}
+		progress->texturesTotal.store(texturesTotal, std::memory_order_relaxed);
 	}
+	wi::jobsystem::context materialCtx;
+	wi::jobsystem::Dispatch(materialCtx, uint32_t(scene.materials.GetCount() - materialOffset), 1, [&](wi::jobsystem::JobArgs args) {
+		MaterialComponent& material = scene.materials[materialOffset + args.jobIndex];
+		material.CreateRenderData();
+		if (progress != nullptr)
+		{
+			for (const MaterialComponent::TextureMap& textureslot : material.textures)
+			{
+				auto it = imageIndices.find(textureslot.name);
+				if (it != imageIndices.end() && textureslot.resource.IsValid() && textureslot.resource.GetTexture().IsValid() && !imageCreated[it->second].exchange(true))
+				{
+					progress->texturesCreated.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+		});
+	wi::jobsystem::Wait(materialCtx);
 
 	// Create meshes:
-	for (auto& x : state.gltfModel.meshes)
+	//	the entities are created serially, then the vertex/index streams of each mesh are converted by separate jobs
+	wi::vector<Entity> meshEntities(state.gltfModel.meshes.size());
+	for (size_t i = 0; i < state.gltfModel.meshes.size(); ++i)
 	{
-		Entity meshEntity = scene.Entity_CreateMesh(x.name);
-		scene.Component_Attach(meshEntity, state.rootEntity);
-		MeshComponent& mesh = *scene.meshes.GetComponent(meshEntity);
+		meshEntities[i] = scene.Entity_CreateMesh(state.gltfModel.meshes[i].name);
+		scene.Component_Attach(meshEntities[i], state.rootEntity);
+		if (!state.gltfModel.meshes[i].primitives.empty() && scene.materials.GetCount() == 0)
+		{
+			// Create a material last minute if there was none
+			scene.materials.Create(CreateEntity());
+		}
+	}
+	wi::vector<wi::vector<Entity>> vertexColorMaterials(state.gltfModel.meshes.size()); // materials are shared by meshes, so they are modified after the jobs
+	wi::jobsystem::context meshCtx;
+	wi::jobsystem::Dispatch(meshCtx, (uint32_t)state.gltfModel.meshes.size(), 1, [&](wi::jobsystem::JobArgs args) {
+		if (progress != nullptr && progress->IsCancelled())
+		{
+			return;
+		}
+
+		auto& x = state.gltfModel.meshes[args.jobIndex];
+		MeshComponent& mesh = *scene.meshes.GetComponent(meshEntities[args.jobIndex]);
 
 		for (auto& prim : x.primitives)
 		{
 			mesh.subsets.push_back(MeshComponent::MeshSubset());
-			if (scene.materials.GetCount() == 0)
-			{
-				// Create a material last minute if there was none
-				scene.materials.Create(CreateEntity());
-			}
 			mesh.subsets.back().materialID = scene.materials.GetEntity(std::max(0, prim.material));
-			MaterialComponent* material = scene.materials.GetComponent(mesh.subsets.back().materialID);
 			uint32_t vertexOffset = (uint32_t)mesh.vertex_positions.size();
 
 			const size_t index_remap[] = {
@@ -1048,7 +1169,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				mesh.subsets.back().indexOffset = (uint32_t)indexOffset;
 				mesh.subsets.back().indexCount = (uint32_t)indexCount;
 
-				const uint8_t* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+				const uint8_t* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 				if (stride == 1)
 				{
@@ -1111,7 +1232,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 					mesh.subsets.back().indexCount = (uint32_t)vertexCount;
 				}
 
-				const uint8_t* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+				const uint8_t* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 				if (!attr_name.compare("POSITION"))
 				{
@@ -1128,8 +1249,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 						const tinygltf::BufferView& sparse_values_view = state.gltfModel.bufferViews[sparse.values.bufferView];
 						const tinygltf::Buffer& sparse_indices_buffer = state.gltfModel.buffers[sparse_indices_view.buffer];
 						const tinygltf::Buffer& sparse_values_buffer = state.gltfModel.buffers[sparse_values_view.buffer];
-						const uint8_t* sparse_indices_data = sparse_indices_buffer.data.data() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
-						const uint8_t* sparse_values_data = sparse_values_buffer.data.data() + sparse.values.byteOffset + sparse_values_view.byteOffset;
+						const uint8_t* sparse_indices_data = sparse_indices_buffer.GetData() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
+						const uint8_t* sparse_values_data = sparse_values_buffer.GetData() + sparse.values.byteOffset + sparse_values_view.byteOffset;
 						switch (sparse.indices.componentType)
 						{
 						default:
@@ -1169,8 +1290,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 						const tinygltf::BufferView& sparse_values_view = state.gltfModel.bufferViews[sparse.values.bufferView];
 						const tinygltf::Buffer& sparse_indices_buffer = state.gltfModel.buffers[sparse_indices_view.buffer];
 						const tinygltf::Buffer& sparse_values_buffer = state.gltfModel.buffers[sparse_values_view.buffer];
-						const uint8_t* sparse_indices_data = sparse_indices_buffer.data.data() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
-						const uint8_t* sparse_values_data = sparse_values_buffer.data.data() + sparse.values.byteOffset + sparse_values_view.byteOffset;
+						const uint8_t* sparse_indices_data = sparse_indices_buffer.GetData() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
+						const uint8_t* sparse_values_data = sparse_values_buffer.GetData() + sparse.values.byteOffset + sparse_values_view.byteOffset;
 						switch (sparse.indices.componentType)
 						{
 						default:
@@ -1377,10 +1498,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				}
 				else if (!attr_name.compare("COLOR_0"))
 				{
-					if (material != nullptr)
-					{
-						material->SetUseVertexColors(true);
-					}
+					vertexColorMaterials[args.jobIndex].push_back(mesh.subsets.back().materialID);
 					mesh.vertex_colors.resize(vertexOffset + vertexCount);
 					if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
 					{
@@ -1486,8 +1604,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 							const tinygltf::BufferView& sparse_values_view = state.gltfModel.bufferViews[sparse.values.bufferView];
 							const tinygltf::Buffer& sparse_indices_buffer = state.gltfModel.buffers[sparse_indices_view.buffer];
 							const tinygltf::Buffer& sparse_values_buffer = state.gltfModel.buffers[sparse_values_view.buffer];
-							const uint8_t* sparse_indices_data = sparse_indices_buffer.data.data() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
-							const uint8_t* sparse_values_data = sparse_values_buffer.data.data() + sparse.values.byteOffset + sparse_values_view.byteOffset;
+							const uint8_t* sparse_indices_data = sparse_indices_buffer.GetData() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
+							const uint8_t* sparse_values_data = sparse_values_buffer.GetData() + sparse.values.byteOffset + sparse_values_view.byteOffset;
 							morph_target.vertex_positions.resize(sparse.count);
 							morph_target.sparse_indices_positions.resize(sparse.count);
 
@@ -1525,7 +1643,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 							int stride = accessor.ByteStride(bufferView);
 							size_t vertexCount = accessor.count;
 
-							const unsigned char* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+							const unsigned char* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 							morph_target.vertex_positions.resize(vertexOffset + vertexCount);
 							for (size_t j = 0; j < vertexCount; ++j)
@@ -1543,8 +1661,8 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 							const tinygltf::BufferView& sparse_values_view = state.gltfModel.bufferViews[sparse.values.bufferView];
 							const tinygltf::Buffer& sparse_indices_buffer = state.gltfModel.buffers[sparse_indices_view.buffer];
 							const tinygltf::Buffer& sparse_values_buffer = state.gltfModel.buffers[sparse_values_view.buffer];
-							const uint8_t* sparse_indices_data = sparse_indices_buffer.data.data() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
-							const uint8_t* sparse_values_data = sparse_values_buffer.data.data() + sparse.values.byteOffset + sparse_values_view.byteOffset;
+							const uint8_t* sparse_indices_data = sparse_indices_buffer.GetData() + sparse.indices.byteOffset + sparse_indices_view.byteOffset;
+							const uint8_t* sparse_values_data = sparse_values_buffer.GetData() + sparse.values.byteOffset + sparse_values_view.byteOffset;
 							morph_target.vertex_normals.resize(sparse.count);
 							morph_target.sparse_indices_normals.resize(sparse.count);
 
@@ -1582,7 +1700,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 							int stride = accessor.ByteStride(bufferView);
 							size_t vertexCount = accessor.count;
 
-							const unsigned char* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+							const unsigned char* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 							morph_target.vertex_normals.resize(vertexOffset + vertexCount);
 							for (size_t j = 0; j < vertexCount; ++j)
@@ -1607,6 +1725,51 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 		}
 
 		mesh.CreateRenderData(); // tangents are generated inside if needed, which must be done before FlipZAxis!
+
+		if (progress != nullptr)
+		{
+			// the buffer data that the primitives consumed:
+			uint64_t bytes = 0;
+			auto accessor_bytes = [&](int accessorIndex) {
+				if (accessorIndex < 0 || accessorIndex >= (int)state.gltfModel.accessors.size())
+					return;
+				const tinygltf::Accessor& accessor = state.gltfModel.accessors[accessorIndex];
+				const int32_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+				const int32_t componentCount = tinygltf::GetNumComponentsInType(accessor.type);
+				if (componentSize > 0 && componentCount > 0)
+				{
+					bytes += (uint64_t)accessor.count * componentSize * componentCount;
+				}
+			};
+			for (auto& prim : x.primitives)
+			{
+				accessor_bytes(prim.indices);
+				for (auto& attribute : prim.attributes)
+				{
+					accessor_bytes(attribute.second);
+				}
+			}
+			progress->AddBytesParsed(bytes);
+			progress->meshesCreated.fetch_add(1, std::memory_order_relaxed);
+		}
+		});
+	wi::jobsystem::Wait(meshCtx);
+
+	if (progress != nullptr && progress->IsCancelled())
+	{
+		return INVALID_ENTITY;
+	}
+
+	for (auto& materialEntities : vertexColorMaterials)
+	{
+		for (Entity materialEntity : materialEntities)
+		{
+			MaterialComponent* material = scene.materials.GetComponent(materialEntity);
+			if (material != nullptr)
+			{
+				material->SetUseVertexColors(true);
+			}
+		}
 	}
 
 	// Create armatures:
@@ -1625,7 +1788,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 			const tinygltf::BufferView& bufferView = state.gltfModel.bufferViews[accessor.bufferView];
 			const tinygltf::Buffer& buffer = state.gltfModel.buffers[bufferView.buffer];
 			armature.inverseBindMatrices.resize(accessor.count);
-			memcpy(armature.inverseBindMatrices.data(), &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(XMFLOAT4X4));
+			memcpy(armature.inverseBindMatrices.data(), buffer.GetData() + accessor.byteOffset + bufferView.byteOffset, accessor.count * sizeof(XMFLOAT4X4));
 		}
 		else
 		{
@@ -1707,7 +1870,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 
 				animationdata.keyframe_times.resize(count);
 
-				const unsigned char* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+				const unsigned char* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 				assert(stride == 4);
 
@@ -1730,7 +1893,7 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 				int stride = accessor.ByteStride(bufferView);
 				size_t count = accessor.count;
 
-				const unsigned char* data = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+				const unsigned char* data = buffer.GetData() + accessor.byteOffset + bufferView.byteOffset;
 
 				switch (accessor.type)
 				{
@@ -2019,6 +2182,12 @@ Entity ImportModel_GLTF(const std::string& fileName, Scene& scene)
 	//	For example, snap to camera functionality relies on this
 	scene.Update(0);
 
+	if (progress != nullptr)
+	{
+		// the rest of the buffers (animations, skins, etc.) were consumed too:
+		progress->bytesParsed.store(progress->bytesTotal.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
 	return state.rootEntity;
 }
 
@@ -68,7 +68,7 @@ private:
 // Transform the data from OBJ space to engine-space:
 static const bool transform_to_LH = true;
 
-Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
+Entity ImportModel_OBJ(const std::string& fileName, Scene& scene, ModelImportProgress* progress)
 {
 	std::string directory = wi::helper::GetDirectoryFromPath(fileName);
 	std::string name = wi::helper::GetFileNameFromPath(fileName);
@@ -83,6 +83,10 @@ Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
 
 	if (success)
 	{
+		if (progress != nullptr)
+		{
+			progress->bytesTotal.store(filedata.size(), std::memory_order_relaxed);
+		}
 		membuf sbuf((char*)filedata.data(), (char*)filedata.data() + filedata.size());
 		std::istream in(&sbuf);
 		MaterialFileReader matFileReader(directory);
@@ -98,6 +102,28 @@ Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
 		wi::backlog::post(obj_errors, wi::backlog::LogLevel::Error);
 	}
 
+	if (progress != nullptr)
+	{
+		if (progress->IsCancelled())
+		{
+			return INVALID_ENTITY;
+		}
+		if (success)
+		{
+			uint32_t textureCount = 0;
+			for (auto& obj_material : obj_materials)
+			{
+				textureCount += !obj_material.diffuse_texname.empty();
+				textureCount += !obj_material.displacement_texname.empty();
+				textureCount += !obj_material.normal_texname.empty() || !obj_material.bump_texname.empty();
+				textureCount += !obj_material.specular_texname.empty() || !obj_material.specular_highlight_texname.empty();
+			}
+			progress->bytesParsed.store(filedata.size(), std::memory_order_relaxed);
+			progress->meshesTotal.store((uint32_t)obj_shapes.size(), std::memory_order_relaxed);
+			progress->texturesTotal.store(textureCount, std::memory_order_relaxed);
+		}
+	}
+
 	Entity rootEntity = INVALID_ENTITY;
 	if (success)
 	{
@@ -145,6 +171,16 @@ Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
 
 			material.CreateRenderData();
 
+			if (progress != nullptr)
+			{
+				uint32_t textureCount = 0;
+				for (auto& x : material.textures)
+				{
+					textureCount += !x.name.empty();
+				}
+				progress->texturesCreated.fetch_add(textureCount, std::memory_order_relaxed);
+			}
+
 			materialLibrary.push_back(materialEntity); // for subset-indexing...
 		}
 
@@ -160,6 +196,11 @@ Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
 		// Load objects, meshes:
 		for (auto& shape : obj_shapes)
 		{
+			if (progress != nullptr && progress->IsCancelled())
+			{
+				return INVALID_ENTITY;
+			}
+
 			Entity objectEntity = scene.Entity_CreateObject(shape.name);
 			scene.Component_Attach(objectEntity, rootEntity);
 			Entity meshEntity = scene.Entity_CreateMesh(shape.name + "_mesh");
@@ -249,6 +290,11 @@ Entity ImportModel_OBJ(const std::string& fileName, Scene& scene)
 				}
 			}
 			mesh.CreateRenderData();
+
+			if (progress != nullptr)
+			{
+				progress->meshesCreated.fetch_add(1, std::memory_order_relaxed);
+			}
 		}
 
 	}
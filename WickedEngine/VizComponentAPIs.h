@@ -1,5 +1,9 @@
 #pragma once
+#ifdef _WIN32
 #define API_EXPORT __declspec(dllexport)
+#else
+#define API_EXPORT __attribute__((visibility("default")))
+#endif
 
 #define __FP (float*)&
 #define VZRESULT int
@@ -20,10 +24,16 @@
 #include <algorithm>
 #include <chrono>
 #include <functional>
+#include <typeinfo>
+#include <type_traits>
+#include <cstring>
 
 using VID = uint32_t;
 inline constexpr VID INVALID_VID = 0;
 using TimeStamp = std::chrono::high_resolution_clock::time_point;
+using RenderTicket = uint64_t;
+inline constexpr RenderTicket INVALID_TICKET = 0;
+using LoadTicket = uint64_t;
 
 constexpr float VZ_PI = 3.141592654f;
 constexpr float VZ_2PI = 6.283185307f;
@@ -101,9 +111,189 @@ namespace vzm
 		}
 
 		typedef std::unordered_map<ID, std::any> MapType;
-		typename typedef MapType::iterator iterator;
-		typename typedef MapType::const_iterator const_iterator;
-		typename typedef MapType::reference reference;
+		typedef typename MapType::iterator iterator;
+		typedef typename MapType::const_iterator const_iterator;
+		typedef typename MapType::reference reference;
+		iterator begin() { return __params.begin(); }
+		const_iterator begin() const { return __params.begin(); }
+		iterator end() { return __params.end(); }
+		const_iterator end() const { return __params.end(); }
+	};
+
+	// Interned attribute key, the name is hashed once and attributes are then found by comparing integers
+	using AttributeKey = uint32_t;
+	inline constexpr AttributeKey INVALID_ATTRIBUTE_KEY = ~0u;
+	// Get the key of an attribute name (the key is created for a new name)
+	extern "C" API_EXPORT AttributeKey InternAttributeKey(const std::string& name);
+	// Get the key of an attribute name without creating it
+	//  - return INVALID_ATTRIBUTE_KEY if the name was never interned (so no attribute can have it)
+	extern "C" API_EXPORT AttributeKey FindAttributeKey(const std::string& name);
+	// Get the name of an interned key (nullptr in case of failure)
+	extern "C" API_EXPORT const char* GetAttributeKeyName(const AttributeKey key);
+
+	// Attribute value with inline storage for small trivially copyable values, other values are kept in a std::any
+	class AttributeValue
+	{
+	public:
+		static constexpr size_t INLINE_SIZE = 16;
+		template <typename T> static constexpr bool IsInline() {
+			return std::is_trivially_copyable_v<T> && sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(uint64_t);
+		}
+
+		void Set(const std::any& value) {
+			__dataType = 0;
+			__any = value;
+		}
+		template <typename T> void Set(const T& value) {
+			if constexpr (IsInline<T>()) {
+				memcpy(__data, &value, sizeof(T));
+				__dataType = typeid(T).hash_code();
+				__any.reset();
+			}
+			else {
+				__dataType = 0;
+				__any = value;
+			}
+		}
+		// return nullptr if the value is not a T
+		template <typename T> T* Get() {
+			if constexpr (IsInline<T>()) {
+				if (__dataType == typeid(T).hash_code()) return (T*)__data;
+			}
+			return std::any_cast<T>(&__any);
+		}
+		template <typename T> const T* Get() const {
+			return const_cast<AttributeValue*>(this)->Get<T>();
+		}
+	private:
+		alignas(uint64_t) uint8_t __data[INLINE_SIZE] = {};
+		size_t __dataType = 0; // type of the inline value, 0 when the value is in __any
+		std::any __any;
+	};
+
+	// Attributes keyed by names: the same interface as ParamMap, stored as a small contiguous array of (interned key, value) entries
+	//  - an empty map allocates nothing, and the entries are searched without hashing or comparing strings
+	//  - the name overloads look up the interned key on every call, callers of frequently accessed attributes should keep
+	//     the key of InternAttributeKey() and use the AttributeKey overloads
+	//  - a value read as a different type than it was set returns the default (GetParam) or fails (GetParamCheck, GetParamPtr)
+	template <> struct ParamMap<std::string> {
+	public:
+		struct Entry {
+			AttributeKey key;
+			AttributeValue value;
+			const char* GetName() const { return GetAttributeKeyName(key); }
+		};
+	private:
+		std::vector<Entry> __params;
+		Entry* find(const AttributeKey key) {
+			for (Entry& entry : __params) {
+				if (entry.key == key) return &entry;
+			}
+			return nullptr;
+		}
+		const Entry* find(const AttributeKey key) const {
+			return const_cast<ParamMap*>(this)->find(key);
+		}
+		const Entry* find(const std::string& key) const {
+			if (__params.empty()) return nullptr;
+			const AttributeKey attribute_key = FindAttributeKey(key);
+			return attribute_key == INVALID_ATTRIBUTE_KEY ? nullptr : find(attribute_key);
+		}
+		Entry& findOrAdd(const AttributeKey key) {
+			Entry* entry = find(key);
+			if (entry != nullptr) return *entry;
+			__params.push_back({ key, {} });
+			return __params.back();
+		}
+		template <typename K, typename SRCV> SRCV* getPtr(const K& key) {
+			const Entry* entry = find(key);
+			return entry == nullptr ? nullptr : const_cast<SRCV*>(entry->value.template Get<SRCV>());
+		}
+	public:
+		bool FindParam(const std::string& param_name) const { return find(param_name) != nullptr; }
+		bool FindParam(const AttributeKey param_key) const { return find(param_key) != nullptr; }
+		template <typename SRCV> bool GetParamCheck(const std::string& key, SRCV& param) {
+			SRCV* value = getPtr<std::string, SRCV>(key);
+			if (value == nullptr) return false;
+			param = *value;
+			return true;
+		}
+		template <typename SRCV> bool GetParamCheck(const AttributeKey key, SRCV& param) {
+			SRCV* value = getPtr<AttributeKey, SRCV>(key);
+			if (value == nullptr) return false;
+			param = *value;
+			return true;
+		}
+		template <typename SRCV> SRCV GetParam(const std::string& key, const SRCV& init_v) const {
+			const SRCV* value = const_cast<ParamMap*>(this)->getPtr<std::string, SRCV>(key);
+			return value == nullptr ? init_v : *value;
+		}
+		template <typename SRCV> SRCV GetParam(const AttributeKey key, const SRCV& init_v) const {
+			const SRCV* value = const_cast<ParamMap*>(this)->getPtr<AttributeKey, SRCV>(key);
+			return value == nullptr ? init_v : *value;
+		}
+		template <typename SRCV> SRCV* GetParamPtr(const std::string& key) { return getPtr<std::string, SRCV>(key); }
+		template <typename SRCV> SRCV* GetParamPtr(const AttributeKey key) { return getPtr<AttributeKey, SRCV>(key); }
+		template <typename SRCV, typename DSTV> bool GetParamCastingCheck(const std::string& key, DSTV& param) {
+			SRCV* value = getPtr<std::string, SRCV>(key);
+			if (value == nullptr) return false;
+			param = (DSTV)*value;
+			return true;
+		}
+		template <typename SRCV, typename DSTV> bool GetParamCastingCheck(const AttributeKey key, DSTV& param) {
+			SRCV* value = getPtr<AttributeKey, SRCV>(key);
+			if (value == nullptr) return false;
+			param = (DSTV)*value;
+			return true;
+		}
+		template <typename SRCV, typename DSTV> DSTV GetParamCasting(const std::string& key, const DSTV& init_v) {
+			SRCV* value = getPtr<std::string, SRCV>(key);
+			return value == nullptr ? init_v : (DSTV)*value;
+		}
+		template <typename SRCV, typename DSTV> DSTV GetParamCasting(const AttributeKey key, const DSTV& init_v) {
+			SRCV* value = getPtr<AttributeKey, SRCV>(key);
+			return value == nullptr ? init_v : (DSTV)*value;
+		}
+		void SetParam(const std::string& key, const std::any& param) {
+			const AttributeKey attribute_key = InternAttributeKey(key);
+			if (attribute_key != INVALID_ATTRIBUTE_KEY) findOrAdd(attribute_key).value.Set(param);
+		}
+		void SetParam(const AttributeKey key, const std::any& param) { findOrAdd(key).value.Set(param); }
+		template <typename SRCV> void SetParam(const std::string& key, const SRCV& param) {
+			const std::decay_t<const SRCV> value = param; // e.g., string literals are stored as const char*
+			const AttributeKey attribute_key = InternAttributeKey(key);
+			if (attribute_key != INVALID_ATTRIBUTE_KEY) findOrAdd(attribute_key).value.Set(value);
+		}
+		template <typename SRCV> void SetParam(const AttributeKey key, const SRCV& param) {
+			const std::decay_t<const SRCV> value = param;
+			findOrAdd(key).value.Set(value);
+		}
+		void RemoveParam(const std::string& key) {
+			const Entry* entry = find(key);
+			if (entry != nullptr) {
+				__params.erase(__params.begin() + (entry - __params.data()));
+			}
+		}
+		void RemoveParam(const AttributeKey key) {
+			const Entry* entry = find(key);
+			if (entry != nullptr) {
+				__params.erase(__params.begin() + (entry - __params.data()));
+			}
+		}
+		void RemoveAll() {
+			__params.clear();
+		}
+		size_t Size() const {
+			return __params.size();
+		}
+		std::string GetPMapVersion() const {
+			return "LIBI_1.4";
+		}
+
+		using MapType = std::vector<Entry>;
+		using iterator = MapType::iterator;
+		using const_iterator = MapType::const_iterator;
+		using reference = MapType::reference;
 		iterator begin() { return __params.begin(); }
 		const_iterator begin() const { return __params.begin(); }
 		iterator end() { return __params.end(); }
@@ -117,6 +307,39 @@ namespace vzm
 		PARTICLE_RENDER,
 	};
 
+	enum class LOAD_STATE
+	{
+		INVALID = 0,	// unknown ticket (or already released)
+		QUEUED,
+		LOADING,
+		FINISHED,		// the scene is registered (sceneVid/rootVid are valid)
+		FAILED,
+		CANCELLED,
+	};
+
+	struct LoadProgress
+	{
+		LOAD_STATE state = LOAD_STATE::INVALID;
+		uint64_t bytesTotal = 0;
+		uint64_t bytesParsed = 0;
+		uint32_t meshesTotal = 0;
+		uint32_t meshesCreated = 0;
+		uint32_t texturesTotal = 0;
+		uint32_t texturesCreated = 0;
+		float elapsedMS = 0;
+		VID sceneVid = INVALID_VID;
+		VID rootVid = INVALID_VID;
+	};
+
+	struct PickResult
+	{
+		VID vid = INVALID_VID;	// INVALID_VID when the pixel hits nothing
+		float position[3] = {};
+		float normal[3] = {};
+		float distance = 0;
+		int subsetIndex = -1;
+	};
+
 	enum class COMPONENT_TYPE
 	{
 		UNDEFINED = 0,
@@ -183,7 +406,7 @@ namespace vzm
 			Performance,
 			Ultra_Performance,
 		};
-		enum class SURFEL_DEBUG
+		enum class SURFEL_DEBUG : uint32_t
 		{
 			SURFEL_DEBUG_NONE,
 			SURFEL_DEBUG_NORMAL,
@@ -382,6 +605,9 @@ namespace vzm
 		float GetDDGIBlendSpeed();
 		void SetGIBoost(float value);
 		float GetGIBoost();
+		// number of command lists that the opaque passes are recorded into in parallel (1 = single command list)
+		void SetDrawSceneChunkCount(uint32_t value);
+		uint32_t GetDrawSceneChunkCount();
 	};
 	struct API_EXPORT VmCamera : VmBaseComponent, VmRenderer
 	{
@@ -5,7 +5,8 @@
 #include "wiGraphicsDevice_DX12.h"
 #include "wiGraphicsDevice_Vulkan.h"
 
-#include "../Editor/ModelImporter.h"
+#include "ModelImporter.h"
+#include "wiAllocator.h"
 
 #include <iostream>
 
@@ -36,55 +37,42 @@ static wi::unordered_map<std::string, FileType> filetypes = {
 	{"VRM", FileType::VRM},
 };
 
-static wi::unordered_map<std::string, vzm::COMPONENT_TYPE> vmcomptypes = {
-	{typeid(vzm::VmBaseComponent).name(), vzm::COMPONENT_TYPE::BASE},
-	{typeid(vzm::VmAnimation).name(), vzm::COMPONENT_TYPE::ANIMATION},
-	{typeid(vzm::VmActor).name(), vzm::COMPONENT_TYPE::ACTOR},
-	{typeid(vzm::VmMesh).name(), vzm::COMPONENT_TYPE::GEOMETRY},
-	{typeid(vzm::VmMaterial).name(), vzm::COMPONENT_TYPE::MATERIAL},
-	{typeid(vzm::VmLight).name(), vzm::COMPONENT_TYPE::LIGHT},
-	{typeid(vzm::VmEmitter).name(), vzm::COMPONENT_TYPE::EMITTER},
-	{typeid(vzm::VmWeather).name(), vzm::COMPONENT_TYPE::WEATHER},
-	{typeid(vzm::VmCamera).name(), vzm::COMPONENT_TYPE::CAMERA},
-	{typeid(vzm::VmCollider).name(), vzm::COMPONENT_TYPE::COLLIDER},
-};
-
-enum class CompType
+// The component types are dispatched at compile time (no typeid strings and hash lookups per call)
+template <typename VMCOMP>
+constexpr vzm::COMPONENT_TYPE GetVmCompType()
 {
-	INVALID,
-	NameComponent_,
-	LayerComponent_,
-	TransformComponent_,
-	HierarchyComponent_,
-	MaterialComponent_,
-	MeshComponent_,
-	ImpostorComponent_,
-	ObjectComponent_,
-	LightComponent_,
-	CameraComponent_,
-	EnvironmentProbeComponent_,
-	AnimationComponent_,
-	EmittedParticleSystem_,
-	ColliderComponent_,
-	WeatherComponent_,
-};
+	if constexpr (std::is_same_v<VMCOMP, vzm::VmBaseComponent>) return vzm::COMPONENT_TYPE::BASE;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmAnimation>) return vzm::COMPONENT_TYPE::ANIMATION;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmActor>) return vzm::COMPONENT_TYPE::ACTOR;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmMesh>) return vzm::COMPONENT_TYPE::GEOMETRY;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmMaterial>) return vzm::COMPONENT_TYPE::MATERIAL;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmLight>) return vzm::COMPONENT_TYPE::LIGHT;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmEmitter>) return vzm::COMPONENT_TYPE::EMITTER;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmWeather>) return vzm::COMPONENT_TYPE::WEATHER;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmCamera>) return vzm::COMPONENT_TYPE::CAMERA;
+	else if constexpr (std::is_same_v<VMCOMP, vzm::VmCollider>) return vzm::COMPONENT_TYPE::COLLIDER;
+	else return vzm::COMPONENT_TYPE::UNDEFINED;
+}
 
-static wi::unordered_map<std::string, CompType> comptypes = {
-	{typeid(wi::scene::NameComponent).name(), CompType::NameComponent_},
-	{typeid(wi::scene::LayerComponent).name(), CompType::LayerComponent_},
-	{typeid(wi::scene::TransformComponent).name(), CompType::TransformComponent_},
-	{typeid(wi::scene::HierarchyComponent).name(), CompType::HierarchyComponent_},
-	{typeid(wi::scene::MaterialComponent).name(), CompType::MaterialComponent_},
-	{typeid(wi::scene::MeshComponent).name(), CompType::MeshComponent_},
-	{typeid(wi::scene::ObjectComponent).name(), CompType::ObjectComponent_},
-	{typeid(wi::scene::LightComponent).name(), CompType::LightComponent_},
-	{typeid(wi::scene::CameraComponent).name(), CompType::CameraComponent_},
-	{typeid(wi::scene::EnvironmentProbeComponent).name(), CompType::EnvironmentProbeComponent_},
-	{typeid(wi::scene::AnimationComponent).name(), CompType::AnimationComponent_},
-	{typeid(wi::scene::ColliderComponent).name(), CompType::ColliderComponent_},
-	{typeid(wi::scene::WeatherComponent).name(), CompType::WeatherComponent_},
-	{typeid(wi::EmittedParticleSystem).name(), CompType::EmittedParticleSystem_},
-};
+template <typename COMP>
+inline wi::ecs::ComponentManager<COMP>& GetComponentManager(wi::scene::Scene& scene)
+{
+	if constexpr (std::is_same_v<COMP, wi::scene::NameComponent>) return scene.names;
+	else if constexpr (std::is_same_v<COMP, wi::scene::LayerComponent>) return scene.layers;
+	else if constexpr (std::is_same_v<COMP, wi::scene::TransformComponent>) return scene.transforms;
+	else if constexpr (std::is_same_v<COMP, wi::scene::HierarchyComponent>) return scene.hierarchy;
+	else if constexpr (std::is_same_v<COMP, wi::scene::MaterialComponent>) return scene.materials;
+	else if constexpr (std::is_same_v<COMP, wi::scene::MeshComponent>) return scene.meshes;
+	else if constexpr (std::is_same_v<COMP, wi::scene::ObjectComponent>) return scene.objects;
+	else if constexpr (std::is_same_v<COMP, wi::scene::LightComponent>) return scene.lights;
+	else if constexpr (std::is_same_v<COMP, wi::scene::CameraComponent>) return scene.cameras;
+	else if constexpr (std::is_same_v<COMP, wi::scene::EnvironmentProbeComponent>) return scene.probes;
+	else if constexpr (std::is_same_v<COMP, wi::scene::AnimationComponent>) return scene.animations;
+	else if constexpr (std::is_same_v<COMP, wi::scene::ColliderComponent>) return scene.colliders;
+	else if constexpr (std::is_same_v<COMP, wi::scene::WeatherComponent>) return scene.weathers;
+	else if constexpr (std::is_same_v<COMP, wi::EmittedParticleSystem>) return scene.emitters;
+	else static_assert(sizeof(COMP) == 0, "Not allowed GetComponent");
+}
 #pragma endregion
 
 static bool g_is_display = true;
@@ -100,6 +88,81 @@ auto fail_ret = [](const std::string& err_str, const bool _warn = false)
 namespace vzm
 {
 	std::atomic_bool profileFrameFinished = { true };
+	// no host GUI (window or shared render target), render results are read back with RenderToMemory()
+	bool headlessMode = false;
+
+	// interned attribute keys, an append-only open addressing table: a name is published once (release store) and never removed,
+	//	so FindAttributeKey() and GetAttributeKeyName() read the table without locking, only interning a new name is locked
+	static constexpr uint32_t MAX_ATTRIBUTE_KEYS = 4096;
+	static constexpr uint32_t ATTRIBUTE_KEY_SLOTS = MAX_ATTRIBUTE_KEYS * 2; // power of two, at most half full
+	struct AttributeKeyEntry
+	{
+		std::string name;
+		AttributeKey key = INVALID_ATTRIBUTE_KEY;
+	};
+	static std::mutex attributeKeyLock;
+	static std::deque<AttributeKeyEntry> attributeKeyEntries; // only accessed under the lock, the elements never move
+	static std::atomic<const AttributeKeyEntry*> attributeKeySlots[ATTRIBUTE_KEY_SLOTS] = {};
+	static std::atomic<const AttributeKeyEntry*> attributeKeyNames[MAX_ATTRIBUTE_KEYS] = {};
+
+	// Returns the entry of the name, or nullptr and the empty slot where the name would be inserted
+	static const AttributeKeyEntry* findAttributeKeyEntry(const std::string& name, uint32_t& slot)
+	{
+		slot = uint32_t(wi::helper::string_hash(name.c_str())) & (ATTRIBUTE_KEY_SLOTS - 1);
+		while (true)
+		{
+			const AttributeKeyEntry* entry = attributeKeySlots[slot].load(std::memory_order_acquire);
+			if (entry == nullptr || entry->name == name)
+			{
+				return entry;
+			}
+			slot = (slot + 1) & (ATTRIBUTE_KEY_SLOTS - 1);
+		}
+	}
+
+	AttributeKey InternAttributeKey(const std::string& name)
+	{
+		uint32_t slot = 0;
+		const AttributeKeyEntry* entry = findAttributeKeyEntry(name, slot);
+		if (entry != nullptr)
+		{
+			return entry->key;
+		}
+
+		std::scoped_lock lock(attributeKeyLock);
+		entry = findAttributeKeyEntry(name, slot); // another thread might have interned it meanwhile
+		if (entry != nullptr)
+		{
+			return entry->key;
+		}
+		if (attributeKeyEntries.size() >= MAX_ATTRIBUTE_KEYS)
+		{
+			wi::backlog::post("[vzm::InternAttributeKey] too many attribute names, " + name + " is not interned", wi::backlog::LogLevel::Error);
+			return INVALID_ATTRIBUTE_KEY;
+		}
+		AttributeKeyEntry& added = attributeKeyEntries.emplace_back();
+		added.name = name;
+		added.key = (AttributeKey)(attributeKeyEntries.size() - 1);
+		// published to the key table first, so a key found by its name always resolves to the name
+		attributeKeyNames[added.key].store(&added, std::memory_order_release);
+		attributeKeySlots[slot].store(&added, std::memory_order_release);
+		return added.key;
+	}
+	AttributeKey FindAttributeKey(const std::string& name)
+	{
+		uint32_t slot = 0;
+		const AttributeKeyEntry* entry = findAttributeKeyEntry(name, slot);
+		return entry == nullptr ? INVALID_ATTRIBUTE_KEY : entry->key;
+	}
+	const char* GetAttributeKeyName(const AttributeKey key)
+	{
+		if (key >= MAX_ATTRIBUTE_KEYS)
+		{
+			return nullptr;
+		}
+		const AttributeKeyEntry* entry = attributeKeyNames[key].load(std::memory_order_acquire);
+		return entry == nullptr ? nullptr : entry->name.c_str();
+	}
 
 	void TransformPoint(const float posSrc[3], const float mat[16], const bool rowMajor, float posDst[3])
 	{
@@ -173,8 +236,13 @@ namespace vzm
 			swapChain = {};
 			renderResult = {};
 			renderInterResult = {};
+			for (uint32_t i = 0; i < RENDERRESULT_COUNT; ++i)
+			{
+				renderResults[i] = {};
+				renderResultTickets[i] = 0;
+			}
 
-			auto CreateRenderTarget = [&](wi::graphics::Texture& renderTexture, const bool isInterResult)
+			auto CreateRenderTarget = [&](wi::graphics::Texture& renderTexture, const bool isInterResult, const std::string& name)
 				{
 					if (!renderTexture.IsValid())
 					{
@@ -186,7 +254,8 @@ namespace vzm
 						{
 							// we assume the main GUI and engine use the same GPU device
 							// wi::graphics::ResourceMiscFlag::SHARED_ACROSS_ADAPTER;
-							desc.misc_flags = wi::graphics::ResourceMiscFlag::SHARED;
+							//	headless devices (e.g., software Vulkan ICDs) have no host to share with and may not support external memory
+							desc.misc_flags = headlessMode ? wi::graphics::ResourceMiscFlag::NONE : wi::graphics::ResourceMiscFlag::SHARED;
 							desc.format = wi::graphics::Format::R10G10B10A2_UNORM;
 						}
 						else
@@ -196,12 +265,12 @@ namespace vzm
 						bool success = graphicsDevice->CreateTexture(&desc, nullptr, &renderTexture);
 						assert(success);
 
-						graphicsDevice->SetName(&renderTexture, (isInterResult ? "VzmRenderer::renderInterResult_" : "VzmRenderer::renderResult_") + camEntity);
+						graphicsDevice->SetName(&renderTexture, name.c_str());
 					}
 				};
 			if (colorspace_conversion_required)
 			{
-				CreateRenderTarget(renderInterResult, true);
+				CreateRenderTarget(renderInterResult, true, "VzmRenderer::renderInterResult_" + std::to_string(camEntity));
 			}
 			if (swapChain.IsValid())
 			{
@@ -210,7 +279,12 @@ namespace vzm
 			}
 			else
 			{
-				CreateRenderTarget(renderResult, false);
+				CreateRenderTarget(renderResult, false, "VzmRenderer::renderResult_" + std::to_string(camEntity));
+				for (uint32_t i = 0; i < RENDERRESULT_COUNT; ++i)
+				{
+					CreateRenderTarget(renderResults[i], false, "VzmRenderer::renderResult_" + std::to_string(camEntity) + "_" + std::to_string(i));
+				}
+				renderResultIndex = 0;
 			}
 
 			Start(); // call ResizeBuffers();
@@ -244,7 +318,17 @@ namespace vzm
 
 		// note swapChain and renderResult are exclusive
 		wi::graphics::SwapChain swapChain;
+		// renderResult is the render target of Render(), it is never swapped so the host can keep one shared view of it
 		wi::graphics::Texture renderResult;
+		// renderResults are cycled per RenderAsync() so that the host can read a finished frame while the engine renders the next ones
+		static constexpr uint32_t RENDERRESULT_COUNT = RENDER_RESULT_BUFFER_COUNT;
+		static_assert(RENDERRESULT_COUNT > wi::graphics::GraphicsDevice::GetBufferCount(), "a buffer must be free for the next frame");
+		wi::graphics::Texture renderResults[RENDERRESULT_COUNT];
+		uint64_t renderResultTickets[RENDERRESULT_COUNT] = {}; // ticket (device frame + 1) of the latest submit into renderResults[i]
+		uint32_t renderResultIndex = 0;
+		bool asyncRender = false; // the next frame is rendered into renderResults (set by RenderAsync)
+		int renderTargetIndex = -1; // render target of the current frame, -1 for renderResult or the index of renderResults
+		RenderTicket lastTicket = 0; // ticket of the latest submit
 		// renderInterResult is valid only when swapchain's color space is ColorSpace::HDR10_ST2084
 		wi::graphics::Texture renderInterResult;
 
@@ -292,6 +376,7 @@ namespace vzm
 		uint32_t DDGIRayCount = 128u; // (uint32_t value);
 		float DDGIBlendSpeed = 0.02f; 
 		float GIBoost = 1.f;
+		uint32_t DrawSceneChunkCount = 1u; // (uint32_t value);
 
 		bool DisplayProfile = false; // this is only for profiling canvas
 
@@ -377,6 +462,7 @@ namespace vzm
 			wi::renderer::SetDDGIRayCount(DDGIRayCount);
 			wi::renderer::SetDDGIBlendSpeed(DDGIBlendSpeed);
 			wi::renderer::SetGIBoost(GIBoost);
+			wi::renderer::SetDrawSceneChunkCount(DrawSceneChunkCount);
 		}
 
 		void Update(float dt) override
@@ -638,6 +724,8 @@ namespace vzm
 			if (!graphicsDevice)
 				return;
 
+			NextRenderResult();
+
 			// Begin final compositing:
 			CommandList cmd = graphicsDevice->BeginCommandList();
 			wi::image::SetCanvas(*this);
@@ -668,7 +756,7 @@ namespace vzm
 				else
 				{
 					RenderPassImage rp[] = {
-						RenderPassImage::RenderTarget(&renderResult, RenderPassImage::LoadOp::CLEAR),
+						RenderPassImage::RenderTarget(GetRenderTarget(), RenderPassImage::LoadOp::CLEAR),
 					};
 					graphicsDevice->RenderPassBegin(rp, arraysize(rp), cmd);
 				}
@@ -687,7 +775,7 @@ namespace vzm
 				else
 				{
 					RenderPassImage rp[] = {
-						RenderPassImage::RenderTarget(&renderResult, RenderPassImage::LoadOp::CLEAR),
+						RenderPassImage::RenderTarget(GetRenderTarget(), RenderPassImage::LoadOp::CLEAR),
 					};
 					graphicsDevice->RenderPassBegin(rp, arraysize(rp), cmd);
 				}
@@ -703,7 +791,7 @@ namespace vzm
 				profileFrameFinished = true;
 				wi::profiler::EndFrame(cmd); // cmd must be assigned before SubmitCommandLists
 			}
-			graphicsDevice->SubmitCommandLists();
+			lastTicket = SubmitRenderResult();
 		}
 
 		void WaitRender()
@@ -712,6 +800,8 @@ namespace vzm
 			if (!graphicsDevice)
 				return;
 
+			NextRenderResult();
+
 			wi::graphics::CommandList cmd = graphicsDevice->BeginCommandList();
 			if (swapChain.IsValid())
 			{
@@ -720,7 +810,7 @@ namespace vzm
 			else
 			{
 				wi::graphics::RenderPassImage rt[] = {
-					wi::graphics::RenderPassImage::RenderTarget(&renderResult, wi::graphics::RenderPassImage::LoadOp::CLEAR)
+					wi::graphics::RenderPassImage::RenderTarget(GetRenderTarget(), wi::graphics::RenderPassImage::LoadOp::CLEAR)
 				};
 				graphicsDevice->RenderPassBegin(rt, 1, cmd);
 			}
@@ -734,7 +824,7 @@ namespace vzm
 				wi::backlog::DrawOutputText(*this, cmd, colorspace);
 			}
 			graphicsDevice->RenderPassEnd(cmd);
-			graphicsDevice->SubmitCommandLists();
+			lastTicket = SubmitRenderResult();
 		}
 
 		bool UpdateVmCamera(const VmCamera* _vmCam = nullptr)
@@ -765,6 +855,11 @@ namespace vzm
 			TransformComponent* transform = scene->transforms.GetComponent(camEntity);
 			if (transform)
 			{
+				if (transform->IsDirty())
+				{
+					// UpdateTransform() resets the dirty flag before the scene update would see it, so the change is recorded in the scene
+					scene->transforms.SetDirty(camEntity);
+				}
 				transform->UpdateTransform();
 			}
 			else
@@ -780,8 +875,82 @@ namespace vzm
 		{
 			return vmCam;
 		}
+
+		// Selects the render target of the next frame, must be called before recording into GetRenderTarget()
+		//	asynchronous renders move to the next buffer of renderResults, the others render into renderResult
+		void NextRenderResult()
+		{
+			renderTargetIndex = -1;
+			if (asyncRender && !swapChain.IsValid() && renderResults[0].IsValid())
+			{
+				renderResultIndex = (renderResultIndex + 1) % RENDERRESULT_COUNT;
+				renderTargetIndex = (int)renderResultIndex;
+			}
+		}
+		wi::graphics::Texture* GetRenderTarget()
+		{
+			return renderTargetIndex < 0 ? &renderResult : &renderResults[renderTargetIndex];
+		}
+		// Submits the recorded command lists and returns the ticket of the submit
+		RenderTicket SubmitRenderResult()
+		{
+			wi::graphics::GraphicsDevice* graphicsDevice = wi::graphics::GetDevice();
+			RenderTicket ticket = graphicsDevice->GetFrameCount() + 1;
+			graphicsDevice->SubmitCommandLists();
+			if (renderTargetIndex >= 0)
+			{
+				renderResultTickets[renderResultIndex] = ticket;
+			}
+			return ticket;
+		}
+		// Returns the index of renderResults written by the submit of the ticket (-1 if it is already recycled)
+		int GetTicketRenderResultIndex(const RenderTicket ticket) const
+		{
+			for (uint32_t i = 0; i < RENDERRESULT_COUNT; ++i)
+			{
+				if (renderResultTickets[i] == ticket && renderResults[i].IsValid())
+				{
+					return (int)i;
+				}
+			}
+			return -1;
+		}
 	};
 
+	// glob matching of names: '*' matches any sequence, '?' matches a single character
+	static bool MatchNamePattern(const char* name, const char* pattern)
+	{
+		const char* star = nullptr;
+		const char* retry = nullptr;
+		while (*name != 0)
+		{
+			if (*pattern == '*')
+			{
+				star = pattern++;
+				retry = name;
+			}
+			else if (*pattern == '?' || *pattern == *name)
+			{
+				pattern++;
+				name++;
+			}
+			else if (star != nullptr)
+			{
+				pattern = star + 1;
+				name = ++retry;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while (*pattern == '*')
+		{
+			pattern++;
+		}
+		return *pattern == 0;
+	}
+
 	struct VzmScene : Scene
 	{
 		VID sceneVid = INVALID_VID;
@@ -790,6 +959,148 @@ namespace vzm
 
 		float deltaTime = 0;
 		wi::Timer timer;
+
+	private:
+		// <name, entities in the order of the name components>
+		//	the index is rebuilt when the name components were added or removed by others (e.g. Scene::Merge, Entity_Remove),
+		//	the renames must be done by SetEntityName() (the queries validate the names, so a missed rename is never returned wrongly)
+		//	the lookups can run concurrently, so the lazy rebuild and the incremental updates are done under nameIndexLock
+		std::mutex nameIndexLock;
+		wi::unordered_map<std::string, wi::vector<Entity>> nameIndex;
+		wi::vector<std::pair<std::string, Entity>> sortedNames; // for the prefix and glob queries, sorted on demand
+		uint64_t nameIndexGeneration = ~0ull;
+		bool sortedNamesValid = false;
+
+		inline void updateNameIndex()
+		{
+			if (nameIndexGeneration == names.GetGeneration())
+			{
+				return;
+			}
+			nameIndex.clear();
+			for (size_t i = 0; i < names.GetCount(); ++i)
+			{
+				nameIndex[names[i].name].push_back(names.GetEntity(i));
+			}
+			nameIndexGeneration = names.GetGeneration();
+			sortedNamesValid = false;
+		}
+		inline void updateSortedNames()
+		{
+			updateNameIndex();
+			if (sortedNamesValid)
+			{
+				return;
+			}
+			sortedNames.clear();
+			sortedNames.reserve(names.GetCount());
+			for (size_t i = 0; i < names.GetCount(); ++i)
+			{
+				sortedNames.emplace_back(names[i].name, names.GetEntity(i));
+			}
+			// stable, so the entities of the same name stay in the order of the name components
+			std::stable_sort(sortedNames.begin(), sortedNames.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			sortedNamesValid = true;
+		}
+		inline bool hasName(Entity entity, const std::string& name) const
+		{
+			const NameComponent* nameComp = names.GetComponent(entity);
+			return nameComp != nullptr && nameComp->name == name;
+		}
+
+	public:
+		// Call it after a name component was created, so the index is updated without a rebuild
+		inline void OnNameCreated(Entity entity)
+		{
+			std::scoped_lock lck(nameIndexLock);
+			const NameComponent* nameComp = names.GetComponent(entity);
+			if (nameComp != nullptr && nameIndexGeneration + 1 == names.GetGeneration())
+			{
+				nameIndex[nameComp->name].push_back(entity);
+				nameIndexGeneration++;
+				sortedNamesValid = false;
+			}
+		}
+		inline void SetEntityName(Entity entity, const std::string& newName)
+		{
+			NameComponent* nameComp = names.GetComponent(entity);
+			if (nameComp == nullptr)
+			{
+				return;
+			}
+			std::scoped_lock lck(nameIndexLock);
+			if (nameIndexGeneration == names.GetGeneration())
+			{
+				auto it = nameIndex.find(nameComp->name);
+				if (it != nameIndex.end())
+				{
+					wi::vector<Entity>& entities = it->second;
+					entities.erase(std::remove(entities.begin(), entities.end(), entity), entities.end());
+					if (entities.empty())
+					{
+						nameIndex.erase(it);
+					}
+				}
+				// the entity is moved at the end of the same name entities, the order of the name components is not kept for renamed entities
+				nameIndex[newName].push_back(entity);
+				sortedNamesValid = false;
+			}
+			nameComp->name = newName;
+		}
+		inline Entity FindFirstEntityByName(const std::string& name)
+		{
+			std::scoped_lock lck(nameIndexLock);
+			updateNameIndex();
+			auto it = nameIndex.find(name);
+			if (it != nameIndex.end())
+			{
+				for (Entity entity : it->second)
+				{
+					if (hasName(entity, name))
+					{
+						return entity;
+					}
+				}
+			}
+			return INVALID_ENTITY;
+		}
+		inline void FindEntitiesByName(const std::string& name, std::vector<VID>& vids)
+		{
+			std::scoped_lock lck(nameIndexLock);
+			updateNameIndex();
+			auto it = nameIndex.find(name);
+			if (it != nameIndex.end())
+			{
+				for (Entity entity : it->second)
+				{
+					if (hasName(entity, name))
+					{
+						vids.push_back(entity);
+					}
+				}
+			}
+		}
+		// '*' and '?' wildcards are supported, the literal prefix of the pattern narrows the searched range of the sorted names
+		inline void FindEntitiesByPattern(const std::string& pattern, std::vector<VID>& vids)
+		{
+			const size_t wildcard = pattern.find_first_of("*?");
+			if (wildcard == std::string::npos)
+			{
+				FindEntitiesByName(pattern, vids);
+				return;
+			}
+			std::scoped_lock lck(nameIndexLock);
+			updateSortedNames();
+			const std::string prefix = pattern.substr(0, wildcard);
+			auto it = std::lower_bound(sortedNames.begin(), sortedNames.end(), prefix, [](const auto& a, const std::string& b) { return a.first < b; });
+			for (; it != sortedNames.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+			{
+				if (MatchNamePattern(it->first.c_str() + prefix.size(), pattern.c_str() + prefix.size()) && hasName(it->second, it->first))
+				{
+					vids.push_back(it->second);
+				}
+			}
+		}
 	};
 
 	class SceneManager
@@ -801,34 +1112,123 @@ namespace vzm
 		std::map<VID, VzmScene> scenes;						// <SceneEntity, Scene>
 		// one camera component to one renderer
 		std::map<VID, VzmRenderer> renderers;				// <CamEntity, VzmRenderer> (including camera and scene)
-		wi::unordered_map<VID, std::unique_ptr<VmBaseComponent>> vmComponents;
+		wi::unordered_map<VID, VmBaseComponent*> vmComponents;	// allocated by vmCompPool
+
+		// VmComponents are allocated from per-type pools, so that merging a large model doesn't make a heap allocation per entity
+		struct VmCompPool
+		{
+			wi::allocator::BlockAllocator<VmBaseComponent> base;
+			wi::allocator::BlockAllocator<VmAnimation> animation;
+			wi::allocator::BlockAllocator<VmActor> actor;
+			wi::allocator::BlockAllocator<VmMesh> mesh;
+			wi::allocator::BlockAllocator<VmMaterial> material;
+			wi::allocator::BlockAllocator<VmLight> light;
+			wi::allocator::BlockAllocator<VmEmitter> emitter;
+			wi::allocator::BlockAllocator<VmWeather> weather;
+			wi::allocator::BlockAllocator<VmCamera> camera;
+			wi::allocator::BlockAllocator<VmCollider> collider;
+
+			template <typename VMCOMP>
+			inline wi::allocator::BlockAllocator<VMCOMP>& Get()
+			{
+				if constexpr (std::is_same_v<VMCOMP, VmBaseComponent>) return base;
+				else if constexpr (std::is_same_v<VMCOMP, VmAnimation>) return animation;
+				else if constexpr (std::is_same_v<VMCOMP, VmActor>) return actor;
+				else if constexpr (std::is_same_v<VMCOMP, VmMesh>) return mesh;
+				else if constexpr (std::is_same_v<VMCOMP, VmMaterial>) return material;
+				else if constexpr (std::is_same_v<VMCOMP, VmLight>) return light;
+				else if constexpr (std::is_same_v<VMCOMP, VmEmitter>) return emitter;
+				else if constexpr (std::is_same_v<VMCOMP, VmWeather>) return weather;
+				else if constexpr (std::is_same_v<VMCOMP, VmCamera>) return camera;
+				else if constexpr (std::is_same_v<VMCOMP, VmCollider>) return collider;
+				else static_assert(sizeof(VMCOMP) == 0, "Not allowed VmComponent");
+			}
+			// The VmComponent types don't have virtual destructors, so they are freed by their compType
+			inline void Free(VmBaseComponent* vmComp)
+			{
+				switch (vmComp->compType)
+				{
+				case COMPONENT_TYPE::BASE: base.free(vmComp); break;
+				case COMPONENT_TYPE::ANIMATION: animation.free((VmAnimation*)vmComp); break;
+				case COMPONENT_TYPE::ACTOR: actor.free((VmActor*)vmComp); break;
+				case COMPONENT_TYPE::GEOMETRY: mesh.free((VmMesh*)vmComp); break;
+				case COMPONENT_TYPE::MATERIAL: material.free((VmMaterial*)vmComp); break;
+				case COMPONENT_TYPE::LIGHT: light.free((VmLight*)vmComp); break;
+				case COMPONENT_TYPE::EMITTER: emitter.free((VmEmitter*)vmComp); break;
+				case COMPONENT_TYPE::WEATHER: weather.free((VmWeather*)vmComp); break;
+				case COMPONENT_TYPE::CAMERA: camera.free((VmCamera*)vmComp); break;
+				case COMPONENT_TYPE::COLLIDER: collider.free((VmCollider*)vmComp); break;
+				default: assert(0); break;
+				}
+			}
+		};
+		VmCompPool vmCompPool;
+
+		inline void removeVmComp(const VID vid)
+		{
+			auto it = vmComponents.find(vid);
+			if (it != vmComponents.end())
+			{
+				vmCompPool.Free(it->second);
+				vmComponents.erase(it);
+			}
+		}
+		// global entity index <VID, owner scene>, the scenes are std::map nodes so the pointers are stable
+		wi::unordered_map<VID, VzmScene*> entityScenes;
+		// entities that were not indexed but found by scanning the scenes (e.g. created by engine internals),
+		//	kept apart from entityScenes so that the concurrent lookups only write this cache, under its lock
+		mutable std::mutex scannedScenesLock;
+		mutable wi::unordered_map<VID, VzmScene*> scannedScenes;
+
+		inline void unindexEntity(const VID vid)
+		{
+			entityScenes.erase(vid);
+			std::scoped_lock lck(scannedScenesLock);
+			scannedScenes.erase(vid);
+		}
 
 	public:
+		~SceneManager()
+		{
+			for (auto& it : vmComponents)
+			{
+				vmCompPool.Free(it.second);
+			}
+		}
+
 		void Initialize(::vzm::ParamMap<std::string>& argument)
 		{
+			static const AttributeKey KEY_WINDOW = InternAttributeKey("window");
+			static const AttributeKey KEY_DEBUGDEVICE = InternAttributeKey("debugdevice");
+			static const AttributeKey KEY_GPUVALIDATION = InternAttributeKey("gpuvalidation");
+			static const AttributeKey KEY_GPU_VERBOSE = InternAttributeKey("gpu_verbose");
+			static const AttributeKey KEY_IGPU = InternAttributeKey("igpu");
+			static const AttributeKey KEY_HEADLESS = InternAttributeKey("headless");
+
 			// device creation
 			// User can also create a graphics device if custom logic is desired, but they must do before this function!
-			wi::platform::window_type window = argument.GetParam("window", wi::platform::window_type(nullptr));
-			if (graphicsDevice == nullptr)
+			//	a device that the host application already created (e.g., a wi::Application) is shared
+			wi::platform::window_type window = argument.GetParam(KEY_WINDOW, wi::platform::window_type(nullptr));
+			if (graphicsDevice == nullptr && wi::graphics::GetDevice() == nullptr)
 			{
 				using namespace wi::graphics;
 
 				ValidationMode validationMode = ValidationMode::Disabled;
-				if (argument.GetParam("debugdevice", false))
+				if (argument.GetParam(KEY_DEBUGDEVICE, false))
 				{
 					validationMode = ValidationMode::Enabled;
 				}
-				if (argument.GetParam("gpuvalidation", false))
+				if (argument.GetParam(KEY_GPUVALIDATION, false))
 				{
 					validationMode = ValidationMode::GPU;
 				}
-				if (argument.GetParam("gpu_verbose", false))
+				if (argument.GetParam(KEY_GPU_VERBOSE, false))
 				{
 					validationMode = ValidationMode::Verbose;
 				}
 
 				GPUPreference preference = GPUPreference::Discrete;
-				if (argument.GetParam("igpu", false))
+				if (argument.GetParam(KEY_IGPU, false))
 				{
 					preference = GPUPreference::Integrated;
 				}
@@ -836,6 +1236,17 @@ namespace vzm
 				bool use_dx12 = wi::arguments::HasArgument("dx12");
 				bool use_vulkan = wi::arguments::HasArgument("vulkan");
 
+				headlessMode = argument.GetParam(KEY_HEADLESS, false) || wi::arguments::HasArgument("headless");
+				if (headlessMode)
+				{
+					// headless rendering targets GPU-less machines (e.g., CI nodes) through a software Vulkan ICD such as lavapipe
+					//	DX12 is still used if it is explicitly requested (WARP adapter)
+					window = nullptr;
+#if defined(WICKEDENGINE_BUILD_VULKAN)
+					use_vulkan = !use_dx12;
+#endif
+				}
+
 #ifndef WICKEDENGINE_BUILD_DX12
 				if (use_dx12) {
 					wi::helper::messageBox("The engine was built without DX12 support!", "Error");
@@ -877,7 +1288,10 @@ namespace vzm
 #endif
 				}
 			}
-			wi::graphics::GetDevice() = graphicsDevice.get();
+			if (graphicsDevice != nullptr)
+			{
+				wi::graphics::GetDevice() = graphicsDevice.get();
+			}
 
 			wi::initializer::InitializeComponentsAsync();
 			//wi::initializer::InitializeComponentsImmediate();
@@ -903,6 +1317,11 @@ namespace vzm
 			if (ett != INVALID_ENTITY) {
 				VzmScene& scene = scenes[ett];
 				wi::renderer::ClearWorld(scene);
+				// VIDs are sequential entities and components are queried by VID many times per frame, so the paged lookup is used:
+				for (auto& entry : scene.componentLibrary.entries)
+				{
+					entry.second.component_manager->SetLookupMode(wi::ecs::LookupMode::PAGED);
+				}
 				scene.weather = WeatherComponent();
 				scene.weather.ambient = XMFLOAT3(0.9f, 0.9f, 0.9f);
 				wi::Color default_sky_zenith = wi::Color(30, 40, 60, 200);
@@ -929,16 +1348,13 @@ namespace vzm
 			VzmRenderer* renderer = &renderers[camEntity];
 			renderer->camEntity = camEntity;
 
-			for (auto it = scenes.begin(); it != scenes.end(); it++)
+			VzmScene* scene = GetOwnerScene(camEntity);
+			CameraComponent* camera = scene ? scene->cameras.GetComponent(camEntity) : nullptr;
+			if (camera)
 			{
-				VzmScene* scene = &it->second;
-				CameraComponent* camera = scene->cameras.GetComponent(camEntity);
-				if (camera)
-				{
-					renderer->scene = scene;
-					renderer->camera = camera;
-					return renderer;
-				}
+				renderer->scene = scene;
+				renderer->camera = camera;
+				return renderer;
 			}
 			renderers.erase(camEntity);
 			return nullptr;
@@ -949,22 +1365,32 @@ namespace vzm
 			for (auto it = scenes.begin(); it != scenes.end(); it++)
 			{
 				VzmScene& scene = it->second;
-				for (Entity ett : scene.names.GetEntityArray())
+				scene.FindEntitiesByName(name, vids);
+				if (scene.name == name)
 				{
-					NameComponent* nameComp = scene.names.GetComponent(ett);
-					if (nameComp != nullptr)
-					{
-						vids.push_back(ett);
-					}
+					vids.push_back(scene.sceneVid);
+				}
+			}
+			return vids.size();
+		}
+		inline size_t GetVidsByNamePattern(const std::string& pattern, std::vector<VID>& vids)
+		{
+			for (auto it = scenes.begin(); it != scenes.end(); it++)
+			{
+				VzmScene& scene = it->second;
+				scene.FindEntitiesByPattern(pattern, vids);
+				if (MatchNamePattern(scene.name.c_str(), pattern.c_str()))
+				{
+					vids.push_back(scene.sceneVid);
 				}
 			}
-			return (uint32_t)vids.size();
+			return vids.size();
 		}
 		inline VID GetFirstVidByName(const std::string& name)
 		{
 			for (auto it = scenes.begin(); it != scenes.end(); it++)
 			{
-				Entity ett = it->second.Entity_FindByName(name);
+				Entity ett = it->second.FindFirstEntityByName(name);
 				if (ett != INVALID_ENTITY)
 				{
 					return ett;
@@ -978,13 +1404,10 @@ namespace vzm
 		}
 		inline std::string GetNameByVid(const VID vid)
 		{
-			for (auto it = scenes.begin(); it != scenes.end(); it++)
+			NameComponent* nameComp = GetEngineComp<NameComponent>(vid);
+			if (nameComp)
 			{
-				NameComponent* nameComp = it->second.names.GetComponent(vid);
-				if (nameComp)
-				{
-					return nameComp->name;
-				}
+				return nameComp->name;
 			}
 			auto it = scenes.find(vid);
 			if (it != scenes.end())
@@ -1038,29 +1461,38 @@ namespace vzm
 			auto it = vmComponents.find(vid);
 			assert(it == vmComponents.end());
 
-			std::string typeName = typeid(VMCOMP).name();
-			COMPONENT_TYPE compType = vmcomptypes[typeName];
-			if (compType == COMPONENT_TYPE::UNDEFINED)
+			if (GetOwnerScene(vid) == nullptr)
 			{
 				return nullptr;
 			}
-
-			for (auto sit = scenes.begin(); sit != scenes.end(); sit++)
+			VMCOMP* vmComp = vmCompPool.Get<VMCOMP>().allocate();
+			vmComp->componentVID = vid;
+			vmComp->compType = GetVmCompType<VMCOMP>();
+			vmComponents[vid] = vmComp;
+			return vmComp;
+		}
+		// Bulk version of CreateVmComp for entities which are known to be owned by the scene (e.g. after a merge)
+		//	the entities which already have a VmComponent are skipped
+		template <typename VMCOMP>
+		inline void CreateVmComps(const Entity* entities, const size_t count, VzmScene* owner)
+		{
+			auto& pool = vmCompPool.Get<VMCOMP>();
+			vmComponents.reserve(vmComponents.size() + count);
+			entityScenes.reserve(entityScenes.size() + count);
+			for (size_t i = 0; i < count; ++i)
 			{
-				VzmScene* scene = &sit->second;
-				wi::unordered_set<Entity> entities;
-				scene->FindAllEntities(entities);
-				auto it = entities.find(vid);
-				if (it != entities.end())
+				const Entity entity = entities[i];
+				VmBaseComponent*& slot = vmComponents[entity];
+				if (slot != nullptr)
 				{
-					VMCOMP vmComp;
-					vmComp.componentVID = vid;
-					vmComp.compType = compType;
-					vmComponents.insert(std::make_pair(vid, std::make_unique<VMCOMP>(vmComp)));
-					return (VMCOMP*)vmComponents[vid].get();
+					continue;
 				}
+				VMCOMP* vmComp = pool.allocate();
+				vmComp->componentVID = entity;
+				vmComp->compType = GetVmCompType<VMCOMP>();
+				slot = vmComp;
+				entityScenes[entity] = owner;
 			}
-			return nullptr;
 		}
 
 		template <typename VMCOMP>
@@ -1071,45 +1503,74 @@ namespace vzm
 			{
 				return nullptr;
 			}
-			return (VMCOMP*)it->second.get();
+			return (VMCOMP*)it->second;
 		}
 		template <typename COMP>
 		inline COMP* GetEngineComp(const VID vid)
 		{
-			std::string typeName = typeid(COMP).name();
-			CompType compType = comptypes[typeName];
-			COMP* comp = nullptr;
-			for (auto it = scenes.begin(); it != scenes.end(); it++)
+			VzmScene* scene = GetOwnerScene(vid);
+			if (scene == nullptr)
 			{
-				VzmScene* scene = &it->second;
-				switch (compType)
+				return nullptr;
+			}
+			return GetComponentManager<COMP>(*scene).GetComponent(vid);
+		}
+
+		// Returns the scene owning the entity (VIDs are unique over all scenes)
+		//	the index is only written when entities are created/merged/removed, so lookups never modify it,
+		//	entities that are not indexed (e.g. created by engine internals) are found by scanning the scenes once, then cached
+		inline VzmScene* GetOwnerScene(const VID vid) const
+		{
+			if (!wi::ecs::IsEntityCreated(vid))
+			{
+				return nullptr;
+			}
+			auto it = entityScenes.find(vid);
+			if (it != entityScenes.end())
+			{
+				return it->second;
+			}
+			if (scenes.count(vid) > 0)
+			{
+				return nullptr; // scenes are not owned by scenes
+			}
+
+			std::scoped_lock lck(scannedScenesLock);
+			auto it_scanned = scannedScenes.find(vid);
+			if (it_scanned != scannedScenes.end())
+			{
+				return it_scanned->second;
+			}
+			for (auto sit = scenes.begin(); sit != scenes.end(); sit++)
+			{
+				const VzmScene* scene = &sit->second;
+				for (auto& entry : scene->componentLibrary.entries)
 				{
-				case CompType::CameraComponent_:
-					comp = (COMP*)scene->cameras.GetComponent(vid); break;
-				case CompType::ObjectComponent_:
-					comp = (COMP*)scene->objects.GetComponent(vid); break;
-				case CompType::TransformComponent_:
-					comp = (COMP*)scene->transforms.GetComponent(vid); break;
-				case CompType::HierarchyComponent_:
-					comp = (COMP*)scene->hierarchy.GetComponent(vid); break;
-				case CompType::NameComponent_:
-					comp = (COMP*)scene->names.GetComponent(vid); break;
-				case CompType::LightComponent_:
-					comp = (COMP*)scene->lights.GetComponent(vid); break;
-				case CompType::AnimationComponent_:
-					comp = (COMP*)scene->animations.GetComponent(vid); break;
-				case CompType::EmittedParticleSystem_:
-					comp = (COMP*)scene->emitters.GetComponent(vid); break;
-				case CompType::ColliderComponent_:
-					comp = (COMP*)scene->colliders.GetComponent(vid); break;
-				case CompType::WeatherComponent_:
-					comp = (COMP*)scene->weathers.GetComponent(vid); break;
-				default: assert(0 && "Not allowed GetComponent");  return nullptr;
+					if (entry.second.component_manager->Contains(vid))
+					{
+						VzmScene* owner = const_cast<VzmScene*>(scene);
+						scannedScenes[vid] = owner;
+						return owner;
+					}
+				}
+			}
+			return nullptr;
+		}
+		// Must be called when entities are created in or moved into the scene (e.g. by Scene::Merge)
+		inline void IndexEntity(const VID vid, VzmScene* scene)
+		{
+			entityScenes[vid] = scene;
+		}
+		// Indexes all entities of the scene to the owner, call it before merging a scene into the owner
+		inline void IndexSceneEntities(const Scene& scene, VzmScene* owner)
+		{
+			for (auto& entry : scene.componentLibrary.entries)
+			{
+				for (Entity entity : entry.second.component_manager->GetEntityArray())
+				{
+					entityScenes[entity] = owner;
 				}
-				if (comp) break;
 			}
-
-			return comp;
 		}
 
 		inline void RemoveEntity(const VID vid)
@@ -1120,33 +1581,322 @@ namespace vzm
 				wi::unordered_set<Entity> entities;
 				scene->FindAllEntities(entities);
 
+				// the engine can remove entities on its own, so the index entries pointing to the scene are erased by value
+				for (auto it = entityScenes.begin(); it != entityScenes.end();)
+				{
+					if (it->second == scene)
+					{
+						entities.insert(it->first);
+						it = entityScenes.erase(it);
+					}
+					else
+					{
+						it++;
+					}
+				}
+				{
+					std::scoped_lock lck(scannedScenesLock);
+					for (auto it = scannedScenes.begin(); it != scannedScenes.end();)
+					{
+						if (it->second == scene)
+						{
+							entities.insert(it->first);
+							it = scannedScenes.erase(it);
+						}
+						else
+						{
+							it++;
+						}
+					}
+				}
+
 				for (auto it = entities.begin(); it != entities.end(); it++)
 				{
 					renderers.erase(*it);
-					vmComponents.erase(*it);
+					removeVmComp(*it);
+					entityScenes.erase(*it);
 				}
 				scenes.erase(vid);
 			}
 			else
 			{
-
-				for (auto it = scenes.begin(); it != scenes.end(); it++)
+				scene = GetOwnerScene(vid);
+				if (scene)
 				{
-					VzmScene* scene = &it->second;
+					// the descendants are removed with the entity, so their renderers, VmComponents and index entries are released too
+					wi::vector<Entity> descendants;
+					for (size_t i = 0; i < scene->hierarchy.GetCount(); ++i)
+					{
+						const Entity entity = scene->hierarchy.GetEntity(i);
+						if (scene->Entity_IsDescendant(entity, vid))
+						{
+							descendants.push_back(entity);
+						}
+					}
 					scene->Entity_Remove(vid);
+					for (Entity entity : descendants)
+					{
+						renderers.erase(entity);
+						removeVmComp(entity);
+						unindexEntity(entity);
+					}
 				}
 				renderers.erase(vid);
-				vmComponents.erase(vid);
+				removeVmComp(vid);
+				unindexEntity(vid);
 			}
 		}
 	};
 #pragma endregion
 
 	SceneManager sceneManager;
-}
 
-
-#define COMP_GET(COMP, PARAM, RET) COMP* PARAM = sceneManager.GetEngineComp<COMP>(componentVID); if (!PARAM) return RET;
+#pragma region // async loader
+	static Entity ImportModelFile(const std::string& file, Scene& scene, ModelImportProgress* progress)
+	{
+		std::string extension = wi::helper::toUpper(wi::helper::GetExtensionFromFileName(file));
+		auto it = filetypes.find(extension);
+		if (it == filetypes.end())
+		{
+			return INVALID_ENTITY;
+		}
+		switch (it->second)
+		{
+		case FileType::OBJ: // wavefront-obj
+			return ImportModel_OBJ(file, scene, progress);	// reassign transform components
+		case FileType::GLTF: // gltf, vrm
+		case FileType::GLB:
+		case FileType::VRM:
+			return ImportModel_GLTF(file, scene, progress);
+		default:
+			return INVALID_ENTITY;
+		}
+	}
+
+	// Files are imported into private scenes by the low priority job threads, so the number of OS threads is bounded by the job system
+	//	and the imported scenes are registered by the thread calling vzm APIs (SceneManager is not thread-safe)
+	class AsyncLoader
+	{
+	private:
+		struct LoadJob
+		{
+			// input param
+			std::string file;
+			std::string rootName;
+			std::string sceneName;
+			std::function<void(VID sceneVid, VID rootVid)> callback;
+
+			wi::jobsystem::context ctx;
+			mutable wi::Timer timer; // only read after the submission
+			ModelImportProgress progress;
+			std::atomic<LOAD_STATE> state = { LOAD_STATE::QUEUED };
+			std::atomic_bool imported = { false }; // elapsedMS is written, the record can only be released once ctx is idle
+
+			// written by the job thread
+			std::unique_ptr<Scene> scene;
+			Entity rootEntity = INVALID_ENTITY;
+			float elapsedMS = 0;
+
+			// written by the commit
+			VID sceneVid = INVALID_VID;
+			VID rootVid = INVALID_VID;
+		};
+
+		LoadTicket nextTicket = INVALID_TICKET;
+		std::map<LoadTicket, std::unique_ptr<LoadJob>> jobs; // loads that are not committed yet
+		// The final progress of the committed loads, kept for a later GetProgress/Wait
+		//	the oldest ones are dropped, so loads that are never waited (e.g., callback only) don't accumulate
+		static constexpr size_t MAX_RESULTS = 256;
+		std::map<LoadTicket, LoadProgress> results;
+
+		static void get_progress(const LoadJob& job, LoadProgress& progress)
+		{
+			progress.state = job.state.load();
+			progress.bytesTotal = job.progress.bytesTotal.load(std::memory_order_relaxed);
+			progress.bytesParsed = job.progress.bytesParsed.load(std::memory_order_relaxed);
+			progress.meshesTotal = job.progress.meshesTotal.load(std::memory_order_relaxed);
+			progress.meshesCreated = job.progress.meshesCreated.load(std::memory_order_relaxed);
+			progress.texturesTotal = job.progress.texturesTotal.load(std::memory_order_relaxed);
+			progress.texturesCreated = job.progress.texturesCreated.load(std::memory_order_relaxed);
+			progress.elapsedMS = job.imported.load(std::memory_order_acquire) ? job.elapsedMS : (float)job.timer.elapsed();
+			progress.sceneVid = job.sceneVid;
+			progress.rootVid = job.rootVid;
+		}
+
+		// Register the imported scene (unless cancelled), the job must be imported and already removed from the in-flight jobs
+		void commit(const LoadTicket ticket, LoadJob& job)
+		{
+			if (job.state.load() != LOAD_STATE::CANCELLED && job.rootEntity != INVALID_ENTITY)
+			{
+				VID sid = sceneManager.CreateSceneEntity(job.sceneName);
+				VzmScene* scene = sceneManager.GetScene(sid);
+				if (scene != nullptr)
+				{
+					sceneManager.IndexSceneEntities(*job.scene, scene);
+					scene->Merge(*job.scene);
+					scene->SetEntityName(job.rootEntity, job.rootName);
+					job.sceneVid = sid;
+					job.rootVid = job.rootEntity;
+				}
+			}
+			job.scene.reset();
+
+			const bool cancelled = job.state.load() == LOAD_STATE::CANCELLED;
+			if (!cancelled)
+			{
+				job.state.store(job.sceneVid != INVALID_VID ? LOAD_STATE::FINISHED : LOAD_STATE::FAILED);
+				wi::backlog::post("[vzm::LoadFileIntoNewSceneAsync] " + job.file + " (" + std::to_string((int)std::round(job.elapsedMS)) + " ms)",
+					job.sceneVid != INVALID_VID ? backlog::LogLevel::Default : backlog::LogLevel::Error);
+			}
+
+			// the result is stored before the callback, which is allowed to query or wait this ticket
+			get_progress(job, results[ticket]);
+			while (results.size() > MAX_RESULTS)
+			{
+				results.erase(results.begin());
+			}
+
+			if (!cancelled && job.callback != nullptr)
+			{
+				job.callback(job.sceneVid, job.rootVid);
+			}
+		}
+
+	public:
+		LoadTicket Submit(const std::string& file, const std::string& rootName, const std::string& sceneName, const std::function<void(VID sceneVid, VID rootVid)>& callback)
+		{
+			LoadTicket ticket = ++nextTicket;
+			std::unique_ptr<LoadJob>& job = jobs[ticket];
+			job = std::make_unique<LoadJob>();
+			job->file = file;
+			job->rootName = rootName;
+			job->sceneName = sceneName;
+			job->callback = callback;
+			job->ctx.priority = wi::jobsystem::Priority::Low;
+
+			LoadJob* jobPtr = job.get(); // the job record is kept alive until the job context is idle and committed
+			wi::jobsystem::Execute(jobPtr->ctx, [jobPtr](wi::jobsystem::JobArgs args) {
+				ScopedCPUEvent("Async Load");
+				LOAD_STATE expected = LOAD_STATE::QUEUED;
+				if (jobPtr->state.compare_exchange_strong(expected, LOAD_STATE::LOADING))
+				{
+					jobPtr->scene = std::make_unique<Scene>();
+					jobPtr->rootEntity = ImportModelFile(jobPtr->file, *jobPtr->scene, &jobPtr->progress);
+				}
+				jobPtr->elapsedMS = (float)jobPtr->timer.elapsed();
+				jobPtr->imported.store(true, std::memory_order_release);
+				});
+			return ticket;
+		}
+
+		// Register the imported scenes and call the callbacks, must be called by the thread calling vzm APIs
+		//	only the in-flight loads are visited, committed and cancelled loads are released here
+		void CommitFinished()
+		{
+			// the callbacks are allowed to submit (or wait) other loads, so the ready tickets are gathered first
+			std::vector<LoadTicket> ready;
+			//	the job system releases the context (which lives in the record) after the job function returned,
+			//	so a record is only released once its context is idle, the imported flag alone is not enough
+			for (auto& it : jobs)
+			{
+				if (!wi::jobsystem::IsBusy(it.second->ctx))
+				{
+					ready.push_back(it.first);
+				}
+			}
+			for (LoadTicket ticket : ready)
+			{
+				auto it = jobs.find(ticket);
+				if (it == jobs.end())
+					continue;
+				std::unique_ptr<LoadJob> job = std::move(it->second);
+				jobs.erase(it);
+				commit(ticket, *job);
+			}
+		}
+
+		bool GetProgress(const LoadTicket ticket, LoadProgress& progress)
+		{
+			CommitFinished();
+			auto it = jobs.find(ticket);
+			if (it != jobs.end())
+			{
+				get_progress(*it->second, progress);
+				return true;
+			}
+			auto it_result = results.find(ticket);
+			if (it_result != results.end())
+			{
+				progress = it_result->second;
+				return true;
+			}
+			progress = LoadProgress();
+			return false;
+		}
+
+		bool Cancel(const LoadTicket ticket)
+		{
+			auto it = jobs.find(ticket);
+			if (it == jobs.end())
+			{
+				return false;
+			}
+			LoadJob& job = *it->second;
+			LOAD_STATE state = job.state.load();
+			if (state != LOAD_STATE::QUEUED && state != LOAD_STATE::LOADING)
+			{
+				return false;
+			}
+			// the job thread only writes the state when it starts, so a cancelled state is never overwritten
+			//	the record is released by CommitFinished once the job is idle
+			job.progress.cancelled.store(true);
+			job.state.store(LOAD_STATE::CANCELLED);
+			return true;
+		}
+
+		VZRESULT Wait(const LoadTicket ticket, VID* sceneVid, VID* rootVid)
+		{
+			auto it = jobs.find(ticket);
+			if (it != jobs.end())
+			{
+				wi::jobsystem::Wait(it->second->ctx);
+				CommitFinished();
+			}
+
+			auto it_result = results.find(ticket); // the callbacks might have waited it already
+			if (it_result == results.end())
+			{
+				return VZ_FAIL;
+			}
+			const LoadProgress result = it_result->second;
+			results.erase(it_result);
+			if (sceneVid) *sceneVid = result.sceneVid;
+			if (rootVid) *rootVid = result.rootVid;
+			return result.state == LOAD_STATE::FINISHED ? VZ_OK : VZ_FAIL;
+		}
+
+		// Cancel and discard all the loads (the job system must be alive)
+		void Clear()
+		{
+			for (auto& it : jobs)
+			{
+				Cancel(it.first);
+			}
+			for (auto& it : jobs)
+			{
+				wi::jobsystem::Wait(it.second->ctx);
+			}
+			jobs.clear();
+			results.clear();
+		}
+	};
+#pragma endregion
+
+	AsyncLoader asyncLoader;
+}
+
+
+#define COMP_GET(COMP, PARAM, RET) COMP* PARAM = sceneManager.GetEngineComp<COMP>(componentVID); if (!PARAM) return RET;
 
 namespace vzm 
 {
@@ -1479,6 +2229,16 @@ namespace vzm
 		RENDERER_GET;
 		return vrenderer->GIBoost;
 	}
+	void VmRenderer::SetDrawSceneChunkCount(uint32_t value)
+	{
+		RENDERER_GET;
+		vrenderer->DrawSceneChunkCount = std::max(1u, value);
+	}
+	uint32_t VmRenderer::GetDrawSceneChunkCount()
+	{
+		RENDERER_GET;
+		return vrenderer->DrawSceneChunkCount;
+	}
 #pragma endregion
 
 #pragma region // VmCamera
@@ -2413,7 +3173,7 @@ namespace vzm
 	};
 	static std::unique_ptr<SafeReleaseChecker> safeReleaseChecker;
 
-	VZRESULT InitEngineLib(const std::string& coreName, const std::string& logFileName)
+	static VZRESULT initEngineLib(const std::string& coreName, const std::string& logFileName, const bool headless)
 	{
 		static bool initialized = false;
 		if (initialized)
@@ -2441,6 +3201,7 @@ namespace vzm
 		}
 
 		ParamMap<std::string> arguments;
+		arguments.SetParam("headless", headless);
 		sceneManager.Initialize(arguments);
 
 		// With this mode, file data for resources will be kept around. This allows serializing embedded resource data inside scenes
@@ -2454,6 +3215,15 @@ namespace vzm
 		return VZ_OK;
 	}
 
+	VZRESULT InitEngineLib(const std::string& coreName, const std::string& logFileName)
+	{
+		return initEngineLib(coreName, logFileName, false);
+	}
+	VZRESULT InitEngineLibHeadless(const std::string& coreName, const std::string& logFileName)
+	{
+		return initEngineLib(coreName, logFileName, true);
+	}
+
 	VZRESULT DeinitEngineLib()
 	{
 		if (safeReleaseChecker.get() == nullptr)
@@ -2461,6 +3231,7 @@ namespace vzm
 			wi::backlog::post("MUST CALL vzm::InitEngineLib before calling vzm::DeinitEngineLib()", backlog::LogLevel::Error);
 			return VZ_WARNNING;
 		}
+		asyncLoader.Clear();
 		wi::jobsystem::ShutDown();
 		// DOJO adds for explicit release of COM-based components
 		wi::audio::Deinitialize(); // note audio is based on COM, so explicitly destruction is required!
@@ -2478,6 +3249,11 @@ namespace vzm
 		return sceneManager.GetVidsByName(name, vids);
 	}
 
+	size_t GetVidsByNamePattern(const std::string& pattern, std::vector<VID>& vids)
+	{
+		return sceneManager.GetVidsByNamePattern(pattern, vids);
+	}
+
 	bool GetNameByVid(const VID vid, std::string& name)
 	{
 		name = sceneManager.GetNameByVid(vid);
@@ -2530,6 +3306,7 @@ namespace vzm
 		case COMPONENT_TYPE::ACTOR:
 		{
 			ett = scene->Entity_CreateObject(compName);
+			sceneManager.IndexEntity(ett, scene);
 			VmActor* vmActor = sceneManager.CreateVmComp<VmActor>(ett);
 			if (baseComp) *baseComp = vmActor;
 			break;
@@ -2537,6 +3314,7 @@ namespace vzm
 		case COMPONENT_TYPE::CAMERA:
 		{
 			ett = scene->Entity_CreateCamera(compName, CANVAS_INIT_W, CANVAS_INIT_H);
+			sceneManager.IndexEntity(ett, scene);
 			VmCamera* vmCam = sceneManager.CreateVmComp<VmCamera>(ett);
 
 			CameraComponent* camComponent = scene->cameras.GetComponent(ett);
@@ -2556,6 +3334,7 @@ namespace vzm
 		case COMPONENT_TYPE::LIGHT:
 		{
 			ett = scene->Entity_CreateLight(compName);// , XMFLOAT3(0, 3, 0), XMFLOAT3(1, 1, 1), 2, 60);
+			sceneManager.IndexEntity(ett, scene);
 			VmLight* vmLight = sceneManager.CreateVmComp<VmLight>(ett);
 			if (baseComp) *baseComp = vmLight;
 			break;
@@ -2563,6 +3342,7 @@ namespace vzm
 		case COMPONENT_TYPE::EMITTER:
 		{
 			ett = scene->Entity_CreateEmitter(compName);
+			sceneManager.IndexEntity(ett, scene);
 			VmEmitter* vmEmitter = sceneManager.CreateVmComp<VmEmitter>(ett);
 			if (baseComp) *baseComp = vmEmitter;
 			break;
@@ -2570,6 +3350,7 @@ namespace vzm
 		case COMPONENT_TYPE::MATERIAL:
 		{
 			ett = scene->Entity_CreateMaterial(compName);
+			sceneManager.IndexEntity(ett, scene);
 			VmMaterial* vmMat = sceneManager.CreateVmComp<VmMaterial>(ett);
 			if (baseComp) *baseComp = vmMat;
 			break;
@@ -2577,6 +3358,7 @@ namespace vzm
 		case COMPONENT_TYPE::COLLIDER:
 		{
 			ett = CreateEntity();
+			sceneManager.IndexEntity(ett, scene);
 			scene->names.Create(ett) = compName;
 			scene->colliders.Create(ett);
 			scene->transforms.Create(ett);
@@ -2587,6 +3369,7 @@ namespace vzm
 		case COMPONENT_TYPE::WEATHER:
 		{
 			ett = CreateEntity();
+			sceneManager.IndexEntity(ett, scene);
 			scene->names.Create(ett) = compName;
 			scene->weathers.Create(ett);
 			VmWeather* vmWeather = sceneManager.CreateVmComp<VmWeather>(ett);
@@ -2597,6 +3380,7 @@ namespace vzm
 		default:
 			return INVALID_ENTITY;
 		}
+		scene->OnNameCreated(ett);
 		MoveToParent(ett, parentVid, scene);
 		return ett;
 	}
@@ -2608,28 +3392,15 @@ namespace vzm
 		{
 			if (hierarchy->parentID == parentVid)
 			{
-				auto scenes = sceneManager.GetScenes();
-				for (auto it = scenes->begin(); it != scenes->end(); it++)
-				{
-					VzmScene* scene = &it->second;
-					if (scene->hierarchy.GetComponent(vid))
-					{
-						return scene->sceneVid;
-					}
-				}
-				assert("There must be a scene containing the hierarchy entity");
+				return sceneManager.GetOwnerScene(vid)->sceneVid;
 			}
 		}
 
-		auto scenes = sceneManager.GetScenes();
-		bool ret = false;
-		for (auto it = scenes->begin(); it != scenes->end(); it++)
+		// the hierarchy is created in the scene of the parent
+		VzmScene* scene = sceneManager.GetOwnerScene(parentVid);
+		if (scene && MoveToParent(vid, parentVid, scene))
 		{
-			VzmScene* scene = &it->second;
-			if (MoveToParent(vid, parentVid, scene))
-			{
-				return scene->sceneVid;
-			}
+			return scene->sceneVid;
 		}
 		return INVALID_VID;
 	}
@@ -2680,57 +3451,29 @@ namespace vzm
 		return &scene->vmWeather;
 	}
 
-	void LoadFileIntoNewSceneAsync(const std::string& file, const std::string& rootName, const std::string& sceneName, const std::function<void(VID sceneVid, VID rootVid)>& callback)
+	LoadTicket LoadFileIntoNewSceneAsync(const std::string& file, const std::string& rootName, const std::string& sceneName, const std::function<void(VID sceneVid, VID rootVid)>& callback)
 	{
-		struct loadingJob
+		if (filetypes.find(wi::helper::toUpper(wi::helper::GetExtensionFromFileName(file))) == filetypes.end())
 		{
-			wi::Timer timer;
-			wi::jobsystem::context ctx;
-			// input param
-			std::string rootName;
-			std::string sceneName;
-			std::string file;
-			std::function<void(VID sceneVid, VID rootVid)> callback;
-
-			bool isFinished = false;
-		};
-
-		static uint32_t jobIndex = 0;
-		static std::map<uint32_t, loadingJob> loadingJobStore;
-		bool isBusy = false;
-		for (auto& it : loadingJobStore)
-		{
-			if (!it.second.isFinished)
-			{
-				isBusy = true;
-				break;
-			}
-		}
-		if (!isBusy)
-		{
-			loadingJobStore.clear();
-			jobIndex = 0;
+			wi::backlog::post("Not supported file type: " + file, backlog::LogLevel::Error);
+			return INVALID_TICKET;
 		}
+		return asyncLoader.Submit(file, rootName, sceneName, callback);
+	}
 
-		loadingJob& jobInfo = loadingJobStore[jobIndex++];
-		jobInfo.file = file;
-		jobInfo.rootName = rootName;
-		jobInfo.sceneName = sceneName;
-		jobInfo.callback = callback;
+	bool GetLoadProgress(const LoadTicket ticket, LoadProgress& progress)
+	{
+		return asyncLoader.GetProgress(ticket, progress);
+	}
 
-		wi::backlog::post("");
-		wi::jobsystem::Execute(jobInfo.ctx, [&](wi::jobsystem::JobArgs args) {
-			VID rootVid = INVALID_VID;
-			VID sceneVid = LoadFileIntoNewScene(jobInfo.file, jobInfo.rootName, jobInfo.sceneName, &rootVid);
-			if (jobInfo.callback != nullptr)
-			{
-				jobInfo.callback(sceneVid, rootVid);
-			}
-			});
-		std::thread([&jobInfo] {
-			wi::jobsystem::Wait(jobInfo.ctx);
-			wi::backlog::post("\n[vzm::LoadMeshModelAsync] GLTF Loading (" + std::to_string((int)std::round(jobInfo.timer.elapsed())) + " ms)");
-			}).detach();
+	bool CancelLoad(const LoadTicket ticket)
+	{
+		return asyncLoader.Cancel(ticket);
+	}
+
+	VZRESULT WaitLoad(const LoadTicket ticket, VID* sceneVid, VID* rootVid)
+	{
+		return asyncLoader.Wait(ticket, sceneVid, rootVid);
 	}
 
 	VID LoadFileIntoNewScene(const std::string& file, const std::string& rootName, const std::string& sceneName, VID* rootVid)
@@ -2742,38 +3485,241 @@ namespace vzm
 			return INVALID_ENTITY;
 		}
 
-		Entity rootEntity = INVALID_ENTITY;
 		// loading.. with file
+		Entity rootEntity = ImportModelFile(file, *scene, nullptr);
+		if (rootEntity == INVALID_ENTITY)
+		{
+			return INVALID_ENTITY;
+		}
+		scene->SetEntityName(rootEntity, rootName);
 
-		std::string extension = wi::helper::toUpper(wi::helper::GetExtensionFromFileName(file));
-		FileType type = FileType::INVALID;
-		auto it = filetypes.find(extension);
-		if (it != filetypes.end())
+		if (rootVid) *rootVid = rootEntity;
+
+		return sid;
+	}
+
+#pragma region // scene cache
+	// The scene cache is a wi::Archive made of chunks, every chunk starts with its id and the jump position of its end:
+	//	HEADER : magic, cache version, size and hash of the source file
+	//	SCENE : the scene with its embedded resources and precomputed mesh data (BVH, meshlets)
+	//	ROOT : index of the root entity within the transform components
+	//	END : terminates the chunk list
+	static constexpr uint64_t SCENE_CACHE_MAGIC = wi::helper::string_hash("VZM_SCENE_CACHE");
+	// increment this when the content of the chunks changes, the old caches are treated as stale
+	static constexpr uint32_t SCENE_CACHE_VERSION = 1;
+	enum class SCENE_CACHE_CHUNK : uint32_t
+	{
+		END,
+		HEADER,
+		SCENE,
+		ROOT,
+	};
+
+	// 64-bit FNV-1a over 8-byte words (the tail is hashed bytewise)
+	static bool HashSourceFile(const std::string& file, uint64_t& hash, uint64_t& size)
+	{
+		wi::helper::MappedFile mapped;
+		wi::vector<uint8_t> filedata;
+		const uint8_t* data = nullptr;
+		if (wi::helper::FileMap(file, mapped))
 		{
-			type = it->second;
+			data = mapped.data;
+			size = mapped.size;
 		}
-		if (type == FileType::INVALID)
-			return INVALID_ENTITY;
+		else if (wi::helper::FileRead(file, filedata))
+		{
+			data = filedata.data();
+			size = filedata.size();
+		}
+		else
+		{
+			return false;
+		}
+
+		constexpr uint64_t prime = 0x00000100000001b3ull;
+		hash = 0xcbf29ce484222325ull;
+		const size_t word_count = size / sizeof(uint64_t);
+		for (size_t i = 0; i < word_count; ++i)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+			hash = (hash ^ word) * prime;
+		}
+		for (size_t i = word_count * sizeof(uint64_t); i < size; ++i)
+		{
+			hash = (hash ^ data[i]) * prime;
+		}
+		return true;
+	}
 
-		if (type == FileType::OBJ) // wavefront-obj
+	VZRESULT SaveSceneCache(const VID sceneVid, const VID rootVid, const std::string& cacheFile, const std::string& sourceFile)
+	{
+		VzmScene* scene = sceneManager.GetScene(sceneVid);
+		if (scene == nullptr)
 		{
-			rootEntity = ImportModel_OBJ(file, *scene);	// reassign transform components
+			wi::backlog::post("Invalid Scene", wi::backlog::LogLevel::Error);
+			return VZ_FAIL;
 		}
-		else if (type == FileType::GLTF || type == FileType::GLB || type == FileType::VRM) // gltf, vrm
+
+		uint64_t source_hash = 0;
+		uint64_t source_size = 0;
+		if (!sourceFile.empty() && !HashSourceFile(sourceFile, source_hash, source_size))
 		{
-			rootEntity = ImportModel_GLTF(file, *scene);
+			wi::backlog::post("[vzm::SaveSceneCache] source file can't be read: " + sourceFile, backlog::LogLevel::Error);
+			return VZ_FAIL;
 		}
-		scene->names.GetComponent(rootEntity)->name = rootName;
 
+		wi::Timer timer;
+		wi::Archive archive;
+		auto write_chunk = [&archive](SCENE_CACHE_CHUNK id, const std::function<void()>& write) {
+			archive << (uint32_t)id;
+			size_t jump = archive.WriteUnknownJumpPosition();
+			write();
+			archive.PatchUnknownJumpPosition(jump);
+		};
+
+		write_chunk(SCENE_CACHE_CHUNK::HEADER, [&] {
+			archive << SCENE_CACHE_MAGIC;
+			archive << SCENE_CACHE_VERSION;
+			archive << source_size;
+			archive << source_hash;
+		});
+		write_chunk(SCENE_CACHE_CHUNK::SCENE, [&] {
+			// the resource manager embeds the resource file datas only in EMBED_FILE_DATA mode
+			const wi::resourcemanager::Mode mode = wi::resourcemanager::GetMode();
+			wi::resourcemanager::SetMode(wi::resourcemanager::Mode::EMBED_FILE_DATA);
+			scene->Serialize(archive, true);
+			wi::resourcemanager::SetMode(mode);
+		});
+		write_chunk(SCENE_CACHE_CHUNK::ROOT, [&] {
+			archive << (uint64_t)scene->transforms.GetIndex(rootVid);
+		});
+		archive << (uint32_t)SCENE_CACHE_CHUNK::END;
+
+		if (!archive.SaveFile(cacheFile))
+		{
+			wi::backlog::post("[vzm::SaveSceneCache] cache file can't be written: " + cacheFile, backlog::LogLevel::Error);
+			return VZ_FAIL;
+		}
+		wi::backlog::post("[vzm::SaveSceneCache] " + cacheFile + " (" + std::to_string((int)std::round(timer.elapsed())) + " ms)");
+		return VZ_OK;
+	}
+
+	VID LoadSceneCache(const std::string& cacheFile, const std::string& sourceFile, const std::string& rootName, const std::string& sceneName, VID* rootVid)
+	{
+		wi::Timer timer;
+
+		// The archive reads the cache in place, so the mapping must outlive the scene serialization
+		wi::helper::MappedFile mapped;
+		wi::vector<uint8_t> filedata;
+		wi::Archive archive;
+		if (wi::helper::FileMap(cacheFile, mapped))
+		{
+			archive = wi::Archive(mapped.data, mapped.size);
+		}
+		else if (wi::helper::FileRead(cacheFile, filedata))
+		{
+			archive = wi::Archive(filedata.data(), filedata.size());
+		}
+		if (!archive.IsOpen() || !archive.IsReadMode())
+		{
+			return INVALID_VID;
+		}
+
+		uint64_t source_hash = 0;
+		uint64_t source_size = 0;
+		if (!sourceFile.empty() && !HashSourceFile(sourceFile, source_hash, source_size))
+		{
+			wi::backlog::post("[vzm::LoadSceneCache] source file can't be read: " + sourceFile, backlog::LogLevel::Error);
+			return INVALID_VID;
+		}
+
+		Scene cached_scene;
+		bool header_valid = false;
+		bool scene_loaded = false;
+		uint64_t root_index = ~0ull;
+		while (archive.GetPos() + sizeof(uint32_t) <= archive.GetSize())
+		{
+			uint32_t id = 0;
+			archive >> id;
+			if ((SCENE_CACHE_CHUNK)id == SCENE_CACHE_CHUNK::END)
+			{
+				break;
+			}
+			uint64_t chunk_end = 0;
+			archive >> chunk_end;
+			// a chunk can't end before its own header, otherwise a corrupted offset could jump back and loop forever
+			if (archive.IsReadFailed() || chunk_end > archive.GetSize() || chunk_end < archive.GetPos())
+			{
+				break;
+			}
+
+			switch ((SCENE_CACHE_CHUNK)id)
+			{
+			case SCENE_CACHE_CHUNK::HEADER:
+			{
+				uint64_t magic = 0;
+				uint32_t version = 0;
+				uint64_t cached_size = 0;
+				uint64_t cached_hash = 0;
+				archive >> magic;
+				archive >> version;
+				archive >> cached_size;
+				archive >> cached_hash;
+				header_valid = magic == SCENE_CACHE_MAGIC && version == SCENE_CACHE_VERSION &&
+					(sourceFile.empty() || (cached_size == source_size && cached_hash == source_hash));
+				break;
+			}
+			case SCENE_CACHE_CHUNK::SCENE:
+				if (header_valid)
+				{
+					cached_scene.Serialize(archive);
+					// a truncated cache leaves the scene partially read, it is discarded so the caller imports the source file
+					scene_loaded = !archive.IsReadFailed();
+				}
+				break;
+			case SCENE_CACHE_CHUNK::ROOT:
+				archive >> root_index;
+				break;
+			default:
+				break;
+			}
+			if (!header_valid || archive.IsReadFailed())
+			{
+				break;
+			}
+			archive.Jump(chunk_end);
+		}
+
+		if (!scene_loaded)
+		{
+			wi::backlog::post("[vzm::LoadSceneCache] stale or invalid cache: " + cacheFile, backlog::LogLevel::Warning);
+			return INVALID_VID;
+		}
+
+		Entity rootEntity = root_index < cached_scene.transforms.GetCount() ? cached_scene.transforms.GetEntity(root_index) : INVALID_ENTITY;
+
+		VID sid = sceneManager.CreateSceneEntity(sceneName);
+		VzmScene* scene = sceneManager.GetScene(sid);
+		if (scene == nullptr)
+		{
+			return INVALID_VID;
+		}
+		sceneManager.IndexSceneEntities(cached_scene, scene);
+		scene->Merge(cached_scene);
+
+		scene->SetEntityName(rootEntity, rootName);
 		if (rootVid) *rootVid = rootEntity;
 
+		wi::backlog::post("[vzm::LoadSceneCache] " + cacheFile + " (" + std::to_string((int)std::round(timer.elapsed())) + " ms)");
 		return sid;
 	}
+#pragma endregion
 
 	VZRESULT MergeScenes(const VID srcSceneVid, const VID dstSceneVid)
 	{
 		Scene* srcScene = sceneManager.GetScene(srcSceneVid);
-		Scene* dstScene = sceneManager.GetScene(dstSceneVid);
+		VzmScene* dstScene = sceneManager.GetScene(dstSceneVid);
 		if (srcScene == nullptr || dstScene == nullptr)
 		{
 			wi::backlog::post("Invalid Scene", wi::backlog::LogLevel::Error);
@@ -2795,6 +3741,7 @@ namespace vzm
 		wi::vector<Entity> meshEntities = srcScene->meshes.GetEntityArray();
 		wi::vector<Entity> materialEntities = srcScene->materials.GetEntityArray();
 
+		sceneManager.IndexSceneEntities(*srcScene, dstScene);
 		dstScene->Merge(*srcScene);
 
 		for (Entity& ett : camEntities)
@@ -2814,45 +3761,18 @@ namespace vzm
 		}
 
 		// actors
-		{
-			for (Entity& ett : aniEntities)
-			{
-				sceneManager.CreateVmComp<VmAnimation>(ett);
-			}
-			for (Entity& ett : objEntities)
-			{
-				sceneManager.CreateVmComp<VmActor>(ett);
-			}
-			for (Entity& ett : lightEntities)
-			{
-				sceneManager.CreateVmComp<VmLight>(ett);
-			}
-			for (Entity& ett : emitterEntities)
-			{
-				sceneManager.CreateVmComp<VmEmitter>(ett);
-			}
-		}
+		sceneManager.CreateVmComps<VmAnimation>(aniEntities.data(), aniEntities.size(), dstScene);
+		sceneManager.CreateVmComps<VmActor>(objEntities.data(), objEntities.size(), dstScene);
+		sceneManager.CreateVmComps<VmLight>(lightEntities.data(), lightEntities.size(), dstScene);
+		sceneManager.CreateVmComps<VmEmitter>(emitterEntities.data(), emitterEntities.size(), dstScene);
 
-		// must be posterior to actors
-		for (Entity& ett : transformEntities)
-		{
-			if (!sceneManager.GetVmComp<VmBaseComponent>(ett))
-			{
-				sceneManager.CreateVmComp<VmBaseComponent>(ett);
-			}
-		}
+		// must be posterior to actors (the entities having VmComponents are skipped)
+		sceneManager.CreateVmComps<VmBaseComponent>(transformEntities.data(), transformEntities.size(), dstScene);
 
 		// resources
-		{
-			for (Entity& ett : meshEntities)
-			{
-				sceneManager.CreateVmComp<VmMesh>(ett);
-			}
-			for (Entity& ett : materialEntities)
-			{
-				sceneManager.CreateVmComp<VmMaterial>(ett);
-			}
-		}
+		sceneManager.CreateVmComps<VmMesh>(meshEntities.data(), meshEntities.size(), dstScene);
+		sceneManager.CreateVmComps<VmMaterial>(materialEntities.data(), materialEntities.size(), dstScene);
+
 		//static Scene scene_resPool;
 		//scene_resPool.meshes.Merge(dstScene->meshes);
 		//scene_resPool.Update(0);
@@ -2860,40 +3780,10 @@ namespace vzm
 		return VZ_OK;
 	}
 
-	VZRESULT Render(const VID camVid, const bool updateScene)
+	// Per-camera part of a frame: timing, (fixed) update, culling, render and compose
+	//  - the scene's deltaTime must be already updated by the caller
+	static void RenderFrame(VzmRenderer* renderer, VzmScene* scene)
 	{
-		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
-		if (renderer == nullptr)
-		{
-			return VZ_FAIL;
-		}
-
-		wi::font::UpdateAtlas(renderer->GetDPIScaling());
-
-		renderer->UpdateVmCamera();
-
-		// DOJO TO DO : CHECK updateScene across cameras belonging to a scene and force to use a oldest one...
-		renderer->setSceneUpdateEnabled(updateScene || renderer->FRAMECOUNT == 0);
-		if (!updateScene)
-		{
-			renderer->scene->camera = *renderer->camera;
-		}
-
-		if (!wi::initializer::IsInitializeFinished())
-		{
-			// Until engine is not loaded, present initialization screen...
-			renderer->WaitRender();
-			return VZ_JOB_WAIT;
-		}
-
-		if (profileFrameFinished)
-		{
-			profileFrameFinished = false;
-			wi::profiler::BeginFrame();
-		}
-
-		VzmScene* scene = (VzmScene*)renderer->scene;
-
 		{
 			// for frame info.
 			renderer->deltaTime = float(std::max(0.0, renderer->timer.record_elapsed_seconds()));
@@ -2903,14 +3793,8 @@ namespace vzm
 				wi::helper::QuickSleep((target_deltaTime - renderer->deltaTime) * 1000);
 				renderer->deltaTime += float(std::max(0.0, renderer->timer.record_elapsed_seconds()));
 			}
-
-			scene->deltaTime = float(std::max(0.0, scene->timer.record_elapsed_seconds()));
 		}
 
-
-		//wi::input::Update(nullptr, *renderer);
-		// Wake up the events that need to be executed on the main thread, in thread safe manner:
-		wi::eventhandler::FireEvent(wi::eventhandler::EVENT_THREAD_SAFE_POINT, 0);
 		renderer->fadeManager.Update(renderer->deltaTime);
 
 		renderer->PreUpdate(); // current to previous
@@ -2965,10 +3849,286 @@ namespace vzm
 			wi::profiler::EndRange(range); // Render
 		}
 		renderer->RenderFinalize();
+	}
+
+	VZRESULT Render(const VID camVid, const bool updateScene)
+	{
+		asyncLoader.CommitFinished();
+
+		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
+		if (renderer == nullptr)
+		{
+			return VZ_FAIL;
+		}
+
+		wi::font::UpdateAtlas(renderer->GetDPIScaling());
+
+		renderer->UpdateVmCamera();
+
+		// note: use RenderCameras() for multiple cameras belonging to a scene, which updates the scene once
+		renderer->setSceneUpdateEnabled(updateScene || renderer->FRAMECOUNT == 0);
+		if (!updateScene)
+		{
+			renderer->scene->camera = *renderer->camera;
+		}
+
+		if (!wi::initializer::IsInitializeFinished())
+		{
+			// Until engine is not loaded, present initialization screen...
+			renderer->WaitRender();
+			return VZ_JOB_WAIT;
+		}
+
+		if (profileFrameFinished)
+		{
+			profileFrameFinished = false;
+			wi::profiler::BeginFrame();
+		}
+
+		VzmScene* scene = (VzmScene*)renderer->scene;
+		scene->deltaTime = float(std::max(0.0, scene->timer.record_elapsed_seconds()));
+
+		//wi::input::Update(nullptr, *renderer);
+		// Wake up the events that need to be executed on the main thread, in thread safe manner:
+		wi::eventhandler::FireEvent(wi::eventhandler::EVENT_THREAD_SAFE_POINT, 0);
+
+		RenderFrame(renderer, scene);
 
 		return VZ_OK;
 	}
 
+	void EnableProfiling(const bool enabled)
+	{
+		wi::profiler::SetEnabled(enabled);
+	}
+
+	VZRESULT DumpProfileTrace(const std::string& path, const uint32_t frameCount)
+	{
+		if (!wi::profiler::IsEnabled())
+		{
+			wi::backlog::post("DumpProfileTrace requires profiling to be enabled (EnableProfiling or DisplayEngineProfiling)", backlog::LogLevel::Warning);
+			return VZ_FAIL;
+		}
+		return wi::profiler::SaveTrace(path, frameCount) ? VZ_OK : VZ_FAIL;
+	}
+
+	VZRESULT RenderToMemory(const VID camVid, std::vector<uint8_t>& rgba8, uint32_t* w, uint32_t* h)
+	{
+		VZRESULT result = Render(camVid, true);
+		if (result != VZ_OK)
+		{
+			return result;
+		}
+
+		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
+		const wi::graphics::Texture& renderResult = renderer->renderResult;
+		if (!renderResult.IsValid())
+		{
+			wi::backlog::post("RenderToMemory requires a renderer without a swap chain!", backlog::LogLevel::Error);
+			return VZ_FAIL;
+		}
+
+		// saveTextureToMemory copies the render target into a readback buffer and waits for the GPU
+		wi::vector<uint8_t> texturedata;
+		if (!wi::helper::saveTextureToMemory(renderResult, texturedata))
+		{
+			return VZ_FAIL;
+		}
+
+		const wi::graphics::TextureDesc& desc = renderResult.desc;
+		if (w) *w = desc.width;
+		if (h) *h = desc.height;
+
+		const size_t pixel_count = (size_t)desc.width * (size_t)desc.height;
+		rgba8.resize(pixel_count * 4);
+		const uint32_t* data32 = (const uint32_t*)texturedata.data();
+		uint32_t* dst32 = (uint32_t*)rgba8.data();
+		if (desc.format == wi::graphics::Format::R10G10B10A2_UNORM)
+		{
+			for (size_t i = 0; i < pixel_count; ++i)
+			{
+				uint32_t pixel = data32[i];
+				uint32_t r = ((pixel >> 0) & 1023) >> 2;
+				uint32_t g = ((pixel >> 10) & 1023) >> 2;
+				uint32_t b = ((pixel >> 20) & 1023) >> 2;
+				uint32_t a = ((pixel >> 30) & 3) * 85;
+				dst32[i] = r | (g << 8) | (b << 16) | (a << 24);
+			}
+		}
+		else
+		{
+			assert(wi::graphics::GetFormatStride(desc.format) == 4);
+			std::memcpy(dst32, data32, pixel_count * sizeof(uint32_t));
+		}
+
+		return VZ_OK;
+	}
+
+	VZRESULT RenderCameras(const VID* camVids, const size_t count)
+	{
+		asyncLoader.CommitFinished();
+
+		if (camVids == nullptr || count == 0)
+		{
+			return VZ_FAIL;
+		}
+
+		// group the cameras by their scenes (keeping the input order)
+		std::vector<std::pair<VzmScene*, std::vector<VzmRenderer*>>> sceneGroups;
+		for (size_t i = 0; i < count; ++i)
+		{
+			VzmRenderer* renderer = sceneManager.GetRenderer(camVids[i]);
+			if (renderer == nullptr)
+			{
+				wi::backlog::post("Invalid camera VID (" + std::to_string(camVids[i]) + ")", backlog::LogLevel::Error);
+				return VZ_FAIL;
+			}
+
+			wi::font::UpdateAtlas(renderer->GetDPIScaling());
+			renderer->UpdateVmCamera();
+
+			VzmScene* scene = (VzmScene*)renderer->scene;
+			auto it = std::find_if(sceneGroups.begin(), sceneGroups.end(), [scene](const auto& group) { return group.first == scene; });
+			if (it == sceneGroups.end())
+			{
+				sceneGroups.push_back({ scene, {} });
+				it = sceneGroups.end() - 1;
+			}
+			if (std::find(it->second.begin(), it->second.end(), renderer) == it->second.end())
+			{
+				it->second.push_back(renderer);
+			}
+		}
+
+		if (!wi::initializer::IsInitializeFinished())
+		{
+			// Until engine is not loaded, present initialization screen...
+			for (auto& group : sceneGroups)
+			{
+				for (VzmRenderer* renderer : group.second)
+				{
+					renderer->WaitRender();
+				}
+			}
+			return VZ_JOB_WAIT;
+		}
+
+		if (profileFrameFinished)
+		{
+			profileFrameFinished = false;
+			wi::profiler::BeginFrame();
+		}
+
+		// Wake up the events that need to be executed on the main thread, in thread safe manner:
+		wi::eventhandler::FireEvent(wi::eventhandler::EVENT_THREAD_SAFE_POINT, 0);
+
+		for (auto& group : sceneGroups)
+		{
+			VzmScene* scene = group.first;
+			scene->deltaTime = float(std::max(0.0, scene->timer.record_elapsed_seconds()));
+
+			// the first camera of the scene is used for the camera-dependent scene updates
+			VzmRenderer* sceneUpdater = group.second.front();
+			for (VzmRenderer* renderer : group.second)
+			{
+				renderer->setSceneUpdateEnabled(renderer == sceneUpdater);
+				renderer->setSceneUpdateExternal(true);
+			}
+
+			{
+				auto range = wi::profiler::BeginRangeCPU("Scene Update");
+				sceneUpdater->UpdateRendererOptions();
+				sceneUpdater->UpdateScene(scene->deltaTime);
+				wi::profiler::EndRange(range); // Scene Update
+			}
+
+			// note: the cameras are rendered one after another since wi::renderer options and per-frame resources (e.g., shadow atlas) are global,
+			//	each RenderPath3D::Render() records its own passes on parallel jobs
+			for (VzmRenderer* renderer : group.second)
+			{
+				RenderFrame(renderer, scene);
+				renderer->setSceneUpdateExternal(false);
+			}
+		}
+
+		return VZ_OK;
+	}
+
+	RenderTicket RenderAsync(const VID camVid, const bool updateScene)
+	{
+		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
+		if (renderer == nullptr)
+		{
+			return INVALID_TICKET;
+		}
+		// the frame is recorded like Render(), only its render target is taken from the ring of renderResults
+		renderer->asyncRender = true;
+		const VZRESULT result = Render(camVid, updateScene);
+		renderer->asyncRender = false;
+		if (result == VZ_FAIL)
+		{
+			return INVALID_TICKET;
+		}
+		return renderer->lastTicket;
+	}
+
+	bool IsRenderComplete(const RenderTicket ticket)
+	{
+		wi::graphics::GraphicsDevice* graphicsDevice = wi::graphics::GetDevice();
+		if (graphicsDevice == nullptr || ticket == INVALID_TICKET)
+		{
+			return false;
+		}
+		return graphicsDevice->IsFrameCompleted(ticket - 1);
+	}
+
+	VZRESULT WaitRender(const RenderTicket ticket)
+	{
+		wi::graphics::GraphicsDevice* graphicsDevice = wi::graphics::GetDevice();
+		if (graphicsDevice == nullptr || ticket == INVALID_TICKET || ticket > graphicsDevice->GetFrameCount())
+		{
+			return VZ_FAIL;
+		}
+		graphicsDevice->WaitFrame(ticket - 1);
+		return VZ_OK;
+	}
+
+	VZRESULT PickPixels(const VID camVid, const float* pixels, const size_t count, std::vector<PickResult>& results)
+	{
+		results.clear();
+		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
+		if (renderer == nullptr || (count > 0 && pixels == nullptr))
+		{
+			return VZ_FAIL;
+		}
+		renderer->UpdateVmCamera();
+
+		const CameraComponent& camera = *renderer->camera;
+		wi::vector<wi::primitive::Ray> rays(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			rays[i] = wi::renderer::GetPickRay(pixels[i * 2 + 0], pixels[i * 2 + 1], *renderer, camera);
+		}
+
+		wi::vector<Scene::RayIntersectionResult> hits(count);
+		renderer->scene->IntersectsBatch(rays.data(), count, hits.data());
+
+		results.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Scene::RayIntersectionResult& hit = hits[i];
+			PickResult& result = results[i];
+			if (hit.entity == INVALID_ENTITY)
+				continue;
+			result.vid = hit.entity;
+			*(XMFLOAT3*)result.position = hit.position;
+			*(XMFLOAT3*)result.normal = hit.normal;
+			result.distance = hit.distance;
+			result.subsetIndex = hit.subsetIndex;
+		}
+		return VZ_OK;
+	}
+
 	void ReloadShader()
 	{
 		wi::renderer::ReloadShaders();
@@ -3056,6 +4216,31 @@ namespace vzm
 		//return graphicsDevice->OpenSharedResource(graphicsDev2, &renderer->rtPostprocess);
 		return graphicsDevice->OpenSharedResource(graphicsDev2, srv_desc_heap2, descriptor_index, const_cast<wi::graphics::Texture*>(&renderer->renderResult));
 	}
+
+	void* GetGraphicsSharedRenderTargetByTicket(const int camVid, const RenderTicket ticket, const void* graphicsDev2, const void* srv_desc_heap2, const int descriptor_index, uint32_t* w, uint32_t* h, uint32_t* bufferIndex)
+	{
+		VzmRenderer* renderer = sceneManager.GetRenderer(camVid);
+		if (renderer == nullptr)
+		{
+			return nullptr;
+		}
+
+		const int index = renderer->GetTicketRenderResultIndex(ticket);
+		if (index < 0)
+		{
+			return nullptr;
+		}
+		wi::graphics::Texture& renderResult = renderer->renderResults[index];
+
+		if (w) *w = renderResult.desc.width;
+		if (h) *h = renderResult.desc.height;
+		if (bufferIndex) *bufferIndex = (uint32_t)index;
+
+		wi::graphics::GraphicsDevice* graphicsDevice = wi::graphics::GetDevice();
+		if (graphicsDevice == nullptr) return nullptr;
+		// every buffer has its own descriptor, so the shared resources are opened once and the host never sees its views rewritten
+		return graphicsDevice->OpenSharedResource(graphicsDev2, srv_desc_heap2, descriptor_index + index, &renderResult);
+	}
 }
 
 #include "vzArcBall.h"
@@ -7,13 +7,23 @@ namespace vzm
 {
 	// This must be called before using engine APIs
 	//  - paired with DeinitEngineLib()
+	//  - the graphics device of a host Wicked Engine application is shared if it was already created
+	//  - "headless" command line argument enables the headless mode (see InitEngineLibHeadless)
 	extern "C" API_EXPORT VZRESULT InitEngineLib(const std::string& coreName = "VzmEngine", const std::string& logFileName = "EngineApi.log");
+	// Headless version of InitEngineLib
+	//  - the device is created without a window or shared render targets (e.g., Vulkan on a software ICD like lavapipe)
+	//     and the render results are read with RenderToMemory()
+	extern "C" API_EXPORT VZRESULT InitEngineLibHeadless(const std::string& coreName = "VzmEngine", const std::string& logFileName = "EngineApi.log");
 	// Get Entity ID 
 	//  - return zero in case of failure 
 	extern "C" API_EXPORT VID GetFirstVidByName(const std::string& name);
 	// Get Entity IDs whose name is the input name (VID is allowed for redundant name)
 	//  - return # of entities
 	extern "C" API_EXPORT size_t GetVidsByName(const std::string& name, std::vector<VID>& vids);
+	// Get Entity IDs whose name matches the pattern, '*' matches any sequence and '?' matches a single character
+	//  - e.g., prefix query: "wheel_*"
+	//  - return # of entities
+	extern "C" API_EXPORT size_t GetVidsByNamePattern(const std::string& pattern, std::vector<VID>& vids);
 	// Get Entity's name if possible
 	//  - return name string if entity's name exists, if not, return "" 
 	extern "C" API_EXPORT bool GetNameByVid(const VID vid, std::string& name);
@@ -43,7 +53,30 @@ namespace vzm
 	//  - return zero in case of failure
 	extern "C" API_EXPORT VID LoadFileIntoNewScene(const std::string& file, const std::string& rootName, const std::string& sceneName = "", VID* rootVid = nullptr);
 	// Async version of LoadFileIntoNewScene
-	extern "C" API_EXPORT void LoadFileIntoNewSceneAsync(const std::string& file, const std::string& rootName, const std::string& sceneName = "", const std::function<void(VID sceneVid, VID rootVid)>& callback = nullptr);
+	//  - return a ticket of the load (INVALID_TICKET in case of failure)
+	//  - files are imported by the low priority job threads, so many loads can be queued without spawning a thread per load
+	//  - the loaded scene is registered (and the callback is called) by the thread calling vzm APIs,
+	//     i.e., within Render/RenderCameras/RenderAsync/GetLoadProgress/WaitLoad
+	extern "C" API_EXPORT LoadTicket LoadFileIntoNewSceneAsync(const std::string& file, const std::string& rootName, const std::string& sceneName = "", const std::function<void(VID sceneVid, VID rootVid)>& callback = nullptr);
+	// Get the progress of the load (non-blocking)
+	//  - return false if the ticket is invalid
+	//  - the final progress of a finished load is kept until it is waited, at most for the 256 latest finished loads
+	extern "C" API_EXPORT bool GetLoadProgress(const LoadTicket ticket, LoadProgress& progress);
+	// Cancel the load, the importer stops at its next checkpoint and the loaded data are discarded
+	//  - return false if the ticket is invalid or the load is already finished
+	extern "C" API_EXPORT bool CancelLoad(const LoadTicket ticket);
+	// Wait until the load is finished (or cancelled) and release the ticket
+	//  - return VZ_OK if the scene is registered
+	extern "C" API_EXPORT VZRESULT WaitLoad(const LoadTicket ticket, VID* sceneVid = nullptr, VID* rootVid = nullptr);
+	// Save a scene into a binary cache file that can be loaded much faster than the source file
+	//  - the resources (textures) are embedded and the mesh BVHs and meshlets are stored precomputed
+	//  - sourceFile is hashed into the cache so that LoadSceneCache can detect a stale cache (it can be empty to skip the check)
+	//  - the cache depends on the engine build (data layouts), it is not meant to be distributed
+	extern "C" API_EXPORT VZRESULT SaveSceneCache(const VID sceneVid, const VID rootVid, const std::string& cacheFile, const std::string& sourceFile = "");
+	// Load a scene cache written by SaveSceneCache into a new scene and return the scene ID
+	//  - return zero if the cache is missing, truncated, stale (sourceFile changed) or written by another cache version,
+	//     the caller is expected to load the source file and save the cache again in that case
+	extern "C" API_EXPORT VID LoadSceneCache(const std::string& cacheFile, const std::string& sourceFile, const std::string& rootName, const std::string& sceneName = "", VID* rootVid = nullptr);
 	// Merge src scene to dest scene 
 	//  - This is not THREAD-SAFE 
 	extern "C" API_EXPORT VZRESULT MergeScenes(const VID srcSceneVid, const VID dstSceneVid);
@@ -52,12 +85,51 @@ namespace vzm
 	//  - if updateScene is true, uses the camera for camera-dependent scene updates
 	//  - strongly recommend a single camera-dependent update per a scene 
 	extern "C" API_EXPORT VZRESULT Render(const VID camVid, const bool updateScene = true);
+	// Render a scene on camera (camVid) and read back the render result
+	//  - rgba8 receives width * height RGBA8 pixels (row-major, top row first)
+	//  - blocks until the GPU finishes the frame, intended for headless image tests and thumbnails
+	//  - return VZ_JOB_WAIT while the engine is initializing
+	extern "C" API_EXPORT VZRESULT RenderToMemory(const VID camVid, std::vector<uint8_t>& rgba8, uint32_t* w = nullptr, uint32_t* h = nullptr);
+	// Render multiple cameras (camVids) in a batch
+	//  - Must belong to the internal scene
+	//  - cameras are grouped by their scenes and each scene is updated once per call
+	//  - the first camera of each scene is used for camera-dependent scene updates
+	extern "C" API_EXPORT VZRESULT RenderCameras(const VID* camVids, const size_t count);
+	// Number of render targets that RenderAsync cycles per camera
+	inline constexpr uint32_t RENDER_RESULT_BUFFER_COUNT = 3;
+	// Render version whose GPU work can be waited later
+	//  - the frame is recorded and submitted synchronously on the calling thread like Render(), only the GPU execution is asynchronous
+	//  - return a ticket of the submitted frame (INVALID_TICKET in case of failure)
+	//  - the frame is rendered into one of RENDER_RESULT_BUFFER_COUNT render targets of the camera (not the one of Render),
+	//     the next renders do not overwrite the ticket's render target until it is recycled
+	extern "C" API_EXPORT RenderTicket RenderAsync(const VID camVid, const bool updateScene = true);
+	// Check whether the GPU finished the frame of the ticket (non-blocking)
+	extern "C" API_EXPORT bool IsRenderComplete(const RenderTicket ticket);
+	// Wait until the GPU finishes the frame of the ticket
+	extern "C" API_EXPORT VZRESULT WaitRender(const RenderTicket ticket);
 	// Get a graphics render target view 
 	//  - Must belong to the internal scene
+	//  - the view of the render target written by Render(), it stays the same until the camera's render target is resized
 	extern "C" API_EXPORT void* GetGraphicsSharedRenderTarget(const int camVid, const void* device2, const void* srv_desc_heap2, const int descriptor_index, uint32_t* w = nullptr, uint32_t* h = nullptr);
+	// Get a graphics render target view written by the ticket of RenderAsync
+	//  - return nullptr if the render target of the ticket is already recycled
+	//  - the host reserves RENDER_RESULT_BUFFER_COUNT descriptors from descriptor_index, buffer i uses descriptor_index + i
+	//     and its view is created once, bufferIndex receives the buffer of the ticket
+	extern "C" API_EXPORT void* GetGraphicsSharedRenderTargetByTicket(const int camVid, const RenderTicket ticket, const void* device2, const void* srv_desc_heap2, const int descriptor_index, uint32_t* w = nullptr, uint32_t* h = nullptr, uint32_t* bufferIndex = nullptr);
+	// Pick the scene surfaces under screen-space pixels of a camera (camVid)
+	//  - pixels are (x, y) pairs in the logical coordinates of the camera's render target, count is the number of pairs
+	//  - rays are traced in parallel against the scene's current state (the last scene update)
+	//  - results[i] receives the closest hit of the i-th pixel
+	extern "C" API_EXPORT VZRESULT PickPixels(const VID camVid, const float* pixels, const size_t count, std::vector<PickResult>& results);
 	// Reload shaders
 	extern "C" API_EXPORT void ReloadShader();
 
+	// Enable/disable collecting profiling data, it takes effect from the next frame
+	extern "C" API_EXPORT void EnableProfiling(const bool enabled);
+	// Write the CPU/GPU profiling timeline of the last frameCount frames as a Chrome trace JSON (chrome://tracing or ui.perfetto.dev)
+	//  - profiling must be enabled (EnableProfiling or DisplayEngineProfiling)
+	//  - should be called between frames (not during Render of other threads)
+	extern "C" API_EXPORT VZRESULT DumpProfileTrace(const std::string& path, const uint32_t frameCount = 60);
 	// Display Engine's states and profiling information
 	//  - return canvas VID (use this as a camVid)
 	extern "C" API_EXPORT VID DisplayEngineProfiling(const int w, const int h, const bool displayProfile = true, const bool displayEngineStates = true);
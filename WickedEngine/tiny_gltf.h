@@ -1054,6 +1054,15 @@ class Node {
 struct Buffer {
   std::string name;
   std::vector<unsigned char> data;
+  // Non-owning view of the GLB binary chunk when
+  // TinyGLTF::SetBinaryChunkInPlace is enabled (`data` is empty then).
+  // The caller must keep the GLB memory alive while the buffer is used.
+  const unsigned char *in_place_data = nullptr;
+  size_t in_place_size = 0;
+
+  const unsigned char *GetData() const {
+    return data.empty() ? in_place_data : data.data();
+  }
   std::string
       uri;  // considered as required here but not in the spec (need to clarify)
             // uri is not decoded(e.g. whitespace may be represented as %20)
@@ -1402,6 +1411,15 @@ class TinyGLTF {
 
   bool GetPreserveImageChannels() const { return preserve_image_channels_; }
 
+  ///
+  /// Specify whether the GLB binary chunk is referred in place instead of
+  /// being copied to Buffer::data (see Buffer::in_place_data).
+  /// The memory passed to LoadBinaryFromMemory must outlive the Model then.
+  ///
+  void SetBinaryChunkInPlace(bool onoff) { bin_chunk_in_place_ = onoff; }
+
+  bool GetBinaryChunkInPlace() const { return bin_chunk_in_place_; }
+
  private:
   ///
   /// Loads glTF asset from string(memory).
@@ -1424,6 +1442,8 @@ class TinyGLTF {
   bool preserve_image_channels_ = false;  /// Default false(expand channels to
                                           /// RGBA) for backward compatibility.
 
+  bool bin_chunk_in_place_ = false;  /// Default false(copy the GLB binary chunk)
+
   // Warning & error messages 
   std::string warn_;
   std::string err_;
@@ -4024,7 +4044,7 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
                         FsCallbacks *fs, const std::string &basedir,
                         bool is_binary = false,
                         const unsigned char *bin_data = nullptr,
-                        size_t bin_size = 0) {
+                        size_t bin_size = 0, bool bin_in_place = false) {
   size_t byteLength;
   if (!ParseUnsignedProperty(&byteLength, err, o, "byteLength", true,
                              "Buffer")) {
@@ -4096,9 +4116,16 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
         return false;
       }
 
-      // Read buffer data
-      buffer->data.resize(static_cast<size_t>(byteLength));
-      memcpy(&(buffer->data.at(0)), bin_data, static_cast<size_t>(byteLength));
+      if (bin_in_place) {
+        // Refer to the binary data without copying it
+        buffer->in_place_data = bin_data;
+        buffer->in_place_size = static_cast<size_t>(byteLength);
+      } else {
+        // Read buffer data
+        buffer->data.resize(static_cast<size_t>(byteLength));
+        memcpy(&(buffer->data.at(0)), bin_data,
+               static_cast<size_t>(byteLength));
+      }
     }
 
   } else {
@@ -4495,7 +4522,7 @@ static bool ParseDracoExtension(Primitive *primitive, Model *model,
   view.dracoDecoded = true;
 
   const char *bufferViewData =
-      reinterpret_cast<const char *>(buffer.data.data() + view.byteOffset);
+      reinterpret_cast<const char *>(buffer.GetData() + view.byteOffset);
   size_t bufferViewSize = view.byteLength;
 
   // decode draco
@@ -5655,7 +5682,8 @@ bool TinyGLTF::LoadFromString(Model *model, std::string *err, std::string *warn,
       Buffer buffer;
       if (!ParseBuffer(&buffer, err, o,
                        store_original_json_for_extras_and_extensions_, &fs,
-                       base_dir, is_binary_, bin_data_, bin_size_)) {
+                       base_dir, is_binary_, bin_data_, bin_size_,
+                       bin_chunk_in_place_)) {
         return false;
       }
 
@@ -5956,7 +5984,7 @@ bool TinyGLTF::LoadFromString(Model *model, std::string *err, std::string *warn,
         }
         bool ret = LoadImageData(
             &image, idx, err, warn, image.width, image.height,
-            &buffer.data[bufferView.byteOffset],
+            buffer.GetData() + bufferView.byteOffset,
             static_cast<int>(bufferView.byteLength), load_image_user_data);
         if (!ret) {
           return false;
@@ -59,6 +59,7 @@ namespace wi
 	{
 		readMode = isReadMode;
 		pos = 0;
+		readFailed = false;
 
 		if (readMode)
 		{
@@ -22,6 +22,7 @@ namespace wi
 		wi::vector<uint8_t> DATA; // data suitable for read/write operations
 		const uint8_t* data_ptr = nullptr; // this can either be a memory mapped pointer (read only), or the DATA's pointer
 		size_t data_ptr_size = 0;
+		bool readFailed = false; // a read went past the end of the data (truncated or corrupted archive)
 
 		std::string fileName; // save to this file on closing if not empty
 		std::string directory; // the directory part from the fileName
@@ -57,6 +58,8 @@ namespace wi
 		void SetReadModeAndResetPos(bool isReadMode);
 		// Check if the archive has any data
 		bool IsOpen() const { return data_ptr != nullptr; };
+		// Check if a read went past the end of the data, the values read after that are not valid
+		constexpr bool IsReadFailed() const { return readFailed; }
 		// Close the archive.
 		//	If it was opened from a file in write mode, the file will be written at this point
 		//	The data will be deleted, the archive will be empty after this
@@ -111,10 +114,64 @@ namespace wi
 		inline void MapVector(const uint8_t*& data, size_t& size)
 		{
 			(*this) >> size;
+			if (!CheckReadCount(size, 1))
+			{
+				data = nullptr;
+				size = 0;
+				return;
+			}
 			data = data_ptr + pos;
 			pos += size;
 		}
 
+		// Check that count elements of at least element_size bytes can still be read, before allocating for them
+		//	Returns false if they can't (corrupted or truncated archive), then the archive is marked as failed
+		inline bool CheckReadCount(uint64_t count, size_t element_size)
+		{
+			assert(element_size > 0);
+			if (!readFailed && pos <= data_ptr_size && count <= (data_ptr_size - pos) / element_size)
+				return true;
+			readFailed = true;
+			return false;
+		}
+
+		// Write a raw memory block without its size
+		//	Only use it for plain data whose layout doesn't depend on the platform, or for data that is rebuilt when it doesn't match (caches)
+		inline void WriteRaw(const void* data, size_t size)
+		{
+			assert(!readMode);
+			assert(!DATA.empty());
+			if (size == 0)
+				return;
+			const size_t _right = pos + size;
+			if (_right > DATA.size())
+			{
+				DATA.resize(_right * 2);
+				data_ptr = DATA.data();
+				data_ptr_size = DATA.size();
+			}
+			std::memcpy(DATA.data() + pos, data, size);
+			pos = _right;
+		}
+		// Read a raw memory block that was written by WriteRaw()
+		//	Returns false if the block is out of the archive's bounds, then the destination is zeroed and the archive is marked as failed
+		inline bool ReadRaw(void* data, size_t size)
+		{
+			assert(readMode);
+			assert(data_ptr != nullptr);
+			if (size == 0)
+				return !readFailed;
+			if (readFailed || pos > data_ptr_size || size > data_ptr_size - pos)
+			{
+				readFailed = true;
+				std::memset(data, 0, size);
+				return false;
+			}
+			std::memcpy(data, data_ptr + pos, size);
+			pos += size;
+			return true;
+		}
+
 		// It could be templated but we have to be extremely careful of different datasizes on different platforms
 		// because serialized data should be interchangeable!
 		// So providing exact copy operations for exact types enforces platform agnosticism
@@ -409,6 +466,11 @@ namespace wi
 		{
 			uint64_t len;
 			(*this) >> len;
+			if (!CheckReadCount(len, 1))
+			{
+				data.clear();
+				return *this;
+			}
 			data.resize(len);
 			for (size_t i = 0; i < len; ++i)
 			{
@@ -427,6 +489,11 @@ namespace wi
 			// Here we will use the >> operator so that non-specified types will have compile error!
 			size_t count;
 			(*this) >> count;
+			if (!CheckReadCount(count, 1)) // every element takes at least a byte
+			{
+				data.clear();
+				return *this;
+			}
 			data.resize(count);
 			for (size_t i = 0; i < count; ++i)
 			{
@@ -466,8 +533,13 @@ namespace wi
 		{
 			assert(readMode);
 			assert(data_ptr != nullptr);
-			assert(pos < data_ptr_size);
-			data = *(const T*)(data_ptr + pos);
+			if (readFailed || pos > data_ptr_size || sizeof(data) > data_ptr_size - pos)
+			{
+				readFailed = true;
+				data = T();
+				return;
+			}
+			std::memcpy(&data, data_ptr + pos, sizeof(data));
 			pos += (size_t)(sizeof(data));
 		}
 	};
@@ -1,6 +1,10 @@
 #pragma once
 #include "CommonInclude.h"
 #include "wiPrimitive.h"
+#include "wiArchive.h"
+#include "wiJobSystem.h"
+
+#include <atomic>
 
 namespace wi
 {
@@ -16,17 +20,73 @@ namespace wi
 			uint32_t count = 0;
 			constexpr bool isLeaf() const { return count > 0; }
 		};
+		// 4-wide node collapsed from the binary tree, the child bounds are stored as SoA so that all children are tested at once
+		struct alignas(16) WideNode
+		{
+			static constexpr uint32_t WIDTH = 4;
+			static constexpr uint32_t INVALID = ~0u;
+			float min_x[WIDTH];
+			float min_y[WIDTH];
+			float min_z[WIDTH];
+			float max_x[WIDTH];
+			float max_y[WIDTH];
+			float max_z[WIDTH];
+			uint32_t node[WIDTH];	// binary node of the child (INVALID for unused lanes)
+			uint32_t child[WIDTH];	// wide node of the child (INVALID for leaves and unused lanes)
+		};
 		wi::vector<uint8_t> allocation;
 		Node* nodes = nullptr;
 		uint32_t node_count = 0;
 		uint32_t* leaf_indices = nullptr;
 		uint32_t leaf_count = 0;
+		wi::vector<WideNode> wide_nodes;
+		static constexpr uint32_t WIDE_STACK_SIZE = 256;
 
 		constexpr bool IsValid() const { return nodes != nullptr; }
 
-		void Build(const wi::primitive::AABB* aabbs, uint32_t aabb_count)
+		// Read/write the built tree, the nodes are stored as raw memory (the layout must match, it is meant for caches)
+		void Serialize(wi::Archive& archive)
+		{
+			if (archive.IsReadMode())
+			{
+				archive >> node_count;
+				archive >> leaf_count;
+				if (!archive.CheckReadCount(sizeof(Node) * uint64_t(node_count) + sizeof(uint32_t) * uint64_t(leaf_count), 1))
+				{
+					node_count = 0;
+					leaf_count = 0;
+				}
+				allocation.resize(sizeof(Node) * node_count + sizeof(uint32_t) * leaf_count);
+				nodes = node_count > 0 ? (Node*)allocation.data() : nullptr;
+				leaf_indices = (uint32_t*)(allocation.data() + sizeof(Node) * node_count);
+				if (!archive.ReadRaw(allocation.data(), allocation.size()))
+				{
+					// the nodes of a failed read can't be traversed, the tree is left empty
+					node_count = 0;
+					leaf_count = 0;
+					nodes = nullptr;
+				}
+				BuildWide();
+			}
+			else
+			{
+				archive << node_count;
+				archive << leaf_count;
+				archive.WriteRaw(nodes, sizeof(Node) * node_count);
+				archive.WriteRaw(leaf_indices, sizeof(uint32_t) * leaf_count);
+			}
+		}
+
+		enum class BuildMode
+		{
+			FAST,	// split at the midpoint of the longest axis on one thread, for trees that are rebuilt frequently
+			SAH,	// binned surface area heuristic, splitting large nodes in parallel on the job system, for static geometry
+		};
+
+		void Build(const wi::primitive::AABB* aabbs, uint32_t aabb_count, BuildMode mode = BuildMode::FAST)
 		{
 			node_count = 0;
+			wide_nodes.clear();
 			if (aabb_count == 0)
 				return;
 
@@ -47,7 +107,25 @@ namespace wi
 				node.aabb = wi::primitive::AABB::Merge(node.aabb, aabbs[i]);
 				leaf_indices[i] = i;
 			}
-			Subdivide(0, aabbs);
+			if (mode == BuildMode::SAH)
+			{
+				wi::primitive::AABB centroid_bounds;
+				for (uint32_t i = 0; i < aabb_count; ++i)
+				{
+					const XMFLOAT3 center = GetCentroid(aabbs[i]);
+					centroid_bounds = MergeBounds(centroid_bounds, wi::primitive::AABB(center, center));
+				}
+				std::atomic<uint32_t> node_allocator{ node_count };
+				wi::jobsystem::context ctx;
+				SubdivideSAH(0, centroid_bounds, aabbs, node_allocator, ctx);
+				wi::jobsystem::Wait(ctx);
+				node_count = node_allocator.load();
+			}
+			else
+			{
+				Subdivide(0, aabbs);
+			}
+			BuildWide();
 		}
 
 		void Subdivide(uint32_t nodeIndex, const wi::primitive::AABB* leaf_aabb_data)
@@ -105,6 +183,197 @@ namespace wi
 			Subdivide(right_child_index, leaf_aabb_data);
 		}
 
+		static constexpr uint32_t SAH_BIN_COUNT = 16;
+		static constexpr uint32_t SAH_MAX_LEAF_SIZE = 8; // larger leaves are split even if the heuristic prefers not to
+		static constexpr uint32_t SAH_PARALLEL_SUBTREE = 4096; // nodes with at least this many leaves split their children on separate jobs
+		static constexpr uint32_t SAH_PARALLEL_BINNING = 256 * 1024; // nodes with at least this many leaves are binned on multiple jobs
+
+		struct SAHBins
+		{
+			wi::primitive::AABB bounds[3][SAH_BIN_COUNT];
+			uint32_t count[3][SAH_BIN_COUNT] = {};
+		};
+
+		// The node is split by the binned surface area heuristic, node allocation is atomic so that subtrees can be built in parallel
+		//	https://jacco.ompf2.com/2022/04/21/how-to-build-a-bvh-part-3-quick-builds/
+		void SubdivideSAH(uint32_t nodeIndex, const wi::primitive::AABB& centroid_bounds, const wi::primitive::AABB* leaf_aabb_data, std::atomic<uint32_t>& node_allocator, wi::jobsystem::context& ctx)
+		{
+			Node& node = nodes[nodeIndex];
+			if (node.count <= 2)
+				return;
+
+			const uint32_t bin_count = std::min(SAH_BIN_COUNT, node.count); // small nodes don't need more bins than leaves
+			const XMFLOAT3 centroid_min = centroid_bounds._min;
+			const XMFLOAT3 centroid_max = centroid_bounds._max;
+			float bin_scale[3];
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const float extent = ((float*)&centroid_max)[axis] - ((float*)&centroid_min)[axis];
+				bin_scale[axis] = extent > 0 ? (float(bin_count) / extent) : 0;
+			}
+			auto get_bin = [&](const XMFLOAT3& center, int axis) {
+				return std::min(bin_count - 1, uint32_t((((const float*)&center)[axis] - ((float*)&centroid_min)[axis]) * bin_scale[axis]));
+			};
+			auto bin_range = [&](SAHBins& bins, uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const wi::primitive::AABB& aabb = leaf_aabb_data[leaf_indices[node.offset + i]];
+					const XMFLOAT3 center = GetCentroid(aabb);
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						const uint32_t bin = get_bin(center, axis);
+						bins.count[axis][bin]++;
+						bins.bounds[axis][bin] = MergeBounds(bins.bounds[axis][bin], aabb);
+					}
+				}
+			};
+
+			SAHBins bins;
+			if (node.count >= SAH_PARALLEL_BINNING)
+			{
+				const uint32_t group_size = SAH_PARALLEL_BINNING / 4;
+				wi::vector<SAHBins> group_bins(wi::jobsystem::DispatchGroupCount(node.count, group_size));
+				wi::jobsystem::context binning_ctx;
+				wi::jobsystem::Dispatch(binning_ctx, (uint32_t)group_bins.size(), 1, [&](wi::jobsystem::JobArgs args) {
+					const uint32_t begin = args.jobIndex * group_size;
+					bin_range(group_bins[args.jobIndex], begin, std::min(node.count, begin + group_size));
+				});
+				wi::jobsystem::Wait(binning_ctx);
+				for (const SAHBins& group : group_bins)
+				{
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						for (uint32_t bin = 0; bin < bin_count; ++bin)
+						{
+							bins.count[axis][bin] += group.count[axis][bin];
+							bins.bounds[axis][bin] = MergeBounds(bins.bounds[axis][bin], group.bounds[axis][bin]);
+						}
+					}
+				}
+			}
+			else
+			{
+				bin_range(bins, 0, node.count);
+			}
+
+			// sweep the planes between the bins:
+			int best_axis = -1;
+			uint32_t best_bin = 0;
+			float best_cost = std::numeric_limits<float>::max();
+			wi::primitive::AABB best_left_bounds;
+			wi::primitive::AABB best_right_bounds;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (bin_scale[axis] == 0)
+					continue;
+				float left_area[SAH_BIN_COUNT - 1];
+				uint32_t left_count[SAH_BIN_COUNT - 1];
+				wi::primitive::AABB left_bounds[SAH_BIN_COUNT - 1];
+				wi::primitive::AABB bounds;
+				uint32_t count = 0;
+				for (uint32_t bin = 0; bin < bin_count - 1; ++bin)
+				{
+					bounds = MergeBounds(bounds, bins.bounds[axis][bin]);
+					count += bins.count[axis][bin];
+					left_bounds[bin] = bounds;
+					left_area[bin] = GetSurfaceArea(bounds);
+					left_count[bin] = count;
+				}
+				bounds = {};
+				count = 0;
+				for (uint32_t bin = bin_count - 1; bin > 0; --bin)
+				{
+					bounds = MergeBounds(bounds, bins.bounds[axis][bin]);
+					count += bins.count[axis][bin];
+					const uint32_t plane = bin - 1;
+					if (left_count[plane] == 0 || count == 0)
+						continue;
+					const float cost = left_count[plane] * left_area[plane] + count * GetSurfaceArea(bounds);
+					if (cost < best_cost)
+					{
+						best_axis = axis;
+						best_bin = plane;
+						best_cost = cost;
+						best_left_bounds = left_bounds[plane];
+						best_right_bounds = bounds;
+					}
+				}
+			}
+
+			uint32_t left_count = 0;
+			wi::primitive::AABB left_centroid_bounds = centroid_bounds;
+			wi::primitive::AABB right_centroid_bounds = centroid_bounds;
+			if (best_axis < 0)
+			{
+				// all centroids are in the same point, only the leaf size can be reduced:
+				if (node.count <= SAH_MAX_LEAF_SIZE)
+					return;
+				left_count = node.count / 2;
+			}
+			else
+			{
+				if (best_cost >= node.count * GetSurfaceArea(node.aabb) && node.count <= SAH_MAX_LEAF_SIZE)
+					return;
+
+				// in-place partition, also computing the centroid bounds that the children will bin with
+				left_centroid_bounds = {};
+				right_centroid_bounds = {};
+				int i = node.offset;
+				int j = i + node.count - 1;
+				while (i <= j)
+				{
+					const XMFLOAT3 center = GetCentroid(leaf_aabb_data[leaf_indices[i]]);
+					if (get_bin(center, best_axis) <= best_bin)
+					{
+						left_centroid_bounds = MergeBounds(left_centroid_bounds, wi::primitive::AABB(center, center));
+						i++;
+					}
+					else
+					{
+						right_centroid_bounds = MergeBounds(right_centroid_bounds, wi::primitive::AABB(center, center));
+						std::swap(leaf_indices[i], leaf_indices[j--]);
+					}
+				}
+				left_count = i - node.offset;
+			}
+
+			// create child nodes
+			uint32_t left_child_index = node_allocator.fetch_add(2);
+			uint32_t right_child_index = left_child_index + 1;
+			node.left = left_child_index;
+			nodes[left_child_index] = {};
+			nodes[left_child_index].offset = node.offset;
+			nodes[left_child_index].count = left_count;
+			nodes[right_child_index] = {};
+			nodes[right_child_index].offset = node.offset + left_count;
+			nodes[right_child_index].count = node.count - left_count;
+			const bool parallel = node.count >= SAH_PARALLEL_SUBTREE;
+			node.count = 0;
+			if (best_axis < 0)
+			{
+				UpdateNodeBounds(left_child_index, leaf_aabb_data);
+				UpdateNodeBounds(right_child_index, leaf_aabb_data);
+			}
+			else
+			{
+				nodes[left_child_index].aabb = best_left_bounds;
+				nodes[right_child_index].aabb = best_right_bounds;
+			}
+
+			// recurse
+			if (parallel)
+			{
+				wi::jobsystem::Execute(ctx, [=, &node_allocator, &ctx](wi::jobsystem::JobArgs args) {
+					SubdivideSAH(left_child_index, left_centroid_bounds, leaf_aabb_data, node_allocator, ctx);
+				});
+			}
+			else
+			{
+				SubdivideSAH(left_child_index, left_centroid_bounds, leaf_aabb_data, node_allocator, ctx);
+			}
+			SubdivideSAH(right_child_index, right_centroid_bounds, leaf_aabb_data, node_allocator, ctx);
+		}
+
 		void UpdateNodeBounds(uint32_t nodeIndex, const wi::primitive::AABB* leaf_aabb_data)
 		{
 			Node& node = nodes[nodeIndex];
@@ -117,6 +386,287 @@ namespace wi
 			}
 		}
 
+		// Update the node bounds from the moved leaves without changing the tree (the leaf count must be the same as in Build)
+		//	Returns the cost of the refitted tree (see GetCost())
+		float Refit(const wi::primitive::AABB* leaf_aabb_data)
+		{
+			float cost = 0;
+			// child nodes are always allocated after their parent, so the reverse order updates the children first:
+			for (uint32_t i = node_count; i > 0; --i)
+			{
+				const uint32_t nodeIndex = i - 1;
+				Node& node = nodes[nodeIndex];
+				if (node.isLeaf())
+				{
+					UpdateNodeBounds(nodeIndex, leaf_aabb_data);
+				}
+				else
+				{
+					node.aabb = wi::primitive::AABB::Merge(nodes[node.left].aabb, nodes[node.left + 1].aabb);
+				}
+				cost += GetSurfaceArea(node.aabb);
+			}
+			for (WideNode& wide_node : wide_nodes)
+			{
+				for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+				{
+					if (wide_node.node[lane] != WideNode::INVALID)
+					{
+						SetWideBounds(wide_node, lane, nodes[wide_node.node[lane]].aabb);
+					}
+				}
+			}
+			return cost;
+		}
+
+		// Collapse the binary tree into wide nodes, this is done by Build() and Serialize() automatically
+		//	Each wide node takes the children of a binary node, then keeps opening its largest internal child until all lanes are used
+		void BuildWide()
+		{
+			wide_nodes.clear();
+			if (node_count == 0)
+				return;
+			wide_nodes.reserve(node_count / 2 + 1);
+
+			struct Item
+			{
+				uint32_t nodeIndex;
+				uint32_t wideIndex;
+				uint32_t depth;
+			};
+			wi::vector<Item> stack;
+			stack.push_back({ 0, 0, 1 });
+			wide_nodes.emplace_back();
+			uint32_t max_depth = 0;
+			while (!stack.empty())
+			{
+				const uint32_t nodeIndex = stack.back().nodeIndex;
+				const uint32_t wideIndex = stack.back().wideIndex;
+				const uint32_t depth = stack.back().depth;
+				stack.pop_back();
+				max_depth = std::max(max_depth, depth);
+
+				uint32_t lanes[WideNode::WIDTH] = {};
+				uint32_t lane_count = 0;
+				if (nodes[nodeIndex].isLeaf())
+				{
+					lanes[lane_count++] = nodeIndex; // only the root can be a single leaf
+				}
+				else
+				{
+					lanes[lane_count++] = nodes[nodeIndex].left;
+					lanes[lane_count++] = nodes[nodeIndex].left + 1;
+				}
+				while (lane_count < WideNode::WIDTH)
+				{
+					int largest = -1;
+					float largest_area = -1;
+					for (uint32_t lane = 0; lane < lane_count; ++lane)
+					{
+						const Node& node = nodes[lanes[lane]];
+						const float area = GetSurfaceArea(node.aabb);
+						if (!node.isLeaf() && area > largest_area)
+						{
+							largest = (int)lane;
+							largest_area = area;
+						}
+					}
+					if (largest < 0)
+						break;
+					const uint32_t left = nodes[lanes[largest]].left;
+					lanes[largest] = left;
+					lanes[lane_count++] = left + 1;
+				}
+
+				for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+				{
+					uint32_t child = WideNode::INVALID;
+					if (lane < lane_count && !nodes[lanes[lane]].isLeaf())
+					{
+						child = (uint32_t)wide_nodes.size();
+						wide_nodes.emplace_back();
+						stack.push_back({ lanes[lane], child, depth + 1 });
+					}
+					WideNode& wide_node = wide_nodes[wideIndex];
+					wide_node.node[lane] = lane < lane_count ? lanes[lane] : WideNode::INVALID;
+					wide_node.child[lane] = child;
+					SetWideBounds(wide_node, lane, lane < lane_count ? nodes[lanes[lane]].aabb : wi::primitive::AABB());
+				}
+			}
+
+			if ((WideNode::WIDTH - 1) * max_depth + 1 > WIDE_STACK_SIZE)
+			{
+				// too deep for the traversal stack, queries will use the binary tree
+				wide_nodes.clear();
+			}
+		}
+
+		static void SetWideBounds(WideNode& wide_node, uint32_t lane, const wi::primitive::AABB& aabb)
+		{
+			wide_node.min_x[lane] = aabb._min.x;
+			wide_node.min_y[lane] = aabb._min.y;
+			wide_node.min_z[lane] = aabb._min.z;
+			wide_node.max_x[lane] = aabb._max.x;
+			wide_node.max_y[lane] = aabb._max.y;
+			wide_node.max_z[lane] = aabb._max.z;
+		}
+
+		// Sum of the node surface areas, it is proportional to the expected traversal cost of a random ray
+		//	A refitted tree whose cost grew a lot compared to its built cost should be rebuilt
+		float GetCost() const
+		{
+			float cost = 0;
+			for (uint32_t i = 0; i < node_count; ++i)
+			{
+				cost += GetSurfaceArea(nodes[i].aabb);
+			}
+			return cost;
+		}
+
+		// Expected cost of tracing a random ray relative to testing one leaf, with unit traversal and leaf test costs:
+		//	the node surface areas are normalized by the root, which is the probability that a ray hitting the root also hits the node
+		float GetSAHCost() const
+		{
+			if (node_count == 0)
+				return 0;
+			const float root_area = GetSurfaceArea(nodes[0].aabb);
+			if (root_area <= 0)
+				return 0;
+			float cost = 0;
+			for (uint32_t i = 0; i < node_count; ++i)
+			{
+				const Node& node = nodes[i];
+				cost += GetSurfaceArea(node.aabb) * (node.isLeaf() ? float(node.count) : 1.0f);
+			}
+			return cost / root_area;
+		}
+
+		// Same as AABB::Merge(), but inlined into the build loops
+		static wi::primitive::AABB MergeBounds(const wi::primitive::AABB& a, const wi::primitive::AABB& b)
+		{
+			return wi::primitive::AABB(wi::math::Min(a._min, b._min), wi::math::Max(a._max, b._max));
+		}
+
+		static XMFLOAT3 GetCentroid(const wi::primitive::AABB& aabb)
+		{
+			return XMFLOAT3((aabb._min.x + aabb._max.x) * 0.5f, (aabb._min.y + aabb._max.y) * 0.5f, (aabb._min.z + aabb._max.z) * 0.5f);
+		}
+
+		static float GetSurfaceArea(const wi::primitive::AABB& aabb)
+		{
+			const XMFLOAT3 extent = XMFLOAT3(aabb._max.x - aabb._min.x, aabb._max.y - aabb._min.y, aabb._max.z - aabb._min.z);
+			if (extent.x < 0 || extent.y < 0 || extent.z < 0)
+				return 0; // empty
+			return 2 * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+		}
+
+		// Bit mask of the children of a wide node that the primitive intersects
+		//	Rays, spheres and AABBs are tested with 4-wide SIMD, other primitives test the children one by one
+		template <typename T>
+		static uint32_t IntersectsWide(const WideNode& wide_node, const T& primitive)
+		{
+			uint32_t mask = 0;
+			for (uint32_t lane = 0; lane < WideNode::WIDTH; ++lane)
+			{
+				const wi::primitive::AABB aabb = wi::primitive::AABB(
+					XMFLOAT3(wide_node.min_x[lane], wide_node.min_y[lane], wide_node.min_z[lane]),
+					XMFLOAT3(wide_node.max_x[lane], wide_node.max_y[lane], wide_node.max_z[lane])
+				);
+				if (aabb.intersects(primitive))
+				{
+					mask |= 1u << lane;
+				}
+			}
+			return mask;
+		}
+		static uint32_t IntersectsWide(const WideNode& wide_node, const wi::primitive::Ray& ray)
+		{
+			const XMVECTOR min_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_x);
+			const XMVECTOR min_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_y);
+			const XMVECTOR min_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_z);
+			const XMVECTOR max_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_x);
+			const XMVECTOR max_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_y);
+			const XMVECTOR max_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_z);
+			const XMVECTOR origin_x = XMVectorReplicate(ray.origin.x);
+			const XMVECTOR origin_y = XMVectorReplicate(ray.origin.y);
+			const XMVECTOR origin_z = XMVectorReplicate(ray.origin.z);
+			const XMVECTOR inv_x = XMVectorReplicate(ray.direction_inverse.x);
+			const XMVECTOR inv_y = XMVectorReplicate(ray.direction_inverse.y);
+			const XMVECTOR inv_z = XMVectorReplicate(ray.direction_inverse.z);
+
+			const XMVECTOR tx1 = XMVectorMultiply(XMVectorSubtract(min_x, origin_x), inv_x);
+			const XMVECTOR tx2 = XMVectorMultiply(XMVectorSubtract(max_x, origin_x), inv_x);
+			const XMVECTOR ty1 = XMVectorMultiply(XMVectorSubtract(min_y, origin_y), inv_y);
+			const XMVECTOR ty2 = XMVectorMultiply(XMVectorSubtract(max_y, origin_y), inv_y);
+			const XMVECTOR tz1 = XMVectorMultiply(XMVectorSubtract(min_z, origin_z), inv_z);
+			const XMVECTOR tz2 = XMVectorMultiply(XMVectorSubtract(max_z, origin_z), inv_z);
+			XMVECTOR tmin = XMVectorMax(XMVectorMax(XMVectorMin(tx1, tx2), XMVectorMin(ty1, ty2)), XMVectorMin(tz1, tz2));
+			XMVECTOR tmax = XMVectorMin(XMVectorMin(XMVectorMax(tx1, tx2), XMVectorMax(ty1, ty2)), XMVectorMax(tz1, tz2));
+			tmin = XMVectorMax(tmin, XMVectorReplicate(ray.TMin));
+			tmax = XMVectorMin(tmax, XMVectorReplicate(ray.TMax));
+			XMVECTOR hit = XMVectorLessOrEqual(tmin, tmax);
+
+			// the origin inside the box is a hit even when the slabs are degenerate (zero direction components):
+			XMVECTOR inside = XMVectorAndInt(XMVectorLessOrEqual(min_x, origin_x), XMVectorLessOrEqual(origin_x, max_x));
+			inside = XMVectorAndInt(inside, XMVectorAndInt(XMVectorLessOrEqual(min_y, origin_y), XMVectorLessOrEqual(origin_y, max_y)));
+			inside = XMVectorAndInt(inside, XMVectorAndInt(XMVectorLessOrEqual(min_z, origin_z), XMVectorLessOrEqual(origin_z, max_z)));
+			hit = XMVectorOrInt(hit, inside);
+
+			return GetWideMask(XMVectorAndInt(hit, GetWideValid(min_x, min_y, min_z, max_x, max_y, max_z)));
+		}
+		static uint32_t IntersectsWide(const WideNode& wide_node, const wi::primitive::Sphere& sphere)
+		{
+			const XMVECTOR min_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_x);
+			const XMVECTOR min_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_y);
+			const XMVECTOR min_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_z);
+			const XMVECTOR max_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_x);
+			const XMVECTOR max_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_y);
+			const XMVECTOR max_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_z);
+			const XMVECTOR center_x = XMVectorReplicate(sphere.center.x);
+			const XMVECTOR center_y = XMVectorReplicate(sphere.center.y);
+			const XMVECTOR center_z = XMVectorReplicate(sphere.center.z);
+
+			// distance from the closest point in the boxes:
+			const XMVECTOR dx = XMVectorSubtract(XMVectorMin(XMVectorMax(center_x, min_x), max_x), center_x);
+			const XMVECTOR dy = XMVectorSubtract(XMVectorMin(XMVectorMax(center_y, min_y), max_y), center_y);
+			const XMVECTOR dz = XMVectorSubtract(XMVectorMin(XMVectorMax(center_z, min_z), max_z), center_z);
+			const XMVECTOR distanceSquared = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz)));
+			const XMVECTOR hit = XMVectorLess(distanceSquared, XMVectorReplicate(sphere.radius * sphere.radius));
+
+			return GetWideMask(XMVectorAndInt(hit, GetWideValid(min_x, min_y, min_z, max_x, max_y, max_z)));
+		}
+		static uint32_t IntersectsWide(const WideNode& wide_node, const wi::primitive::AABB& aabb)
+		{
+			if (!aabb.IsValid())
+				return 0;
+			const XMVECTOR min_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_x);
+			const XMVECTOR min_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_y);
+			const XMVECTOR min_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.min_z);
+			const XMVECTOR max_x = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_x);
+			const XMVECTOR max_y = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_y);
+			const XMVECTOR max_z = XMLoadFloat4A((const XMFLOAT4A*)wide_node.max_z);
+
+			XMVECTOR hit = XMVectorAndInt(XMVectorLessOrEqual(min_x, XMVectorReplicate(aabb._max.x)), XMVectorLessOrEqual(XMVectorReplicate(aabb._min.x), max_x));
+			hit = XMVectorAndInt(hit, XMVectorAndInt(XMVectorLessOrEqual(min_y, XMVectorReplicate(aabb._max.y)), XMVectorLessOrEqual(XMVectorReplicate(aabb._min.y), max_y)));
+			hit = XMVectorAndInt(hit, XMVectorAndInt(XMVectorLessOrEqual(min_z, XMVectorReplicate(aabb._max.z)), XMVectorLessOrEqual(XMVectorReplicate(aabb._min.z), max_z)));
+
+			return GetWideMask(XMVectorAndInt(hit, GetWideValid(min_x, min_y, min_z, max_x, max_y, max_z)));
+		}
+		static XMVECTOR GetWideValid(XMVECTOR min_x, XMVECTOR min_y, XMVECTOR min_z, XMVECTOR max_x, XMVECTOR max_y, XMVECTOR max_z)
+		{
+			return XMVectorAndInt(XMVectorAndInt(XMVectorLessOrEqual(min_x, max_x), XMVectorLessOrEqual(min_y, max_y)), XMVectorLessOrEqual(min_z, max_z));
+		}
+		static uint32_t GetWideMask(XMVECTOR comparison)
+		{
+#if defined(_XM_SSE_INTRINSICS_)
+			return (uint32_t)_mm_movemask_ps(comparison);
+#else
+			XMUINT4 bits;
+			XMStoreUInt4(&bits, comparison);
+			return (bits.x & 1u) | ((bits.y & 1u) << 1u) | ((bits.z & 1u) << 2u) | ((bits.w & 1u) << 3u);
+#endif // _XM_SSE_INTRINSICS_
+		}
+
 		template <typename T>
 		void Intersects(
 			const T& primitive,
@@ -124,6 +674,14 @@ namespace wi
 			const std::function<void(uint32_t index)>& callback
 		) const
 		{
+			if (nodeIndex == 0 && !wide_nodes.empty())
+			{
+				IntersectsFirst(primitive, [&](uint32_t index) {
+					callback(index);
+					return false;
+				});
+				return;
+			}
 			Node& node = nodes[nodeIndex];
 			if (!node.aabb.intersects(primitive))
 				return;
@@ -141,6 +699,111 @@ namespace wi
 			}
 		}
 
+		// Hierarchical culling of the leaves against multiple frusta (up to 16) in a single traversal
+		//	callback(index, mask) is called for every leaf that is not outside of all frusta, mask has the bit of every frustum that the leaf is not outside of
+		//	Subtrees are rejected by a frustum when they are outside of one of its planes, and planes that a subtree is completely inside of are not tested below it,
+		//	so subtrees that are inside of a frustum are accepted without testing, only leaf_aabb_data (that the BVH was built from) of intersecting nodes are tested
+		template <typename F>
+		void CullFrusta(
+			const wi::primitive::Frustum* frusta,
+			uint32_t frustum_count,
+			const wi::primitive::AABB* leaf_aabb_data,
+			const F& callback
+		) const
+		{
+			assert(frustum_count <= 16);
+			if (node_count == 0 || frustum_count == 0)
+				return;
+
+			struct Entry
+			{
+				uint32_t nodeIndex;
+				uint16_t frustum_mask; // frusta that the node is not outside of
+				uint8_t plane_masks[16]; // planes of each frustum that the node intersects
+			};
+			wi::vector<Entry> stack;
+			stack.reserve(64);
+			Entry& root = stack.emplace_back();
+			root.nodeIndex = 0;
+			root.frustum_mask = uint16_t((1u << frustum_count) - 1u);
+			std::fill(root.plane_masks, root.plane_masks + frustum_count, uint8_t(0x3F));
+
+			while (!stack.empty())
+			{
+				Entry entry = stack.back();
+				stack.pop_back();
+
+				const Node& node = nodes[entry.nodeIndex];
+				for (uint32_t f = 0; f < frustum_count; ++f)
+				{
+					if ((entry.frustum_mask & (1u << f)) && entry.plane_masks[f] != 0 && !CullPlanes(frusta[f], node.aabb, entry.plane_masks[f]))
+					{
+						entry.frustum_mask &= ~(1u << f);
+					}
+				}
+				if (entry.frustum_mask == 0)
+					continue;
+
+				if (node.isLeaf())
+				{
+					for (uint32_t i = 0; i < node.count; ++i)
+					{
+						const uint32_t index = leaf_indices[node.offset + i];
+						const wi::primitive::AABB& aabb = leaf_aabb_data[index];
+						if (!aabb.IsValid())
+							continue;
+						uint32_t mask = entry.frustum_mask;
+						for (uint32_t f = 0; f < frustum_count; ++f)
+						{
+							uint8_t plane_mask = entry.plane_masks[f];
+							if ((mask & (1u << f)) && plane_mask != 0 && !CullPlanes(frusta[f], aabb, plane_mask))
+							{
+								mask &= ~(1u << f);
+							}
+						}
+						if (mask != 0)
+						{
+							callback(index, uint16_t(mask));
+						}
+					}
+				}
+				else
+				{
+					entry.nodeIndex = node.left + 1;
+					stack.push_back(entry);
+					entry.nodeIndex = node.left;
+					stack.push_back(entry);
+				}
+			}
+		}
+		// Returns false if the box is outside of one of the planes of plane_mask, and removes the planes that the box is completely inside of
+		static bool CullPlanes(const wi::primitive::Frustum& frustum, const wi::primitive::AABB& aabb, uint8_t& plane_mask)
+		{
+			uint32_t planes = plane_mask;
+			while (planes != 0)
+			{
+				const uint32_t p = firstbitlow(planes);
+				planes &= planes - 1;
+				const XMFLOAT4& plane = frustum.planes[p];
+				// the furthest corner along the plane normal decides if the box is outside, the closest one decides if it's inside:
+				const float furthest =
+					plane.x * (plane.x < 0 ? aabb._min.x : aabb._max.x) +
+					plane.y * (plane.y < 0 ? aabb._min.y : aabb._max.y) +
+					plane.z * (plane.z < 0 ? aabb._min.z : aabb._max.z) + plane.w;
+				if (furthest < 0)
+					return false;
+				const float closest =
+					plane.x * (plane.x < 0 ? aabb._max.x : aabb._min.x) +
+					plane.y * (plane.y < 0 ? aabb._max.y : aabb._min.y) +
+					plane.z * (plane.z < 0 ? aabb._max.z : aabb._min.z) + plane.w;
+				if (closest >= 0)
+				{
+					plane_mask &= ~(1u << p);
+				}
+			}
+			return true;
+		}
+
 		// Returning true from callback will immediately exit the whole search
 		template <typename T>
 		bool IntersectsFirst(
@@ -148,6 +811,35 @@ namespace wi
 			const std::function<bool(uint32_t index)>& callback
 		) const
 		{
+			if (!wide_nodes.empty())
+			{
+				uint32_t stack[WIDE_STACK_SIZE];
+				uint32_t count = 0;
+				stack[count++] = 0; // push wide node 0
+				while (count > 0)
+				{
+					const WideNode& wide_node = wide_nodes[stack[--count]];
+					uint32_t mask = IntersectsWide(wide_node, primitive);
+					while (mask != 0)
+					{
+						const uint32_t lane = firstbitlow(mask);
+						mask &= mask - 1;
+						if (wide_node.child[lane] != WideNode::INVALID)
+						{
+							stack[count++] = wide_node.child[lane];
+							continue;
+						}
+						const Node& node = nodes[wide_node.node[lane]];
+						for (uint32_t i = 0; i < node.count; ++i)
+						{
+							if (callback(leaf_indices[node.offset + i]))
+								return true;
+						}
+					}
+				}
+				return false;
+			}
+
 			uint32_t stack[64];
 			uint32_t count = 0;
 			stack[count++] = 0; // push node 0
@@ -12,6 +12,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <algorithm>
 
 // Entity-Component System
 namespace wi::ecs
@@ -22,11 +23,19 @@ namespace wi::ecs
 	//	It must be only serialized with the SerializeEntity() function. It will ensure that entities still match with their components correctly after serialization
 	using Entity = uint32_t;
 	inline constexpr Entity INVALID_ENTITY = 0;
+	namespace entity_internal
+	{
+		inline std::atomic<Entity> next{ INVALID_ENTITY + 1 };
+	}
 	// Runtime can create a new entity with this
 	inline Entity CreateEntity()
 	{
-		static std::atomic<Entity> next{ INVALID_ENTITY + 1 };
-		return next.fetch_add(1);
+		return entity_internal::next.fetch_add(1);
+	}
+	// Check if the value was returned by CreateEntity() (the entity might not have any components anymore)
+	inline bool IsEntityCreated(Entity entity)
+	{
+		return entity != INVALID_ENTITY && entity < entity_internal::next.load(std::memory_order_relaxed);
 	}
 
 	class ComponentLibrary;
@@ -39,6 +48,7 @@ namespace wi::ecs
 		wi::unordered_set<std::string> resource_registration; // register for resource manager serialization
 		ComponentLibrary* componentlibrary = nullptr;
 		wi::unordered_map<std::string, uint64_t> library_versions;
+		bool precomputed_data = false; // components can write their derived data (acceleration structures, etc.) to skip rebuilding them after loading
 
 		~EntitySerializer()
 		{
@@ -110,6 +120,13 @@ namespace wi::ecs
 		}
 	}
 
+	// Entity lookup implementations of the ComponentManager:
+	enum class LookupMode
+	{
+		HASH,	// hash map from entity to component index, memory usage is proportional to the component count
+		PAGED,	// sparse set with dense pages indexed by entity, faster lookup but every touched page of 4096 entities is fully allocated
+	};
+
 	// This is an interface class to implement a ComponentManager,
 	// inherit this class if you want to work with ComponentLibrary
 	class ComponentManager_Interface
@@ -129,6 +146,9 @@ namespace wi::ecs
 		virtual size_t GetCount() const = 0;
 		virtual Entity GetEntity(size_t index) const = 0;
 		virtual const wi::vector<Entity>& GetEntityArray() const = 0;
+		virtual uint64_t GetGeneration() const = 0;
+		virtual void SetLookupMode(LookupMode mode) = 0;
+		virtual LookupMode GetLookupMode() const = 0;
 	};
 
 	// The ComponentManager is a container that stores components and matches them with entities
@@ -140,11 +160,13 @@ namespace wi::ecs
 	public:
 
 		// reservedCount : how much components can be held initially before growing the container
-		ComponentManager(size_t reservedCount = 0)
+		// mode : entity lookup implementation, it can be changed later with SetLookupMode()
+		ComponentManager(size_t reservedCount = 0, LookupMode mode = LookupMode::HASH) : lookup_mode(mode)
 		{
 			components.reserve(reservedCount);
 			entities.reserve(reservedCount);
-			lookup.reserve(reservedCount);
+			dirty.reserve(reservedCount);
+			lookup_reserve(reservedCount);
 		}
 
 		// Clear the whole container
@@ -152,7 +174,9 @@ namespace wi::ecs
 		{
 			components.clear();
 			entities.clear();
-			lookup.clear();
+			dirty.clear();
+			lookup_clear();
+			generation++;
 		}
 
 		// Perform deep copy of all the contents of "other" into this
@@ -160,15 +184,18 @@ namespace wi::ecs
 		{
 			components.reserve(GetCount() + other.GetCount());
 			entities.reserve(GetCount() + other.GetCount());
-			lookup.reserve(GetCount() + other.GetCount());
+			lookup_reserve(GetCount() + other.GetCount());
+			dirty.reserve(GetCount() + other.GetCount());
 			for (size_t i = 0; i < other.GetCount(); ++i)
 			{
 				Entity entity = other.entities[i];
 				assert(!Contains(entity));
 				entities.push_back(entity);
-				lookup[entity] = components.size();
+				dirty.push_back(1);
+				lookup_set(entity, components.size());
 				components.push_back(other.components[i]);
 			}
+			generation++;
 		}
 
 		// Merge in an other component manager of the same type to this.
@@ -178,16 +205,19 @@ namespace wi::ecs
 		{
 			components.reserve(GetCount() + other.GetCount());
 			entities.reserve(GetCount() + other.GetCount());
-			lookup.reserve(GetCount() + other.GetCount());
+			lookup_reserve(GetCount() + other.GetCount());
+			dirty.reserve(GetCount() + other.GetCount());
 
 			for (size_t i = 0; i < other.GetCount(); ++i)
 			{
 				Entity entity = other.entities[i];
 				assert(!Contains(entity));
 				entities.push_back(entity);
-				lookup[entity] = components.size();
+				dirty.push_back(1);
+				lookup_set(entity, components.size());
 				components.push_back(std::move(other.components[i]));
 			}
+			generation++;
 
 			other.Clear();
 		}
@@ -211,6 +241,10 @@ namespace wi::ecs
 
 				size_t count;
 				archive >> count;
+				if (!archive.CheckReadCount(count, 1))
+				{
+					count = 0;
+				}
 
 				components.resize(prev_count + count);
 				for (size_t i = 0; i < count; ++i)
@@ -224,8 +258,11 @@ namespace wi::ecs
 					Entity entity;
 					SerializeEntity(archive, entity, seri);
 					entities[prev_count + i] = entity;
-					lookup[entity] = prev_count + i;
+					lookup_set(entity, prev_count + i);
 				}
+
+				dirty.resize(prev_count + count, 1);
+				generation++;
 			}
 			else
 			{
@@ -276,14 +313,14 @@ namespace wi::ecs
 			assert(entity != INVALID_ENTITY);
 
 			// Only one of this component type per entity is allowed!
-			assert(lookup.find(entity) == lookup.end());
+			assert(lookup_find(entity) == ~0ull);
 
 			// Entity count must always be the same as the number of coponents!
 			assert(entities.size() == components.size());
-			assert(lookup.size() == components.size());
+			assert(lookup_mode != LookupMode::HASH || lookup.size() == components.size());
 
 			// Update the entity lookup table:
-			lookup[entity] = components.size();
+			lookup_set(entity, components.size());
 
 			// New components are always pushed to the end:
 			components.emplace_back();
@@ -291,17 +328,20 @@ namespace wi::ecs
 			// Also push corresponding entity:
 			entities.push_back(entity);
 
+			// New components always start out dirty:
+			dirty.push_back(1);
+			generation++;
+
 			return components.back();
 		}
 
 		// Remove a component of a certain entity if it exists
 		inline void Remove(Entity entity)
 		{
-			auto it = lookup.find(entity);
-			if (it != lookup.end())
+			const size_t index = lookup_find(entity);
+			if (index != ~0ull)
 			{
 				// Directly index into components and entities array:
-				const size_t index = it->second;
 				const Entity entity = entities[index];
 
 				if (index < components.size() - 1)
@@ -309,26 +349,28 @@ namespace wi::ecs
 					// Swap out the dead element with the last one:
 					components[index] = std::move(components.back()); // try to use move instead of copy
 					entities[index] = entities.back();
+					dirty[index] = dirty.back();
 
 					// Update the lookup table:
-					lookup[entities[index]] = index;
+					lookup_set(entities[index], index);
 				}
 
 				// Shrink the container:
 				components.pop_back();
 				entities.pop_back();
-				lookup.erase(entity);
+				dirty.pop_back();
+				lookup_erase(entity);
+				generation++;
 			}
 		}
 
 		// Remove a component of a certain entity if it exists while keeping the current ordering
 		inline void Remove_KeepSorted(Entity entity)
 		{
-			auto it = lookup.find(entity);
-			if (it != lookup.end())
+			const size_t index = lookup_find(entity);
+			if (index != ~0ull)
 			{
 				// Directly index into components and entities array:
-				const size_t index = it->second;
 				const Entity entity = entities[index];
 
 				if (index < components.size() - 1)
@@ -342,14 +384,17 @@ namespace wi::ecs
 					for (size_t i = index + 1; i < entities.size(); ++i)
 					{
 						entities[i - 1] = entities[i];
-						lookup[entities[i - 1]] = i - 1;
+						dirty[i - 1] = dirty[i];
+						lookup_set(entities[i - 1], i - 1);
 					}
 				}
 
 				// Shrink the container:
 				components.pop_back();
 				entities.pop_back();
-				lookup.erase(entity);
+				dirty.pop_back();
+				lookup_erase(entity);
+				generation++;
 			}
 		}
 
@@ -366,6 +411,7 @@ namespace wi::ecs
 			// Save the moved component and entity:
 			Component component = std::move(components[index_from]);
 			Entity entity = entities[index_from];
+			uint8_t entity_dirty = dirty[index_from];
 
 			// Every other entity-component that's in the way gets moved by one and lut is kept updated:
 			const int direction = index_from < index_to ? 1 : -1;
@@ -374,32 +420,35 @@ namespace wi::ecs
 				const size_t next = i + direction;
 				components[i] = std::move(components[next]);
 				entities[i] = entities[next];
-				lookup[entities[i]] = i;
+				dirty[i] = dirty[next];
+				lookup_set(entities[i], i);
 			}
 
 			// Saved entity-component moved to the required position:
 			components[index_to] = std::move(component);
 			entities[index_to] = entity;
-			lookup[entity] = index_to;
+			dirty[index_to] = entity_dirty;
+			lookup_set(entity, index_to);
+			generation++;
 		}
 
 		// Check if a component exists for a given entity or not
 		inline bool Contains(Entity entity) const
 		{
-			if (lookup.empty())
+			if (components.empty())
 				return false;
-			return lookup.find(entity) != lookup.end();
+			return lookup_find(entity) != ~0ull;
 		}
 
 		// Retrieve a [read/write] component specified by an entity (if it exists, otherwise nullptr)
 		inline Component* GetComponent(Entity entity)
 		{
-			if (lookup.empty())
+			if (components.empty())
 				return nullptr;
-			auto it = lookup.find(entity);
-			if (it != lookup.end())
+			const size_t index = lookup_find(entity);
+			if (index != ~0ull)
 			{
-				return &components[it->second];
+				return &components[index];
 			}
 			return nullptr;
 		}
@@ -407,12 +456,12 @@ namespace wi::ecs
 		// Retrieve a [read only] component specified by an entity (if it exists, otherwise nullptr)
 		inline const Component* GetComponent(Entity entity) const
 		{
-			if (lookup.empty())
+			if (components.empty())
 				return nullptr;
-			const auto it = lookup.find(entity);
-			if (it != lookup.end())
+			const size_t index = lookup_find(entity);
+			if (index != ~0ull)
 			{
-				return &components[it->second];
+				return &components[index];
 			}
 			return nullptr;
 		}
@@ -420,14 +469,9 @@ namespace wi::ecs
 		// Retrieve component index by entity handle (if not exists, returns ~0ull value)
 		inline size_t GetIndex(Entity entity) const
 		{
-			if (lookup.empty())
+			if (components.empty())
 				return ~0ull;
-			const auto it = lookup.find(entity);
-			if (it != lookup.end())
-			{
-				return it->second;
-			}
-			return ~0ull;
+			return lookup_find(entity);
 		}
 
 		// Retrieve the number of existing entries
@@ -451,13 +495,137 @@ namespace wi::ecs
 		// Returns the tightly packed [read only] component array
 		inline const wi::vector<Component>& GetComponentArray() const { return components; }
 
+		// Mark a component as changed by entity handle (if it exists)
+		//	It stays dirty until ClearDirty() is called, independently of any dirty state the component itself stores
+		inline void SetDirty(Entity entity)
+		{
+			const size_t index = GetIndex(entity);
+			if (index != ~0ull)
+			{
+				dirty[index] = 1;
+			}
+		}
+
+		// Mark a component as changed by index, this is safe to call from multiple threads for different indices,
+		//	but not while other threads are reading the same index with IsDirtyIndex()
+		//	0 <= index < GetCount()
+		inline void SetDirtyIndex(size_t index) { dirty[index] = 1; }
+
+		// Check if a component was changed since the last ClearDirty()
+		//	0 <= index < GetCount()
+		inline bool IsDirtyIndex(size_t index) const { return dirty[index] != 0; }
+
+		// Check if any component was changed since the last ClearDirty()
+		inline bool IsAnyDirty() const { return std::find(dirty.begin(), dirty.end(), uint8_t(1)) != dirty.end(); }
+
+		// Reset the changed state of all components
+		inline void ClearDirty() { std::fill(dirty.begin(), dirty.end(), uint8_t(0)); }
+
+		// Retrieve the structural generation of the container
+		//	It is incremented whenever entity-components are added, removed or reordered, but not when component contents change
+		inline uint64_t GetGeneration() const { return generation; }
+
+		// Change the entity lookup implementation, the lookup table is rebuilt from the current contents
+		inline void SetLookupMode(LookupMode mode)
+		{
+			if (lookup_mode == mode)
+				return;
+			lookup_clear();
+			lookup_mode = mode;
+			lookup_reserve(entities.size());
+			for (size_t i = 0; i < entities.size(); ++i)
+			{
+				lookup_set(entities[i], i);
+			}
+		}
+
+		inline LookupMode GetLookupMode() const { return lookup_mode; }
+
 	private:
 		// This is a linear array of alive components
 		wi::vector<Component> components;
 		// This is a linear array of entities corresponding to each alive component
 		wi::vector<Entity> entities;
-		// This is a lookup table for entities
+		// This is a linear array of changed states corresponding to each alive component
+		wi::vector<uint8_t> dirty;
+		// This is incremented on every structural change
+		uint64_t generation = 0;
+		// This is a lookup table for entities (LookupMode::HASH)
 		wi::unordered_map<Entity, size_t> lookup;
+		// These are the lookup pages for entities, allocated on first use (LookupMode::PAGED)
+		static constexpr uint32_t lookup_page_shift = 12;
+		static constexpr uint32_t lookup_page_size = 1u << lookup_page_shift;
+		static constexpr uint32_t lookup_invalid = ~0u;
+		wi::vector<std::unique_ptr<uint32_t[]>> lookup_pages;
+		LookupMode lookup_mode = LookupMode::HASH;
+
+		inline size_t lookup_find(Entity entity) const
+		{
+			if (lookup_mode == LookupMode::PAGED)
+			{
+				const size_t page = entity >> lookup_page_shift;
+				if (page < lookup_pages.size() && lookup_pages[page] != nullptr)
+				{
+					const uint32_t index = lookup_pages[page][entity & (lookup_page_size - 1)];
+					if (index != lookup_invalid)
+					{
+						return index;
+					}
+				}
+				return ~0ull;
+			}
+			const auto it = lookup.find(entity);
+			if (it != lookup.end())
+			{
+				return it->second;
+			}
+			return ~0ull;
+		}
+		inline void lookup_set(Entity entity, size_t index)
+		{
+			if (lookup_mode == LookupMode::PAGED)
+			{
+				assert(index < lookup_invalid);
+				const size_t page = entity >> lookup_page_shift;
+				if (page >= lookup_pages.size())
+				{
+					lookup_pages.resize(page + 1);
+				}
+				if (lookup_pages[page] == nullptr)
+				{
+					lookup_pages[page] = std::make_unique<uint32_t[]>(lookup_page_size);
+					std::fill(lookup_pages[page].get(), lookup_pages[page].get() + lookup_page_size, lookup_invalid);
+				}
+				lookup_pages[page][entity & (lookup_page_size - 1)] = uint32_t(index);
+				return;
+			}
+			lookup[entity] = index;
+		}
+		inline void lookup_erase(Entity entity)
+		{
+			if (lookup_mode == LookupMode::PAGED)
+			{
+				const size_t page = entity >> lookup_page_shift;
+				if (page < lookup_pages.size() && lookup_pages[page] != nullptr)
+				{
+					lookup_pages[page][entity & (lookup_page_size - 1)] = lookup_invalid;
+				}
+				return;
+			}
+			lookup.erase(entity);
+		}
+		inline void lookup_clear()
+		{
+			lookup.clear();
+			lookup_pages.clear();
+		}
+		inline void lookup_reserve(size_t count)
+		{
+			if (lookup_mode == LookupMode::HASH)
+			{
+				lookup.reserve(count);
+			}
+		}
 
 		// Disallow this to be copied by mistake
 		ComponentManager(const ComponentManager&) = delete;
@@ -512,6 +680,18 @@ namespace wi::ecs
 			return it->second.version;
 		}
 
+		// Retrieve the combined structural generation of all registered component managers
+		//	Generations only grow, so any structural change in any of the managers results in a different value
+		inline uint64_t GetGeneration() const
+		{
+			uint64_t generation = 0;
+			for (auto& entry : entries)
+			{
+				generation += entry.second.component_manager->GetGeneration();
+			}
+			return generation;
+		}
+
 		// Serialize all registered component managers
 		inline void Serialize(wi::Archive& archive, EntitySerializer& seri)
 		{
@@ -112,6 +112,13 @@ namespace wi::graphics
 		// The CPU will wait until all submitted GPU work is finished execution
 		virtual void WaitForGPU() const = 0;
 
+		// Returns whether the GPU finished executing a submitted frame
+		//	frame: the value of GetFrameCount() before the corresponding SubmitCommandLists()
+		//	Frames older than the latest BUFFERCOUNT submits are always finished, because SubmitCommandLists() waits for them
+		virtual bool IsFrameCompleted(uint64_t frame) const { return frame + BUFFERCOUNT <= FRAMECOUNT; }
+		// The CPU will wait until the GPU finished executing a submitted frame (see IsFrameCompleted())
+		virtual void WaitFrame(uint64_t frame) const { if (frame < FRAMECOUNT && !IsFrameCompleted(frame)) WaitForGPU(); }
+
 		// The current PipelineState cache will be cleared. It is useful to clear this when reloading shaders, to avoid accumulating unused pipeline states
 		virtual void ClearPipelineStateCache() = 0;
 
@@ -5847,6 +5847,41 @@ std::mutex queue_locker;
 			fence->Signal(0);
 		}
 	}
+	bool GraphicsDevice_DX12::IsFrameCompleted(uint64_t frame) const
+	{
+		if (frame >= FRAMECOUNT)
+			return false; // not submitted yet
+		if (frame + BUFFERCOUNT <= FRAMECOUNT)
+			return true; // SubmitCommandLists() already waited for it
+
+		const uint32_t bufferindex = frame % BUFFERCOUNT;
+		for (int queue = 0; queue < QUEUE_COUNT; ++queue)
+		{
+			if (queues[queue].queue == nullptr)
+				continue;
+			if (frame_fence[bufferindex][queue]->GetCompletedValue() < 1)
+				return false;
+		}
+		return true;
+	}
+	void GraphicsDevice_DX12::WaitFrame(uint64_t frame) const
+	{
+		if (frame >= FRAMECOUNT || frame + BUFFERCOUNT <= FRAMECOUNT)
+			return;
+
+		const uint32_t bufferindex = frame % BUFFERCOUNT;
+		for (int queue = 0; queue < QUEUE_COUNT; ++queue)
+		{
+			if (queues[queue].queue == nullptr)
+				continue;
+			if (frame_fence[bufferindex][queue]->GetCompletedValue() < 1)
+			{
+				// NULL event handle will simply wait immediately
+				HRESULT hr = frame_fence[bufferindex][queue]->SetEventOnCompletion(1, NULL);
+				assert(SUCCEEDED(hr));
+			}
+		}
+	}
 
 	void GraphicsDevice_DX12::ClearPipelineStateCache()
 	{
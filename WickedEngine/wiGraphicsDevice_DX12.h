@@ -313,6 +313,8 @@ namespace wi::graphics
 		void OnDeviceRemoved();
 
 		void WaitForGPU() const override;
+		bool IsFrameCompleted(uint64_t frame) const override;
+		void WaitFrame(uint64_t frame) const override;
 		void ClearPipelineStateCache() override;
 		size_t GetActivePipelineCount() const override { return pipelines_global.size(); }
 
@@ -2441,8 +2441,9 @@ using namespace vulkan_internal;
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
 		instanceExtensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
 #elif SDL2
+		if (window != nullptr) // headless devices have no surface to present to
 		{
-			uint32_t extensionCount;
+			uint32_t extensionCount = 0;
 			SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, nullptr);
 			wi::vector<const char *> extensionNames_sdl(extensionCount);
 			SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, extensionNames_sdl.data());
@@ -7355,6 +7356,38 @@ using namespace vulkan_internal;
 		VkResult res = vkDeviceWaitIdle(device);
 		assert(res == VK_SUCCESS);
 	}
+	bool GraphicsDevice_Vulkan::IsFrameCompleted(uint64_t frame) const
+	{
+		if (frame >= FRAMECOUNT)
+			return false; // not submitted yet
+		if (frame + BUFFERCOUNT <= FRAMECOUNT)
+			return true; // SubmitCommandLists() already waited for it
+
+		const uint32_t bufferindex = frame % BUFFERCOUNT;
+		for (int queue = 0; queue < QUEUE_COUNT; ++queue)
+		{
+			if (frame_fence[bufferindex][queue] == VK_NULL_HANDLE)
+				continue;
+			if (vkGetFenceStatus(device, frame_fence[bufferindex][queue]) != VK_SUCCESS)
+				return false;
+		}
+		return true;
+	}
+	void GraphicsDevice_Vulkan::WaitFrame(uint64_t frame) const
+	{
+		if (frame >= FRAMECOUNT || frame + BUFFERCOUNT <= FRAMECOUNT)
+			return;
+
+		const uint32_t bufferindex = frame % BUFFERCOUNT;
+		for (int queue = 0; queue < QUEUE_COUNT; ++queue)
+		{
+			if (frame_fence[bufferindex][queue] == VK_NULL_HANDLE)
+				continue;
+			// the fence is not reset here, SubmitCommandLists() will do it when the buffer is reused
+			VkResult res = vkWaitForFences(device, 1, &frame_fence[bufferindex][queue], VK_TRUE, 0xFFFFFFFFFFFFFFFF);
+			assert(res == VK_SUCCESS);
+		}
+	}
 	void GraphicsDevice_Vulkan::ClearPipelineStateCache()
 	{
 		allocationhandler->destroylocker.lock();
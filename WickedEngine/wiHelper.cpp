@@ -24,6 +24,10 @@
 
 #ifdef PLATFORM_LINUX
 #include <sys/sysinfo.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 #if defined(_WIN32)
@@ -1036,6 +1040,68 @@ namespace wi::helper
 	}
 #endif // WI_VECTOR_TYPE
 
+	bool FileMap(const std::string& fileName, MappedFile& mapped)
+	{
+		mapped = {};
+#if defined(PLATFORM_WINDOWS_DESKTOP)
+		HANDLE file = CreateFileW(ToNativeString(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			wi::backlog::post("File not found: " + fileName, wi::backlog::LogLevel::Warning);
+			return false;
+		}
+		LARGE_INTEGER fileSize = {};
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		CloseHandle(file); // the mapping keeps the file open
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping); // the view keeps the mapping alive
+		if (view == nullptr)
+		{
+			return false;
+		}
+		mapped.data = (const uint8_t*)view;
+		mapped.size = (size_t)fileSize.QuadPart;
+		mapped.internal_state = std::shared_ptr<void>(view, [](void* view) { UnmapViewOfFile(view); });
+		return true;
+#elif defined(PLATFORM_LINUX)
+		std::string filepath = fileName;
+		std::replace(filepath.begin(), filepath.end(), '\\', '/'); // Linux cannot handle backslash in file path, need to convert it to forward slash
+		int fd = open(filepath.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			wi::backlog::post("File not found: " + fileName, wi::backlog::LogLevel::Warning);
+			return false;
+		}
+		struct stat st = {};
+		void* view = MAP_FAILED;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		close(fd); // the mapping keeps the file open
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+		madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+		const size_t size = (size_t)st.st_size;
+		mapped.data = (const uint8_t*)view;
+		mapped.size = size;
+		mapped.internal_state = std::shared_ptr<void>(view, [size](void* view) { munmap(view, size); });
+		return true;
+#else
+		return false;
+#endif // PLATFORM_WINDOWS_DESKTOP
+	}
+
 	bool FileWrite(const std::string& fileName, const uint8_t* data, size_t size)
 	{
 		if (size <= 0)
@@ -1462,6 +1528,7 @@ namespace wi::helper
 		GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc));
 		mem.process_physical = pmc.WorkingSetSize;
 		mem.process_virtual = pmc.PrivateUsage;
+		mem.process_physical_peak = pmc.PeakWorkingSetSize;
 #elif defined(PLATFORM_LINUX)
 		struct sysinfo info;
 		constexpr int PAGE_SIZE = 4096;
@@ -1482,6 +1549,18 @@ namespace wi::helper
 		statm >> l;
 		statm >> l;
 		mem.process_physical = l * PAGE_SIZE;
+
+		// the peak resident size is the "VmHWM" line of status (in kB)
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line))
+		{
+			if (line.compare(0, 6, "VmHWM:") == 0)
+			{
+				mem.process_physical_peak = std::stoull(line.substr(6)) * 1024ull;
+				break;
+			}
+		}
 		// there doesn't seem to be an easy way to determine
 		// swapped out memory
 #elif defined(PLATFORM_PS5)
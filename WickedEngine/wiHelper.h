@@ -5,6 +5,7 @@
 
 #include <string>
 #include <functional>
+#include <memory>
 
 #if WI_VECTOR_TYPE
 namespace std
@@ -94,6 +95,19 @@ namespace wi::helper
 	bool FileRead(const std::string& fileName, std::vector<uint8_t>& data, size_t max_read = ~0ull, size_t offset = 0);
 #endif // WI_VECTOR_TYPE
 
+	// Read-only memory mapping of a file, the mapping is kept alive while any copy of the object is alive
+	struct MappedFile
+	{
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		std::shared_ptr<void> internal_state;
+		constexpr bool IsValid() const { return data != nullptr; }
+	};
+
+	// Map the whole file into memory for reading, the pages are only loaded by the OS when they are accessed
+	//	returns false if the file can't be mapped on this platform (FileRead can be used instead)
+	bool FileMap(const std::string& fileName, MappedFile& mapped);
+
 	bool FileWrite(const std::string& fileName, const uint8_t* data, size_t size);
 
 	bool FileExists(const std::string& fileName);
@@ -169,6 +183,7 @@ namespace wi::helper
 		uint64_t total_virtual = 0;		// size of virtual address space on whole system (in bytes)
 		uint64_t process_physical = 0;	// size of currently committed physical memory by application (in bytes)
 		uint64_t process_virtual = 0;	// size of currently mapped virtual memory by application (in bytes)
+		uint64_t process_physical_peak = 0;	// peak of committed physical memory by application since it started (in bytes)
 	};
 	MemoryUsage GetMemoryUsage();
 
@@ -3,6 +3,7 @@
 #include "wiBacklog.h"
 #include "wiPlatform.h"
 #include "wiTimer.h"
+#include "wiAllocator.h"
 
 #include <memory>
 #include <algorithm>
@@ -23,18 +24,24 @@
 
 namespace wi::jobsystem
 {
+	// A job is shared by all the groups of a Dispatch():
+	//	multiple threads can hold a reference to it, and they take groups from it until none are left
 	struct Job
 	{
-		std::function<void(JobArgs)> task;
-		context* ctx;
-		uint32_t groupID;
-		uint32_t groupJobOffset;
-		uint32_t groupJobEnd;
-		uint32_t sharedmemory_size;
-		inline void execute()
+		JobFunction task;
+		context* ctx = nullptr;
+		uint32_t jobCount = 0;
+		uint32_t groupSize = 0;
+		uint32_t groupCount = 0;
+		uint32_t sharedmemory_size = 0;
+		std::atomic<uint32_t> nextGroup{ 0 };
+		std::atomic<uint32_t> refCount{ 0 };
+
+		// Execute groups until none are left
+		//	Returns true if this released the last reference to the job
+		inline bool execute()
 		{
 			JobArgs args;
-			args.groupID = groupID;
 			if (sharedmemory_size > 0)
 			{
 				args.sharedmemory = alloca(sharedmemory_size);
@@ -44,64 +51,265 @@ namespace wi::jobsystem
 				args.sharedmemory = nullptr;
 			}
 
-			for (uint32_t j = groupJobOffset; j < groupJobEnd; ++j)
+			uint32_t groupID = nextGroup.fetch_add(1);
+			while (groupID < groupCount)
 			{
-				args.jobIndex = j;
-				args.groupIndex = j - groupJobOffset;
-				args.isFirstJobInGroup = (j == groupJobOffset);
-				args.isLastJobInGroup = (j == groupJobEnd - 1);
-				task(args);
+				const uint32_t groupJobOffset = groupID * groupSize;
+				const uint32_t groupJobEnd = std::min(groupJobOffset + groupSize, jobCount);
+				args.groupID = groupID;
+				for (uint32_t j = groupJobOffset; j < groupJobEnd; ++j)
+				{
+					args.jobIndex = j;
+					args.groupIndex = j - groupJobOffset;
+					args.isFirstJobInGroup = (j == groupJobOffset);
+					args.isLastJobInGroup = (j == groupJobEnd - 1);
+					task(args);
+				}
+
+				AtomicAdd(&ctx->counter, -1);
+				groupID = nextGroup.fetch_add(1);
 			}
 
-			AtomicAdd(&ctx->counter, -1);
+			return refCount.fetch_sub(1) == 1;
 		}
 	};
-	struct JobQueue
+
+	// Pool of jobs, so that dispatching doesn't allocate memory after warming up
+	struct JobAllocator
 	{
-		std::deque<Job> queue;
-		std::mutex locker;
+		wi::SpinLock locker;
+		wi::allocator::BlockAllocator<Job, 256> allocator;
 
-		inline void push_back(const Job& item)
+		inline Job* allocate()
 		{
 			std::scoped_lock lock(locker);
-			queue.push_back(item);
+			return allocator.allocate();
 		}
-		inline bool pop_front(Job& item)
+		inline void free(Job* job)
 		{
+			job->task.reset(); // the task is destroyed outside of the lock
+			std::scoped_lock lock(locker);
+			allocator.free(job);
+		}
+	};
+
+	// Lock-free work stealing deque (Chase-Lev)
+	//	The owner thread pushes and pops at the bottom (LIFO), other threads steal from the top (FIFO)
+	//	Based on: Correct and Efficient Work-Stealing for Weak Memory Models (Le, Pop, Cohen, Zappa Nardelli)
+	class JobQueue
+	{
+		struct Ring
+		{
+			int64_t capacity = 0;
+			std::unique_ptr<std::atomic<Job*>[]> items;
+
+			Ring(int64_t capacity) : capacity(capacity), items(new std::atomic<Job*>[capacity]) {}
+			// Release/acquire on the items, so that the job data written before push() is visible to the stealing thread:
+			inline Job* get(int64_t index) const { return items[index & (capacity - 1)].load(std::memory_order_acquire); }
+			inline void put(int64_t index, Job* job) { items[index & (capacity - 1)].store(job, std::memory_order_release); }
+		};
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+		std::atomic<Ring*> ring{ nullptr };
+		wi::vector<std::unique_ptr<Ring>> rings; // old rings are kept alive because stealing threads could still read them
+
+	public:
+		JobQueue()
+		{
+			rings.emplace_back(new Ring(256));
+			ring.store(rings.back().get());
+		}
+
+		// Only the owner thread can push
+		inline void push(Job* job)
+		{
+			const int64_t b = bottom.load(std::memory_order_relaxed);
+			const int64_t t = top.load(std::memory_order_acquire);
+			Ring* r = ring.load(std::memory_order_relaxed);
+			if (b - t > r->capacity - 1)
+			{
+				// Full, grow:
+				Ring* grown = new Ring(r->capacity * 2);
+				for (int64_t i = t; i < b; ++i)
+				{
+					grown->put(i, r->get(i));
+				}
+				rings.emplace_back(grown);
+				r = grown;
+				ring.store(r, std::memory_order_release);
+			}
+			r->put(b, job);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		// Only the owner thread can pop
+		inline Job* pop()
+		{
+			const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			Ring* r = ring.load(std::memory_order_relaxed);
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_relaxed);
+			Job* job = nullptr;
+			if (t <= b)
+			{
+				job = r->get(b);
+				if (t == b)
+				{
+					// Last item, race against stealing threads:
+					if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						job = nullptr;
+					}
+					bottom.store(b + 1, std::memory_order_relaxed);
+				}
+			}
+			else
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		// Any thread can steal
+		inline Job* steal()
+		{
+			int64_t t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t b = bottom.load(std::memory_order_acquire);
+			while (t < b)
+			{
+				Ring* r = ring.load(std::memory_order_acquire);
+				Job* job = r->get(t);
+				if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					return job;
+				}
+				// Lost the race, t was reloaded by compare_exchange:
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				b = bottom.load(std::memory_order_acquire);
+			}
+			return nullptr;
+		}
+	};
+
+	// Queue for threads that don't own a JobQueue
+	struct SharedJobQueue
+	{
+		std::deque<Job*> queue;
+		wi::SpinLock locker;
+		std::atomic<uint32_t> count{ 0 };
+
+		inline void push(Job* job, uint32_t refs)
+		{
+			std::scoped_lock lock(locker);
+			for (uint32_t i = 0; i < refs; ++i)
+			{
+				queue.push_back(job);
+			}
+			count.fetch_add(refs);
+		}
+		inline Job* pop()
+		{
+			if (count.load(std::memory_order_relaxed) == 0)
+			{
+				return nullptr;
+			}
 			std::scoped_lock lock(locker);
 			if (queue.empty())
 			{
-				return false;
+				return nullptr;
 			}
-			item = std::move(queue.front());
+			Job* job = queue.front();
 			queue.pop_front();
-			return true;
+			count.fetch_sub(1);
+			return job;
 		}
 	};
+
+	// The JobQueue that the current thread owns for each priority (nullptr if it doesn't own one)
+	static thread_local JobQueue* thread_queues[int(Priority::Count)] = {};
+
 	struct PriorityResources
 	{
+		Priority priority = Priority::High;
 		uint32_t numThreads = 0;
 		wi::vector<std::thread> threads;
-		std::unique_ptr<JobQueue[]> jobQueuePerThread;
+		std::unique_ptr<JobQueue[]> jobQueuePerThread; // numThreads + 1, the last one is owned by the thread that initialized the job system
+		SharedJobQueue sharedQueue;
+		std::atomic<uint32_t> pending{ 0 }; // number of job references waiting in queues
 		std::atomic<uint32_t> nextQueue{ 0 };
 		std::condition_variable wakeCondition;
 		std::mutex wakeMutex;
 
-		// Start working on a job queue
-		//	After the job queue is finished, it can switch to an other queue and steal jobs from there
-		inline void work(uint32_t startingQueue)
+		// Look for a job: own queue first, then the shared queue, and steal from other threads at last
+		inline Job* find(uint32_t startingQueue)
 		{
-			Job job;
-			for (uint32_t i = 0; i < numThreads; ++i)
+			if (pending.load(std::memory_order_relaxed) == 0)
+			{
+				return nullptr;
+			}
+			JobQueue* own = thread_queues[int(priority)];
+			Job* job = nullptr;
+			if (own != nullptr)
 			{
-				JobQueue& job_queue = jobQueuePerThread[startingQueue % numThreads];
-				while (job_queue.pop_front(job))
+				job = own->pop();
+			}
+			if (job == nullptr)
+			{
+				job = sharedQueue.pop();
+			}
+			const uint32_t queueCount = numThreads + 1;
+			for (uint32_t i = 0; i < queueCount && job == nullptr; ++i)
+			{
+				JobQueue& victim = jobQueuePerThread[(startingQueue + i) % queueCount];
+				if (&victim != own)
+				{
+					job = victim.steal();
+				}
+			}
+			if (job != nullptr)
+			{
+				pending.fetch_sub(1);
+			}
+			return job;
+		}
+
+		// Add references to a job to the queues and wake up worker threads
+		inline void submit(Job* job, uint32_t refs)
+		{
+			job->refCount.store(refs);
+			JobQueue* own = thread_queues[int(priority)];
+			if (own != nullptr)
+			{
+				for (uint32_t i = 0; i < refs; ++i)
 				{
-					job.execute();
+					own->push(job);
 				}
-				startingQueue++; // go to next queue
+			}
+			else
+			{
+				sharedQueue.push(job, refs);
+			}
+			pending.fetch_add(refs);
+
+			{
+				// Empty lock, so that a worker can't miss the wake up between checking pending jobs and going to sleep
+				std::scoped_lock lock(wakeMutex);
+			}
+			if (refs > 1)
+			{
+				wakeCondition.notify_all();
+			}
+			else
+			{
+				wakeCondition.notify_one();
 			}
 		}
+
+		// Start working on jobs, until there are no more available
+		inline void work(uint32_t startingQueue);
 	};
 
 	static bool alreadyShutDown = false;
@@ -110,6 +318,7 @@ namespace wi::jobsystem
 	struct InternalState
 	{
 		uint32_t numCores = 0;
+		JobAllocator jobAllocator;
 		PriorityResources resources[int(Priority::Count)];
 		std::atomic_bool alive{ true };
 		void ShutDown()
@@ -141,6 +350,10 @@ namespace wi::jobsystem
 				x.threads.clear();
 				x.numThreads = 0;
 			}
+			for (auto& x : thread_queues)
+			{
+				x = nullptr;
+			}
 			numCores = 0;
 		}
 		~InternalState()
@@ -152,6 +365,19 @@ namespace wi::jobsystem
 		}
 	} static internal_state;
 
+	inline void PriorityResources::work(uint32_t startingQueue)
+	{
+		Job* job = find(startingQueue);
+		while (job != nullptr)
+		{
+			if (job->execute())
+			{
+				internal_state.jobAllocator.free(job);
+			}
+			job = find(startingQueue);
+		}
+	}
+
 	void Initialize(uint32_t maxThreadCount)
 	{
 		if (internal_state.numCores > 0)
@@ -162,6 +388,8 @@ namespace wi::jobsystem
 
 		// Retrieve the number of hardware threads in this system:
 		internal_state.numCores = std::thread::hardware_concurrency();
+		internal_state.alive.store(true);
+		alreadyShutDown = false;
 
 		for (int prio = 0; prio < int(Priority::Count); ++prio)
 		{
@@ -175,7 +403,7 @@ namespace wi::jobsystem
 				res.numThreads = internal_state.numCores - 1; // -1 for main thread
 				break;
 			case Priority::Low:
-				res.numThreads = internal_state.numCores - 2; // -1 for main thread, -1 for streaming
+				res.numThreads = internal_state.numCores - std::min(internal_state.numCores, 2u); // -1 for main thread, -1 for streaming (clamped to at least 1 below)
 				break;
 			case Priority::Streaming:
 				res.numThreads = 1;
@@ -184,10 +412,14 @@ namespace wi::jobsystem
 				assert(0);
 				break;
 			}
+			res.priority = priority;
 			res.numThreads = clamp(res.numThreads, 1u, maxThreadCount);
-			res.jobQueuePerThread.reset(new JobQueue[res.numThreads]);
+			res.jobQueuePerThread.reset(new JobQueue[res.numThreads + 1]);
 			res.threads.reserve(res.numThreads);
 
+			// The initializing thread owns the last queue:
+			thread_queues[prio] = &res.jobQueuePerThread[res.numThreads];
+
 			for (uint32_t threadID = 0; threadID < res.numThreads; ++threadID)
 			{
 #ifdef PLATFORM_LINUX
@@ -217,13 +449,15 @@ namespace wi::jobsystem
 #else
 				std::thread& worker = res.threads.emplace_back([threadID, &res] {
 #endif
+					thread_queues[int(res.priority)] = &res.jobQueuePerThread[threadID];
+
 					while (internal_state.alive.load())
 					{
 						res.work(threadID);
 
 						// finished with jobs, put to sleep
 						std::unique_lock<std::mutex> lock(res.wakeMutex);
-						res.wakeCondition.wait(lock);
+						res.wakeCondition.wait(lock, [&res] { return res.pending.load() > 0 || !internal_state.alive.load(); });
 					}
 
 				});
@@ -334,33 +568,12 @@ namespace wi::jobsystem
 		return internal_state.resources[int(priority)].numThreads;
 	}
 
-	void Execute(context& ctx, const std::function<void(JobArgs)>& task)
+	void Execute(context& ctx, JobFunction task)
 	{
-		PriorityResources& res = internal_state.resources[int(ctx.priority)];
-
-		// Context state is updated:
-		AtomicAdd(&ctx.counter, 1);
-
-		Job job;
-		job.ctx = &ctx;
-		job.task = task;
-		job.groupID = 0;
-		job.groupJobOffset = 0;
-		job.groupJobEnd = 1;
-		job.sharedmemory_size = 0;
-
-		if (res.numThreads < 1)
-		{
-			// If job system is not yet initialized, job will be executed immediately here instead of thread:
-			job.execute();
-			return;
-		}
-
-		res.jobQueuePerThread[res.nextQueue.fetch_add(1) % res.numThreads].push_back(job);
-		res.wakeCondition.notify_one();
+		Dispatch(ctx, 1, 1, std::move(task));
 	}
 
-	void Dispatch(context& ctx, uint32_t jobCount, uint32_t groupSize, const std::function<void(JobArgs)>& task, size_t sharedmemory_size)
+	void Dispatch(context& ctx, uint32_t jobCount, uint32_t groupSize, JobFunction task, size_t sharedmemory_size)
 	{
 		if (jobCount == 0 || groupSize == 0)
 		{
@@ -373,33 +586,31 @@ namespace wi::jobsystem
 		// Context state is updated:
 		AtomicAdd(&ctx.counter, groupCount);
 
-		Job job;
-		job.ctx = &ctx;
-		job.task = task;
-		job.sharedmemory_size = (uint32_t)sharedmemory_size;
-
-		for (uint32_t groupID = 0; groupID < groupCount; ++groupID)
+		if (res.numThreads < 1)
 		{
-			// For each group, generate one real job:
-			job.groupID = groupID;
-			job.groupJobOffset = groupID * groupSize;
-			job.groupJobEnd = std::min(job.groupJobOffset + groupSize, jobCount);
-
-			if (res.numThreads < 1)
-			{
-				// If job system is not yet initialized, job will be executed immediately here instead of thread:
-				job.execute();
-			}
-			else
-			{
-				res.jobQueuePerThread[res.nextQueue.fetch_add(1) % res.numThreads].push_back(job);
-			}
+			// If job system is not yet initialized, job will be executed immediately here instead of thread:
+			Job job;
+			job.task = std::move(task);
+			job.ctx = &ctx;
+			job.jobCount = jobCount;
+			job.groupSize = groupSize;
+			job.groupCount = groupCount;
+			job.sharedmemory_size = (uint32_t)sharedmemory_size;
+			job.refCount.store(1);
+			job.execute();
+			return;
 		}
 
-		if (res.numThreads > 1)
-		{
-			res.wakeCondition.notify_all();
-		}
+		// One job is shared by all groups, and referenced as many times as threads can work on it:
+		Job* job = internal_state.jobAllocator.allocate();
+		job->task = std::move(task);
+		job->ctx = &ctx;
+		job->jobCount = jobCount;
+		job->groupSize = groupSize;
+		job->groupCount = groupCount;
+		job->sharedmemory_size = (uint32_t)sharedmemory_size;
+		job->nextGroup.store(0);
+		res.submit(job, std::min(groupCount, res.numThreads + 1));
 	}
 
 	uint32_t DispatchGroupCount(uint32_t jobCount, uint32_t groupSize)
@@ -423,17 +634,75 @@ namespace wi::jobsystem
 			// Wake any threads that might be sleeping:
 			res.wakeCondition.notify_all();
 
-			// work() will pick up any jobs that are on stand by and execute them on this thread:
-			res.work(res.nextQueue.fetch_add(1) % res.numThreads);
-
+			const uint32_t startingQueue = res.nextQueue.fetch_add(1);
 			while (IsBusy(ctx))
 			{
-				// If we are here, then there are still remaining jobs that work() couldn't pick up.
-				//	In this case those jobs are not standing by on a queue but currently executing
-				//	on other threads, so they cannot be picked up by this thread.
-				//	Allow to swap out this thread by OS to not spin endlessly for nothing
-				std::this_thread::yield();
+				// work() will pick up any jobs that are on stand by and execute them on this thread:
+				res.work(startingQueue);
+
+				if (IsBusy(ctx))
+				{
+					// If we are here, then there are still remaining jobs that work() couldn't pick up.
+					//	In this case those jobs are not standing by on a queue but currently executing
+					//	on other threads, so they cannot be picked up by this thread.
+					//	Allow to swap out this thread by OS to not spin endlessly for nothing
+					std::this_thread::yield();
+				}
+			}
+		}
+	}
+
+	uint32_t TaskGraph::Add(TaskFunction&& task, std::initializer_list<uint32_t> dependencies)
+	{
+		const uint32_t index = (uint32_t)tasks.size();
+		Task& dst = tasks.emplace_back();
+		dst.function = std::move(task);
+		for (uint32_t dependency : dependencies)
+		{
+			assert(dependency < index); // dependency must be added before
+			tasks[dependency].successors.push_back(index);
+			dst.dependencyCount++;
+		}
+		return index;
+	}
+
+	void TaskGraph::Run(context& ctx)
+	{
+		for (Task& task : tasks)
+		{
+			task.remaining = (long)task.dependencyCount;
+			task.ctx.counter = 0;
+			task.ctx.priority = ctx.priority;
+		}
+		// All counters must be reset before any task is started, because a task that finishes starts its successors:
+		for (uint32_t i = 0; i < (uint32_t)tasks.size(); ++i)
+		{
+			if (tasks[i].dependencyCount == 0)
+			{
+				Launch(ctx, i);
 			}
 		}
 	}
+
+	void TaskGraph::Clear()
+	{
+		tasks.clear();
+	}
+
+	void TaskGraph::Launch(context& ctx, uint32_t index)
+	{
+		// The successors are started from within this job, so ctx remains busy until the whole graph finished:
+		Execute(ctx, [this, &ctx, index](JobArgs args) {
+			Task& task = tasks[index];
+			task.function(task.ctx);
+			Wait(task.ctx);
+			for (uint32_t successor : task.successors)
+			{
+				if (AtomicAdd(&tasks[successor].remaining, -1) == 1)
+				{
+					Launch(ctx, successor);
+				}
+			}
+		});
+	}
 }
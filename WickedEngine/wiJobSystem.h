@@ -1,7 +1,13 @@
 #pragma once
+#include "wiVector.h"
 
 #include <functional>
 #include <atomic>
+#include <new>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
 
 namespace wi::jobsystem
 {
@@ -18,6 +24,91 @@ namespace wi::jobsystem
 		void* sharedmemory;		// stack memory shared within the current group (jobs within a group execute serially)
 	};
 
+	// Type erased job function with small buffer storage
+	//	Callables that fit into the inline storage (for example lambdas capturing by reference) are stored without heap allocation
+	class JobFunction
+	{
+	public:
+		JobFunction() = default;
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, JobFunction>>>
+		JobFunction(F&& func)
+		{
+			using T = std::decay_t<F>;
+			if constexpr (sizeof(T) <= sizeof(storage) && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>)
+			{
+				new (storage) T(std::forward<F>(func));
+				invoke = [](void* data, JobArgs args) { (*(T*)data)(args); };
+				manage = [](void* dst, void* src) {
+					if (dst != nullptr)
+					{
+						new (dst) T(std::move(*(T*)src));
+					}
+					((T*)src)->~T();
+				};
+			}
+			else
+			{
+				// Large callable falls back to heap allocation:
+				*(T**)storage = new T(std::forward<F>(func));
+				invoke = [](void* data, JobArgs args) { (**(T**)data)(args); };
+				manage = [](void* dst, void* src) {
+					if (dst != nullptr)
+					{
+						*(T**)dst = *(T**)src;
+					}
+					else
+					{
+						delete *(T**)src;
+					}
+				};
+			}
+		}
+		JobFunction(JobFunction&& other) noexcept { move_from(other); }
+		JobFunction& operator=(JobFunction&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				move_from(other);
+			}
+			return *this;
+		}
+		JobFunction(const JobFunction&) = delete;
+		JobFunction& operator=(const JobFunction&) = delete;
+		~JobFunction() { reset(); }
+
+		inline void operator()(JobArgs args) { invoke(storage, args); }
+		inline bool IsValid() const { return invoke != nullptr; }
+
+		// Destroy the stored callable
+		inline void reset()
+		{
+			if (manage != nullptr)
+			{
+				manage(nullptr, storage);
+			}
+			invoke = nullptr;
+			manage = nullptr;
+		}
+
+	private:
+		alignas(std::max_align_t) uint8_t storage[64];
+		void(*invoke)(void* data, JobArgs args) = nullptr;
+		void(*manage)(void* dst, void* src) = nullptr; // moves src to dst, or destroys src if dst is nullptr
+
+		inline void move_from(JobFunction& other)
+		{
+			if (other.manage != nullptr)
+			{
+				other.manage(storage, other.storage);
+			}
+			invoke = other.invoke;
+			manage = other.manage;
+			other.invoke = nullptr;
+			other.manage = nullptr;
+		}
+	};
+
 	enum class Priority
 	{
 		High,		// Default
@@ -36,13 +127,13 @@ namespace wi::jobsystem
 	uint32_t GetThreadCount(Priority priority = Priority::High);
 
 	// Add a task to execute asynchronously. Any idle thread will execute this.
-	void Execute(context& ctx, const std::function<void(JobArgs)>& task);
+	void Execute(context& ctx, JobFunction task);
 
 	// Divide a task onto multiple jobs and execute in parallel.
 	//	jobCount	: how many jobs to generate for this task.
 	//	groupSize	: how many jobs to execute per thread. Jobs inside a group execute serially. It might be worth to increase for small jobs
 	//	task		: receives a JobArgs as parameter
-	void Dispatch(context& ctx, uint32_t jobCount, uint32_t groupSize, const std::function<void(JobArgs)>& task, size_t sharedmemory_size = 0);
+	void Dispatch(context& ctx, uint32_t jobCount, uint32_t groupSize, JobFunction task, size_t sharedmemory_size = 0);
 
 	// Returns the amount of job groups that will be created for a set number of jobs and group size
 	uint32_t DispatchGroupCount(uint32_t jobCount, uint32_t groupSize);
@@ -53,4 +144,40 @@ namespace wi::jobsystem
 	// Wait until all threads become idle
 	//	Current thread will become a worker thread, executing jobs
 	void Wait(const context& ctx);
+
+	// Graph of tasks with dependencies between them
+	//	A task is started as soon as all of its dependencies finished, instead of waiting for every earlier task like Wait() does
+	//	Every task receives its own context to put jobs on, and the task is only finished when those jobs are finished too
+	class TaskGraph
+	{
+	public:
+		using TaskFunction = std::function<void(context& ctx)>;
+
+		// Add a task that will start after all of its dependencies finished
+		//	dependencies	: tasks that were returned by earlier Add() calls (so the graph can't contain cycles)
+		//	returns the task that can be used as dependency for later tasks
+		uint32_t Add(TaskFunction&& task, std::initializer_list<uint32_t> dependencies = {});
+
+		// Start executing the tasks, ctx will be busy until all of them finished
+		//	The graph must not be modified or destroyed while ctx is busy
+		void Run(context& ctx);
+
+		// Remove all tasks, but keep the memory for reuse
+		void Clear();
+
+		inline size_t GetTaskCount() const { return tasks.size(); }
+
+	private:
+		struct Task
+		{
+			TaskFunction function;
+			wi::vector<uint32_t> successors;
+			uint32_t dependencyCount = 0;
+			volatile long remaining = 0; // dependencies that didn't finish yet
+			context ctx;
+		};
+		wi::vector<Task> tasks;
+
+		void Launch(context& ctx, uint32_t task);
+	};
 }
@@ -1,5 +1,9 @@
 #include "wiPrimitive.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif // __AVX2__
+
 namespace wi::primitive
 {
 
@@ -853,6 +857,30 @@ namespace wi::primitive
 			return(BOX_FRUSTUM_INSIDE);
 		return(BOX_FRUSTUM_INTERSECTS);
 	}
+	void AABBStream::resize(size_t newCount)
+	{
+		count = (uint32_t)newCount;
+		const size_t padded = (newCount + WIDTH - 1) / WIDTH * WIDTH;
+		min_x.resize(padded);
+		min_y.resize(padded);
+		min_z.resize(padded);
+		max_x.resize(padded);
+		max_y.resize(padded);
+		max_z.resize(padded);
+		layerMask.resize(padded);
+		const AABB invalid;
+		for (size_t i = newCount; i < padded; ++i)
+		{
+			min_x[i] = invalid._min.x;
+			min_y[i] = invalid._min.y;
+			min_z[i] = invalid._min.z;
+			max_x[i] = invalid._max.x;
+			max_y[i] = invalid._max.y;
+			max_z[i] = invalid._max.z;
+			layerMask[i] = 0;
+		}
+	}
+
 	bool Frustum::CheckBoxFast(const AABB& box) const
 	{
 		if (!box.IsValid())
@@ -873,6 +901,89 @@ namespace wi::primitive
 		return true;
 	}
 
+	uint32_t Frustum::CheckBoxesFast(const AABBStream& stream, uint32_t layerMask, uint32_t begin, uint32_t end, uint32_t* visible) const
+	{
+		assert(begin % AABBStream::WIDTH == 0);
+		assert(end <= stream.count);
+
+		// The sign of the plane normal selects the box corner that is furthest along it, this is the same for all boxes:
+		const float* corner_x[6];
+		const float* corner_y[6];
+		const float* corner_z[6];
+		for (int p = 0; p < 6; ++p)
+		{
+			corner_x[p] = planes[p].x < 0 ? stream.min_x.data() : stream.max_x.data();
+			corner_y[p] = planes[p].y < 0 ? stream.min_y.data() : stream.max_y.data();
+			corner_z[p] = planes[p].z < 0 ? stream.min_z.data() : stream.max_z.data();
+		}
+
+		uint32_t count = 0;
+		for (uint32_t i = begin; i < end; i += AABBStream::WIDTH)
+		{
+			uint32_t mask = 0;
+
+#if defined(__AVX2__)
+			const __m256 min_x = _mm256_loadu_ps(stream.min_x.data() + i);
+			const __m256 min_y = _mm256_loadu_ps(stream.min_y.data() + i);
+			const __m256 min_z = _mm256_loadu_ps(stream.min_z.data() + i);
+			const __m256 max_x = _mm256_loadu_ps(stream.max_x.data() + i);
+			const __m256 max_y = _mm256_loadu_ps(stream.max_y.data() + i);
+			const __m256 max_z = _mm256_loadu_ps(stream.max_z.data() + i);
+			__m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(min_x, max_x, _CMP_LE_OQ), _mm256_cmp_ps(min_y, max_y, _CMP_LE_OQ)), _mm256_cmp_ps(min_z, max_z, _CMP_LE_OQ));
+			const __m256i layers = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(stream.layerMask.data() + i)), _mm256_set1_epi32((int)layerMask));
+			inside = _mm256_andnot_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(layers, _mm256_setzero_si256())), inside);
+			for (int p = 0; p < 6; ++p)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_set1_ps(planes[p].w), _mm256_mul_ps(_mm256_set1_ps(planes[p].x), _mm256_loadu_ps(corner_x[p] + i)));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p].y), _mm256_loadu_ps(corner_y[p] + i)));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p].z), _mm256_loadu_ps(corner_z[p] + i)));
+				inside = _mm256_andnot_ps(_mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ), inside);
+			}
+			mask = (uint32_t)_mm256_movemask_ps(inside);
+#else
+			for (uint32_t half = 0; half < AABBStream::WIDTH; half += 4)
+			{
+				const uint32_t j = i + half;
+				const XMVECTOR min_x = XMLoadFloat4((const XMFLOAT4*)(stream.min_x.data() + j));
+				const XMVECTOR min_y = XMLoadFloat4((const XMFLOAT4*)(stream.min_y.data() + j));
+				const XMVECTOR min_z = XMLoadFloat4((const XMFLOAT4*)(stream.min_z.data() + j));
+				const XMVECTOR max_x = XMLoadFloat4((const XMFLOAT4*)(stream.max_x.data() + j));
+				const XMVECTOR max_y = XMLoadFloat4((const XMFLOAT4*)(stream.max_y.data() + j));
+				const XMVECTOR max_z = XMLoadFloat4((const XMFLOAT4*)(stream.max_z.data() + j));
+				XMVECTOR inside = XMVectorAndInt(XMVectorAndInt(XMVectorLessOrEqual(min_x, max_x), XMVectorLessOrEqual(min_y, max_y)), XMVectorLessOrEqual(min_z, max_z));
+				const XMVECTOR layers = XMVectorAndInt(XMLoadInt4(stream.layerMask.data() + j), XMVectorReplicateInt(layerMask));
+				inside = XMVectorAndCInt(inside, XMVectorEqualInt(layers, XMVectorZero()));
+				for (int p = 0; p < 6; ++p)
+				{
+					XMVECTOR distance = XMVectorMultiplyAdd(XMVectorReplicate(planes[p].x), XMLoadFloat4((const XMFLOAT4*)(corner_x[p] + j)), XMVectorReplicate(planes[p].w));
+					distance = XMVectorMultiplyAdd(XMVectorReplicate(planes[p].y), XMLoadFloat4((const XMFLOAT4*)(corner_y[p] + j)), distance);
+					distance = XMVectorMultiplyAdd(XMVectorReplicate(planes[p].z), XMLoadFloat4((const XMFLOAT4*)(corner_z[p] + j)), distance);
+					inside = XMVectorAndCInt(inside, XMVectorLess(distance, XMVectorZero()));
+				}
+#if defined(_XM_SSE_INTRINSICS_)
+				mask |= (uint32_t)_mm_movemask_ps(inside) << half;
+#else
+				XMUINT4 bits;
+				XMStoreUInt4(&bits, inside);
+				mask |= ((bits.x & 1u) | ((bits.y & 1u) << 1u) | ((bits.z & 1u) << 2u) | ((bits.w & 1u) << 3u)) << half;
+#endif // _XM_SSE_INTRINSICS_
+			}
+#endif // __AVX2__
+
+			if (end - i < AABBStream::WIDTH)
+			{
+				mask &= (1u << (end - i)) - 1u;
+			}
+			while (mask != 0)
+			{
+				const uint32_t lane = firstbitlow(mask);
+				visible[count++] = i + lane;
+				mask &= mask - 1u;
+			}
+		}
+		return count;
+	}
+
 	const XMFLOAT4& Frustum::getNearPlane() const { return planes[0]; }
 	const XMFLOAT4& Frustum::getFarPlane() const { return planes[1]; }
 	const XMFLOAT4& Frustum::getLeftPlane() const { return planes[2]; }
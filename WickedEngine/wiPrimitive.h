@@ -12,6 +12,7 @@ namespace wi::primitive
 	struct Sphere;
 	struct Ray;
 	struct AABB;
+	struct AABBStream;
 	struct Capsule;
 	struct Plane;
 
@@ -78,6 +79,32 @@ namespace wi::primitive
 
 		void Serialize(wi::Archive& archive, wi::ecs::EntitySerializer& seri);
 	};
+	// Structure of arrays mirror of AABBs (with their layer masks) for batched culling
+	//	The arrays are padded with invalid boxes to a multiple of WIDTH, so WIDTH boxes can always be loaded at once
+	struct AABBStream
+	{
+		static constexpr uint32_t WIDTH = 8;
+
+		wi::vector<float> min_x, min_y, min_z;
+		wi::vector<float> max_x, max_y, max_z;
+		wi::vector<uint32_t> layerMask;
+		uint32_t count = 0;
+
+		void resize(size_t newCount);
+		inline void set(size_t index, const AABB& aabb)
+		{
+			assert(index < count);
+			min_x[index] = aabb._min.x;
+			min_y[index] = aabb._min.y;
+			min_z[index] = aabb._min.z;
+			max_x[index] = aabb._max.x;
+			max_y[index] = aabb._max.y;
+			max_z[index] = aabb._max.z;
+			layerMask[index] = aabb.layerMask;
+		}
+		inline size_t size() const { return count; }
+		inline bool empty() const { return count == 0; }
+	};
 	struct Sphere
 	{
 		XMFLOAT3 center;
@@ -224,6 +251,11 @@ namespace wi::primitive
 		};
 		BoxFrustumIntersect CheckBox(const AABB& box) const;
 		bool CheckBoxFast(const AABB& box) const;
+		// Same test as CheckBoxFast for the boxes [begin, end) of the stream that match the layerMask, WIDTH boxes are tested at once
+		//	begin must be a multiple of AABBStream::WIDTH
+		//	the indices of the boxes that are not outside are written to visible in order (it must have room for end - begin indices)
+		//	returns the number of written indices
+		uint32_t CheckBoxesFast(const AABBStream& stream, uint32_t layerMask, uint32_t begin, uint32_t end, uint32_t* visible) const;
 
 		const XMFLOAT4& getNearPlane() const;
 		const XMFLOAT4& getFarPlane() const;
@@ -20,6 +20,8 @@
 #include <mutex>
 #include <atomic>
 #include <sstream>
+#include <chrono>
+#include <cstring>
 
 using namespace wi::graphics;
 
@@ -62,6 +64,125 @@ namespace wi::profiler
 	};
 	wi::unordered_map<size_t, Range> ranges;
 
+	// The timeline is recorded by each thread into its own ring buffer, so recording doesn't need any lock
+	namespace timeline
+	{
+		static constexpr uint32_t EVENT_CAPACITY = 8192; // per thread, must be power of two
+		static constexpr uint32_t MAX_DEPTH = 64;
+		static constexpr uint32_t NAME_LENGTH = 48;
+		static constexpr range_id EVENT_ID = 0; // id of events that are not ranges
+		static constexpr uint32_t GPU_TID = ~0u;
+
+		struct Event
+		{
+			uint64_t begin = 0; // nanoseconds since epoch
+			uint64_t end = 0;
+			uint32_t frame = 0;
+			uint32_t depth = 0;
+			char name[NAME_LENGTH] = {};
+		};
+		struct OpenEvent
+		{
+			range_id id = 0;
+			uint64_t begin = 0;
+			char name[NAME_LENGTH] = {};
+		};
+		struct ThreadTimeline
+		{
+			uint32_t tid = 0;
+			std::atomic<uint64_t> head{ 0 }; // number of events written so far, only written by the owning thread
+			Event events[EVENT_CAPACITY];
+			OpenEvent stack[MAX_DEPTH];
+			uint32_t depth = 0;
+		};
+
+		// Timelines are never freed, because threads can keep them until they exit
+		std::mutex registry_lock; // only taken when a thread records its first event and when saving
+		wi::vector<std::unique_ptr<ThreadTimeline>> registry;
+		thread_local ThreadTimeline* local = nullptr;
+		ThreadTimeline gpu;
+		uint32_t main_tid = 0;
+
+		std::atomic<uint32_t> frame{ 0 };
+		const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		uint64_t submit_time[arraysize(queryResultBuffer)] = {}; // CPU time of submitting the frame's GPU commands
+		uint32_t submit_frame[arraysize(queryResultBuffer)] = {};
+
+		inline uint64_t Now()
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+		}
+		inline void CopyName(char* dst, const char* name)
+		{
+			strncpy(dst, name, NAME_LENGTH - 1);
+			dst[NAME_LENGTH - 1] = 0;
+		}
+		ThreadTimeline& GetLocal()
+		{
+			if (local == nullptr)
+			{
+				std::scoped_lock lck(registry_lock);
+				registry.push_back(std::make_unique<ThreadTimeline>());
+				local = registry.back().get();
+				local->tid = (uint32_t)registry.size();
+			}
+			return *local;
+		}
+		inline void Write(ThreadTimeline& timeline, const char* name, uint64_t begin, uint64_t end, uint32_t depth, uint32_t event_frame)
+		{
+			const uint64_t head = timeline.head.load(std::memory_order_relaxed);
+			Event& event = timeline.events[head & (EVENT_CAPACITY - 1)];
+			event.begin = begin;
+			event.end = end;
+			event.frame = event_frame;
+			event.depth = depth;
+			std::memcpy(event.name, name, NAME_LENGTH);
+			timeline.head.store(head + 1, std::memory_order_release);
+		}
+		void Begin(range_id id, const char* name)
+		{
+			ThreadTimeline& timeline = GetLocal();
+			if (timeline.depth < MAX_DEPTH)
+			{
+				OpenEvent& open = timeline.stack[timeline.depth];
+				open.id = id;
+				CopyName(open.name, name);
+				open.begin = Now();
+			}
+			else if (id != EVENT_ID)
+			{
+				return; // ranges that don't fit into the stack are not recorded, their End() won't find them
+			}
+			timeline.depth++;
+		}
+		void End(range_id id)
+		{
+			ThreadTimeline& timeline = GetLocal();
+			const uint64_t end = Now();
+			if (id == EVENT_ID && timeline.depth > MAX_DEPTH)
+			{
+				timeline.depth--; // events are nested, so this closes an event that didn't fit into the stack
+				return;
+			}
+			// Ranges can be ended in different order than they started, so the open range is searched from the top:
+			uint32_t top = std::min(timeline.depth, MAX_DEPTH);
+			for (uint32_t i = top; i > 0; --i)
+			{
+				const OpenEvent& open = timeline.stack[i - 1];
+				if (open.id != id)
+					continue;
+				Write(timeline, open.name, open.begin, end, i - 1, frame.load(std::memory_order_relaxed));
+				for (uint32_t j = i; j < top; ++j)
+				{
+					timeline.stack[j - 1] = timeline.stack[j];
+				}
+				timeline.depth--;
+				return;
+			}
+			// else the range is a GPU range, it didn't fit into the stack or it was started on a different thread, it is not recorded
+		}
+	}
+
 	void BeginFrame()
 	{
 		if (ENABLED_REQUEST != ENABLED)
@@ -106,6 +227,9 @@ namespace wi::profiler
 #endif // PERFORMANCEAPI_ENABLED
 		}
 
+		timeline::frame.fetch_add(1, std::memory_order_relaxed);
+		timeline::main_tid = timeline::GetLocal().tid;
+
 		cpu_frame = BeginRangeCPU("CPU Frame");
 
 		GraphicsDevice* device = wi::graphics::GetDevice();
@@ -116,6 +240,18 @@ namespace wi::profiler
 		// This should be done before we begin reallocating new queries for current buffer index
 		const uint64_t* queryResults = (const uint64_t*)queryResultBuffer[queryheap_idx].mapped_data;
 		double gpu_frequency = (double)device->GetTimestampFrequency() / 1000.0;
+
+		// The GPU starts the frame when its commands are submitted, the timeline places GPU ranges relative to that point:
+		uint64_t gpu_frame_begin = 0;
+		{
+			auto it = ranges.find(gpu_frame);
+			if (queryResults != nullptr && it != ranges.end() && it->second.in_use && it->second.gpuBegin[queryheap_idx] >= 0)
+			{
+				gpu_frame_begin = queryResults[it->second.gpuBegin[queryheap_idx]];
+			}
+		}
+		const double gpu_ns_per_tick = 1000000.0 / gpu_frequency;
+
 		for (auto& x : ranges)
 		{
 			auto& range = x.second;
@@ -131,6 +267,20 @@ namespace wi::profiler
 					const uint64_t begin_result = queryResults[begin_idx];
 					const uint64_t end_result = queryResults[end_idx];
 					range.time = (float)abs((double)(end_result - begin_result) / gpu_frequency);
+
+					if (gpu_frame_begin != 0 && begin_result >= gpu_frame_begin && end_result >= begin_result)
+					{
+						char name[timeline::NAME_LENGTH];
+						timeline::CopyName(name, range.name.c_str());
+						timeline::Write(
+							timeline::gpu,
+							name,
+							timeline::submit_time[queryheap_idx] + uint64_t((begin_result - gpu_frame_begin) * gpu_ns_per_tick),
+							timeline::submit_time[queryheap_idx] + uint64_t((end_result - gpu_frame_begin) * gpu_ns_per_tick),
+							0,
+							timeline::submit_frame[queryheap_idx]
+						);
+					}
 				}
 				range.gpuBegin[queryheap_idx] = -1;
 				range.gpuEnd[queryheap_idx] = -1;
@@ -174,6 +324,10 @@ namespace wi::profiler
 
 		EndRange(cpu_frame);
 
+		// the command lists are submitted right after this:
+		timeline::submit_time[queryheap_idx] = timeline::Now();
+		timeline::submit_frame[queryheap_idx] = timeline::frame.load(std::memory_order_relaxed);
+
 		device->QueryResolve(
 			&queryHeap,
 			0,
@@ -214,6 +368,8 @@ namespace wi::profiler
 
 		lock.unlock();
 
+		timeline::Begin(id, name);
+
 		return id;
 	}
 	range_id BeginRangeGPU(const char* name, CommandList cmd)
@@ -248,6 +404,8 @@ namespace wi::profiler
 		if (!ENABLED || !initialized)
 			return;
 
+		timeline::End(id); // GPU ranges are not found here, they are written when their results are read back
+
 		lock.lock();
 
 		auto it = ranges.find(id);
@@ -279,6 +437,71 @@ namespace wi::profiler
 		lock.unlock();
 	}
 
+	void BeginEventCPU(const char* name)
+	{
+		if (!ENABLED || !initialized)
+			return;
+		timeline::Begin(timeline::EVENT_ID, name);
+	}
+	void EndEventCPU()
+	{
+		if (!ENABLED || !initialized)
+			return;
+		timeline::End(timeline::EVENT_ID);
+	}
+
+	bool SaveTrace(const std::string& filename, uint32_t frameCount)
+	{
+		std::scoped_lock lck(timeline::registry_lock);
+
+		const uint32_t current_frame = timeline::frame.load();
+		const uint32_t first_frame = current_frame > frameCount ? current_frame - frameCount : 0;
+
+		std::string json;
+		json.reserve(1024 * 1024);
+		json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		auto write_thread = [&](const timeline::ThreadTimeline& thread, uint32_t tid) {
+			std::string thread_name = tid == timeline::GPU_TID ? "GPU" : tid == timeline::main_tid ? "Main Thread" : "Thread " + std::to_string(tid);
+			json += first ? "" : ",\n";
+			json += "{\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(tid) + ",\"name\":\"thread_name\",\"args\":{\"name\":\"" + thread_name + "\"}}";
+			first = false;
+
+			const uint64_t head = thread.head.load(std::memory_order_acquire);
+			const uint64_t tail = head > timeline::EVENT_CAPACITY ? head - timeline::EVENT_CAPACITY : 0;
+			char buffer[256];
+			for (uint64_t i = tail; i < head; ++i)
+			{
+				const timeline::Event& event = thread.events[i & (timeline::EVENT_CAPACITY - 1)];
+				if (event.frame < first_frame || event.end < event.begin)
+					continue;
+				std::string name;
+				for (const char* c = event.name; c < event.name + timeline::NAME_LENGTH && *c != 0; ++c)
+				{
+					if (*c == '"' || *c == '\\')
+					{
+						name += '\\';
+					}
+					name += (uint8_t)*c < 0x20 ? ' ' : *c;
+				}
+				snprintf(buffer, arraysize(buffer), ",\n{\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"",
+					tid, double(event.begin) / 1000.0, double(event.end - event.begin) / 1000.0);
+				json += buffer;
+				json += name;
+				snprintf(buffer, arraysize(buffer), "\",\"args\":{\"frame\":%u,\"depth\":%u}}", event.frame, event.depth);
+				json += buffer;
+			}
+		};
+		for (auto& thread : timeline::registry)
+		{
+			write_thread(*thread, thread->tid);
+		}
+		write_thread(timeline::gpu, timeline::GPU_TID);
+		json += "\n]}\n";
+
+		return wi::helper::FileWrite(filename, (const uint8_t*)json.data(), json.size());
+	}
+
 
 	PipelineState pso_linestrip;
 	PipelineState pso_linelist;
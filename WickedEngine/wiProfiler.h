@@ -7,6 +7,7 @@
 // QoL macros, allows writing just ScopedXxxProfiling without needing to declare a variable manually
 #define ScopedCPUProfiling(name) wi::profiler::ScopedRangeCPU WI_PROFILER_CONCAT(_wi_profiler_cpu_range,__LINE__)(name)
 #define ScopedGPUProfiling(name, cmd) wi::profiler::ScopedRangeGPU WI_PROFILER_CONCAT(_wi_profiler_gpu_range,__LINE__)(name, cmd)
+#define ScopedCPUEvent(name) wi::profiler::ScopedEventCPU WI_PROFILER_CONCAT(_wi_profiler_cpu_event,__LINE__)(name)
 
 // same as ScopedXxxProfiling, just will automatically use the function name as name, should only be used at the beginning of a function
 #define ScopedCPUProfilingF ScopedCPUProfiling(__FUNCTION__)
@@ -52,6 +53,26 @@ namespace wi::profiler
 		inline ~ScopedRangeGPU() { EndRange(id); }
 	};
 
+	// Start a CPU event that is only recorded into the timeline (see SaveTrace), it is not displayed by DrawData
+	//	This doesn't take any lock, so it can be used to instrument jobs in a fine grained way
+	void BeginEventCPU(const char* name);
+
+	// End the last CPU event that was started on the current thread
+	void EndEventCPU();
+
+	// same for BeginEventCPU
+	struct ScopedEventCPU
+	{
+		inline ScopedEventCPU(const char* name) { BeginEventCPU(name); }
+		inline ~ScopedEventCPU() { EndEventCPU(); }
+	};
+
+	// Write the timeline of the last frameCount frames to a Chrome trace JSON file (chrome://tracing or ui.perfetto.dev)
+	//	CPU ranges and events are recorded into per thread ring buffers while profiling is enabled, so the oldest events are overwritten
+	//	GPU ranges are placed on the CPU clock relative to the submission of their frame
+	//	It should be called between frames, the events that are overwritten while saving could be corrupted
+	bool SaveTrace(const std::string& filename, uint32_t frameCount);
+
 	// Renders a basic text of the Profiling results to the (x,y) screen coordinate
 	void DrawData(
 		const wi::Canvas& canvas,
@@ -343,19 +343,10 @@ namespace wi
 		camera_reflection_previous = camera_reflection;
 	}
 
-	void RenderPath3D::Update(float dt)
+	void RenderPath3D::UpdateScene(float dt)
 	{
 		GraphicsDevice* device = wi::graphics::GetDevice();
 
-		if (rtMain_render.desc.sample_count != msaaSampleCount)
-		{
-			ResizeBuffers();
-		}
-
-		RenderPath2D::Update(dt);
-
-		wi::renderer::SetShadowsEnabled(getShadowsEnabled());
-
 		float update_speed = 0;
 
 		const bool hw_raytrace = device->CheckCapability(GraphicsDeviceCapability::RAYTRACING);
@@ -376,6 +367,25 @@ namespace wi
 		}
 
 		scene->Update(update_speed);
+	}
+
+	void RenderPath3D::Update(float dt)
+	{
+		GraphicsDevice* device = wi::graphics::GetDevice();
+
+		if (rtMain_render.desc.sample_count != msaaSampleCount)
+		{
+			ResizeBuffers();
+		}
+
+		RenderPath2D::Update(dt);
+
+		wi::renderer::SetShadowsEnabled(getShadowsEnabled());
+
+		if (!getSceneUpdateExternal())
+		{
+			UpdateScene(dt);
+		}
 
 		// Frustum culling for main camera:
 		visibility_main.layerMask = getLayerMask();
@@ -926,10 +936,99 @@ namespace wi
 			wi::renderer::DRAWSCENE_MAINCAMERA
 			;
 
+		// Large opaque queues of the main camera can be split into chunks that are recorded into multiple command lists in parallel,
+		//	the same chunks are used by the depth prepass and the opaque color pass.
+		//	The queue is built and split by a job, so the render thread only allocates a command list for every possible chunk,
+		//	the command lists of chunks that end up unused are left empty:
+		const uint32_t drawscene_chunk_count = wi::renderer::GetDrawSceneChunkCount();
+		const bool drawscene_chunked = drawscene_chunk_count > 1;
+		wi::jobsystem::context drawscene_chunks_ctx; // the jobs that draw chunk 0 wait for this, the other chunk jobs are started by it
+
 		// Main camera depth prepass:
 		cmd = device->BeginCommandList();
 		CommandList cmd_maincamera_prepass = cmd;
-		wi::jobsystem::Execute(ctx, [this, cmd](wi::jobsystem::JobArgs args) {
+		// The chunk command lists are allocated after the first prepass command list, and the preparation job
+		//	is started before the first prepass job, which waits for it before drawing chunk 0:
+		if (drawscene_chunked)
+		{
+			wi::vector<CommandList> prepass_chunk_cmds(drawscene_chunk_count);
+			for (uint32_t chunk = 1; chunk < drawscene_chunk_count; ++chunk)
+			{
+				prepass_chunk_cmds[chunk] = device->BeginCommandList();
+				cmd_maincamera_prepass = prepass_chunk_cmds[chunk];
+			}
+
+			auto record_prepass_chunk = [this](CommandList cmd, uint32_t chunk) {
+
+				const std::string name = "Z-Prepass Chunk " + std::to_string(chunk);
+				ScopedCPUEvent(name.c_str());
+				GraphicsDevice* device = wi::graphics::GetDevice();
+
+				wi::renderer::BindCameraCB(
+					*camera,
+					camera_previous,
+					camera_reflection,
+					cmd
+				);
+
+				RenderPassImage rp[] = {
+					RenderPassImage::DepthStencil(
+						&depthBuffer_Main,
+						RenderPassImage::LoadOp::LOAD,
+						RenderPassImage::StoreOp::STORE,
+						ResourceState::DEPTHSTENCIL,
+						ResourceState::DEPTHSTENCIL,
+						ResourceState::DEPTHSTENCIL
+					),
+					RenderPassImage::RenderTarget(
+						&rtPrimitiveID_render,
+						RenderPassImage::LoadOp::LOAD,
+						RenderPassImage::StoreOp::STORE,
+						ResourceState::SHADER_RESOURCE_COMPUTE,
+						ResourceState::SHADER_RESOURCE_COMPUTE
+					),
+				};
+				device->RenderPassBegin(rp, arraysize(rp), cmd);
+
+				device->EventBegin(name.c_str(), cmd);
+				auto range = wi::profiler::BeginRangeGPU(name.c_str(), cmd);
+
+				Rect scissor = GetScissorInternalResolution();
+				device->BindScissorRects(1, &scissor, cmd);
+
+				Viewport vp;
+				vp.width = (float)depthBuffer_Main.GetDesc().width;
+				vp.height = (float)depthBuffer_Main.GetDesc().height;
+				device->BindViewports(1, &vp, cmd);
+
+				wi::renderer::DrawSceneChunk(
+					visibility_main,
+					drawscene_chunks,
+					chunk,
+					RENDERPASS_PREPASS,
+					cmd
+				);
+
+				wi::profiler::EndRange(range);
+				device->EventEnd(cmd);
+
+				device->RenderPassEnd(cmd);
+
+			};
+
+			wi::jobsystem::Execute(drawscene_chunks_ctx, [this, &ctx, prepass_chunk_cmds, record_prepass_chunk](wi::jobsystem::JobArgs args) {
+				wi::renderer::PrepareDrawSceneChunks(visibility_main, drawscene_flags, (uint32_t)prepass_chunk_cmds.size(), drawscene_chunks);
+				for (uint32_t chunk = 1; chunk < drawscene_chunks.chunk_count; ++chunk)
+				{
+					const CommandList chunk_cmd = prepass_chunk_cmds[chunk];
+					wi::jobsystem::Execute(ctx, [record_prepass_chunk, chunk_cmd, chunk](wi::jobsystem::JobArgs args) {
+						record_prepass_chunk(chunk_cmd, chunk);
+					});
+				}
+			});
+		}
+
+		wi::jobsystem::Execute(ctx, [this, cmd, drawscene_chunked, &drawscene_chunks_ctx](wi::jobsystem::JobArgs args) {
 
 			GraphicsDevice* device = wi::graphics::GetDevice();
 
@@ -998,12 +1097,33 @@ namespace wi
 			vp.min_depth = 0;
 			vp.max_depth = 1;
 			device->BindViewports(1, &vp, cmd);
-			wi::renderer::DrawScene(
-				visibility_main,
-				RENDERPASS_PREPASS,
-				cmd,
-				drawscene_flags
-			);
+			if (drawscene_chunked)
+			{
+				// The first chunk is drawn here, the rest of them continue this pass in their own command lists:
+				wi::jobsystem::Wait(drawscene_chunks_ctx);
+				wi::renderer::DrawSceneChunk(
+					visibility_main,
+					drawscene_chunks,
+					0,
+					RENDERPASS_PREPASS,
+					cmd
+				);
+				wi::renderer::DrawScene(
+					visibility_main,
+					RENDERPASS_PREPASS,
+					cmd,
+					drawscene_flags & ~wi::renderer::DRAWSCENE_OPAQUE
+				);
+			}
+			else
+			{
+				wi::renderer::DrawScene(
+					visibility_main,
+					RENDERPASS_PREPASS,
+					cmd,
+					drawscene_flags
+				);
+			}
 
 			wi::profiler::EndRange(range);
 			device->EventEnd(cmd);
@@ -1473,9 +1593,73 @@ namespace wi
 		}
 
 		// Main camera opaque color pass:
+		//	When it's chunked, the first command list draws the first chunk, the others continue the render pass in their own command lists,
+		//	the last one draws the sky and finishes the pass
+		const bool opaque_chunked = drawscene_chunked && !visibility_shading_in_compute;
+		auto opaque_renderpass_begin = [this](CommandList cmd, RenderPassImage::LoadOp loadop, bool resolve) {
+			GraphicsDevice* device = wi::graphics::GetDevice();
+			RenderPassImage rp[4] = {};
+			uint32_t rp_count = 0;
+			rp[rp_count++] = RenderPassImage::RenderTarget(
+				&rtMain_render,
+				loadop
+			);
+			rp[rp_count++] = RenderPassImage::DepthStencil(
+				&depthBuffer_Main,
+				RenderPassImage::LoadOp::LOAD,
+				RenderPassImage::StoreOp::STORE,
+				ResourceState::DEPTHSTENCIL,
+				ResourceState::DEPTHSTENCIL,
+				ResourceState::DEPTHSTENCIL
+			);
+			if (resolve && getMSAASampleCount() > 1)
+			{
+				rp[rp_count++] = RenderPassImage::Resolve(&rtMain);
+			}
+			if (device->CheckCapability(GraphicsDeviceCapability::VARIABLE_RATE_SHADING_TIER2) && rtShadingRate.IsValid())
+			{
+				rp[rp_count++] = RenderPassImage::ShadingRateSource(&rtShadingRate, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS);
+			}
+			device->RenderPassBegin(rp, rp_count, cmd, RenderPassFlags::ALLOW_UAV_WRITES);
+		};
+		auto opaque_renderpass_end = [this](CommandList cmd) {
+			GraphicsDevice* device = wi::graphics::GetDevice();
+
+			// Blend Aerial Perspective on top:
+			if (scene->weather.IsRealisticSky() && scene->weather.IsRealisticSkyAerialPerspective())
+			{
+				device->EventBegin("Aerial Perspective Blend", cmd);
+				wi::image::Params fx;
+				fx.enableFullScreen();
+				fx.blendFlag = BLENDMODE_PREMULTIPLIED;
+				wi::image::Draw(&aerialperspectiveResources.texture_output, fx, cmd);
+				device->EventEnd(cmd);
+			}
+
+			// Blend the volumetric clouds on top:
+			if (scene->weather.IsVolumetricClouds())
+			{
+				wi::renderer::Postprocess_VolumetricClouds_Upsample(volumetriccloudResources, cmd);
+			}
+
+			RenderOutline(cmd);
+
+			device->RenderPassEnd(cmd);
+
+			if (wi::renderer::GetRaytracedShadowsEnabled() || wi::renderer::GetScreenSpaceShadowsEnabled())
+			{
+				GPUBarrier barrier = GPUBarrier::Image(&rtShadow, ResourceState::SHADER_RESOURCE, rtShadow.desc.layout);
+				device->Barrier(&barrier, 1, cmd);
+			}
+
+			if (rtAO.IsValid())
+			{
+				device->Barrier(GPUBarrier::Aliasing(&rtAO, &rtParticleDistortion), cmd);
+			}
+		};
 		cmd = device->BeginCommandList();
 		device->WaitCommandList(cmd, cmd_maincamera_compute_effects);
-		wi::jobsystem::Execute(ctx, [this, cmd](wi::jobsystem::JobArgs args) {
+		wi::jobsystem::Execute(ctx, [this, cmd, opaque_chunked, opaque_renderpass_begin, opaque_renderpass_end, &drawscene_chunks_ctx](wi::jobsystem::JobArgs args) {
 
 			GraphicsDevice* device = wi::graphics::GetDevice();
 			device->EventBegin("Opaque Scene", cmd);
@@ -1572,29 +1756,11 @@ namespace wi
 				device->EventEnd(cmd);
 			}
 
-			RenderPassImage rp[4] = {};
-			uint32_t rp_count = 0;
-			rp[rp_count++] = RenderPassImage::RenderTarget(
-				&rtMain_render,
-				visibility_shading_in_compute ? RenderPassImage::LoadOp::LOAD : RenderPassImage::LoadOp::CLEAR
-			);
-			rp[rp_count++] = RenderPassImage::DepthStencil(
-				&depthBuffer_Main,
-				RenderPassImage::LoadOp::LOAD,
-				RenderPassImage::StoreOp::STORE,
-				ResourceState::DEPTHSTENCIL,
-				ResourceState::DEPTHSTENCIL,
-				ResourceState::DEPTHSTENCIL
+			opaque_renderpass_begin(
+				cmd,
+				visibility_shading_in_compute ? RenderPassImage::LoadOp::LOAD : RenderPassImage::LoadOp::CLEAR,
+				!opaque_chunked
 			);
-			if (getMSAASampleCount() > 1)
-			{
-				rp[rp_count++] = RenderPassImage::Resolve(&rtMain);
-			}
-			if (device->CheckCapability(GraphicsDeviceCapability::VARIABLE_RATE_SHADING_TIER2) && rtShadingRate.IsValid())
-			{
-				rp[rp_count++] = RenderPassImage::ShadingRateSource(&rtShadingRate, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS);
-			}
-			device->RenderPassBegin(rp, rp_count, cmd, RenderPassFlags::ALLOW_UAV_WRITES);
 
 			if (visibility_shading_in_compute)
 			{
@@ -1627,50 +1793,126 @@ namespace wi
 				vp.min_depth = 0;
 				vp.max_depth = 1;
 				device->BindViewports(1, &vp, cmd);
-				wi::renderer::DrawScene(
-					visibility_main,
-					RENDERPASS_MAIN,
-					cmd,
-					drawscene_flags
-				);
-				wi::renderer::DrawSky(*scene, cmd);
+				if (opaque_chunked)
+				{
+					wi::jobsystem::Wait(drawscene_chunks_ctx);
+					wi::renderer::DrawSceneChunk(
+						visibility_main,
+						drawscene_chunks,
+						0,
+						RENDERPASS_MAIN,
+						cmd
+					);
+					wi::renderer::DrawScene(
+						visibility_main,
+						RENDERPASS_MAIN,
+						cmd,
+						drawscene_flags & ~wi::renderer::DRAWSCENE_OPAQUE
+					);
+				}
+				else
+				{
+					wi::renderer::DrawScene(
+						visibility_main,
+						RENDERPASS_MAIN,
+						cmd,
+						drawscene_flags
+					);
+					wi::renderer::DrawSky(*scene, cmd);
+				}
 				wi::profiler::EndRange(range); // Opaque Scene
 			}
 
-			// Blend Aerial Perspective on top:
-			if (scene->weather.IsRealisticSky() && scene->weather.IsRealisticSkyAerialPerspective())
+			if (opaque_chunked)
 			{
-				device->EventBegin("Aerial Perspective Blend", cmd);
-				wi::image::Params fx;
-				fx.enableFullScreen();
-				fx.blendFlag = BLENDMODE_PREMULTIPLIED;
-				wi::image::Draw(&aerialperspectiveResources.texture_output, fx, cmd);
-				device->EventEnd(cmd);
+				device->RenderPassEnd(cmd);
 			}
-
-			// Blend the volumetric clouds on top:
-			if (scene->weather.IsVolumetricClouds())
+			else
 			{
-				wi::renderer::Postprocess_VolumetricClouds_Upsample(volumetriccloudResources, cmd);
+				opaque_renderpass_end(cmd);
 			}
 
-			RenderOutline(cmd);
-
-			device->RenderPassEnd(cmd);
+			device->EventEnd(cmd);
+		});
 
-			if (wi::renderer::GetRaytracedShadowsEnabled() || wi::renderer::GetScreenSpaceShadowsEnabled())
+		if (opaque_chunked)
+		{
+			for (uint32_t chunk = 1; chunk < drawscene_chunk_count; ++chunk)
 			{
-				GPUBarrier barrier = GPUBarrier::Image(&rtShadow, ResourceState::SHADER_RESOURCE, rtShadow.desc.layout);
-				device->Barrier(&barrier, 1, cmd);
-			}
+				cmd = device->BeginCommandList();
+				wi::jobsystem::Execute(ctx, [this, cmd, chunk, opaque_renderpass_begin, &drawscene_chunks_ctx](wi::jobsystem::JobArgs args) {
 
-			if (rtAO.IsValid())
-			{
-				device->Barrier(GPUBarrier::Aliasing(&rtAO, &rtParticleDistortion), cmd);
+					wi::jobsystem::Wait(drawscene_chunks_ctx);
+					if (chunk >= drawscene_chunks.chunk_count)
+						return;
+
+					const std::string name = "Opaque Scene Chunk " + std::to_string(chunk);
+					ScopedCPUEvent(name.c_str());
+					GraphicsDevice* device = wi::graphics::GetDevice();
+
+					wi::renderer::BindCameraCB(
+						*camera,
+						camera_previous,
+						camera_reflection,
+						cmd
+					);
+
+					Viewport vp;
+					vp.width = (float)depthBuffer_Main.GetDesc().width;
+					vp.height = (float)depthBuffer_Main.GetDesc().height;
+					device->BindViewports(1, &vp, cmd);
+
+					Rect scissor = GetScissorInternalResolution();
+					device->BindScissorRects(1, &scissor, cmd);
+
+					opaque_renderpass_begin(cmd, RenderPassImage::LoadOp::LOAD, false);
+
+					device->EventBegin(name.c_str(), cmd);
+					auto range = wi::profiler::BeginRangeGPU(name.c_str(), cmd);
+					wi::renderer::DrawSceneChunk(
+						visibility_main,
+						drawscene_chunks,
+						chunk,
+						RENDERPASS_MAIN,
+						cmd
+					);
+					wi::profiler::EndRange(range);
+					device->EventEnd(cmd);
+
+					device->RenderPassEnd(cmd);
+
+				});
 			}
 
-			device->EventEnd(cmd);
-		});
+			// The sky and the effects on top of the opaque scene finish the pass after all the chunks:
+			cmd = device->BeginCommandList();
+			wi::jobsystem::Execute(ctx, [this, cmd, opaque_renderpass_begin, opaque_renderpass_end](wi::jobsystem::JobArgs args) {
+
+				GraphicsDevice* device = wi::graphics::GetDevice();
+				device->EventBegin("Opaque Scene Finish", cmd);
+
+				wi::renderer::BindCameraCB(
+					*camera,
+					camera_previous,
+					camera_reflection,
+					cmd
+				);
+
+				Viewport vp;
+				vp.width = (float)depthBuffer_Main.GetDesc().width;
+				vp.height = (float)depthBuffer_Main.GetDesc().height;
+				device->BindViewports(1, &vp, cmd);
+
+				Rect scissor = GetScissorInternalResolution();
+				device->BindScissorRects(1, &scissor, cmd);
+
+				opaque_renderpass_begin(cmd, RenderPassImage::LoadOp::LOAD, true);
+				wi::renderer::DrawSky(*scene, cmd);
+				opaque_renderpass_end(cmd);
+
+				device->EventEnd(cmd);
+			});
+		}
 
 		if (scene->terrains.GetCount() > 0)
 		{
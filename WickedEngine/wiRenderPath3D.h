@@ -80,6 +80,7 @@ namespace wi
 		bool ditherEnabled = true;
 		bool occlusionCullingEnabled = true;
 		bool sceneUpdateEnabled = true;
+		bool sceneUpdateExternal = false;
 		bool fsrEnabled = false;
 		bool fsr2Enabled = false;
 
@@ -182,6 +183,7 @@ namespace wi
 		wi::scene::Scene* scene = &wi::scene::GetScene();
 		wi::renderer::Visibility visibility_main;
 		wi::renderer::Visibility visibility_reflection;
+		mutable wi::renderer::DrawSceneChunks drawscene_chunks;
 
 		FrameCB frameCB = {};
 
@@ -265,6 +267,7 @@ namespace wi
 		constexpr bool getDitherEnabled() const { return ditherEnabled; }
 		constexpr bool getOcclusionCullingEnabled() const { return occlusionCullingEnabled; }
 		constexpr bool getSceneUpdateEnabled() const { return sceneUpdateEnabled; }
+		constexpr bool getSceneUpdateExternal() const { return sceneUpdateExternal; }
 		constexpr bool getFSREnabled() const { return fsrEnabled; }
 		constexpr bool getFSR2Enabled() const { return fsr2Enabled; }
 		constexpr bool getVisibilityComputeShadingEnabled() const { return visibility_shading_in_compute; }
@@ -320,6 +323,9 @@ namespace wi
 		constexpr void setDitherEnabled(bool value) { ditherEnabled = value; }
 		constexpr void setOcclusionCullingEnabled(bool value) { occlusionCullingEnabled = value; }
 		constexpr void setSceneUpdateEnabled(bool value) { sceneUpdateEnabled = value; }
+		// When enabled, Update() will not call Scene::Update(), the owner is responsible to call UpdateScene() once per frame before it
+		//	(this is used when multiple render paths are rendering the same scene)
+		constexpr void setSceneUpdateExternal(bool value) { sceneUpdateExternal = value; }
 		void setFSREnabled(bool value);
 		void setFSR2Enabled(bool value);
 		void setFSR2Preset(FSR2_Preset preset); // this will modify resolution scaling and sampler lod bias
@@ -339,6 +345,7 @@ namespace wi
 		wi::vector<CustomPostprocess> custom_post_processes;
 
 		void PreUpdate() override;
+		void UpdateScene(float dt);
 		void Update(float dt) override;
 		void Render() const override;
 		void Compose(wi::graphics::CommandList cmd) const override;
@@ -121,6 +121,7 @@ bool variableRateShadingClassificationDebug = false;
 float GameSpeed = 1;
 bool debugLightCulling = false;
 bool occlusionCulling = false;
+uint32_t drawSceneChunkCount = 1;
 bool temporalAA = false;
 bool temporalAADEBUG = false;
 uint32_t raytraceBounceCount = 3;
@@ -183,6 +184,7 @@ static const uint32_t vertexCount_uvsphere = arraysize(UVSPHERE);
 static const uint32_t vertexCount_cone = arraysize(CONE);
 
 std::atomic_bool initialized{ false };
+std::atomic<uint64_t> visibility_generation{ 0 };
 
 bool volumetric_clouds_precomputed = false;
 Texture texture_shapeNoise;
@@ -232,56 +234,26 @@ struct RenderBatch
 	// opaque sorting
 	//	Priority is set to mesh index to have more instancing
 	//	distance is second priority (front to back Z-buffering)
-	constexpr bool operator<(const RenderBatch& other) const
+	//	The order of fields is important here, it means the sort priority (low to high)!
+	constexpr uint64_t GetOpaqueSortKey() const
 	{
-		union SortKey
-		{
-			struct
-			{
-				// The order of members is important here, it means the sort priority (low to high)!
-				uint64_t distance : 16;
-				uint64_t meshIndex : 16;
-				uint64_t sort_bits : 32;
-			} bits;
-			uint64_t value;
-		};
-		static_assert(sizeof(SortKey) == sizeof(uint64_t));
-		SortKey a = {};
-		a.bits.distance = distance;
-		a.bits.meshIndex = meshIndex;
-		a.bits.sort_bits = sort_bits;
-		SortKey b = {};
-		b.bits.distance = other.distance;
-		b.bits.meshIndex = other.meshIndex;
-		b.bits.sort_bits = other.sort_bits;
-		return a.value < b.value;
+		return uint64_t(distance) | (uint64_t(meshIndex & 0xFFFF) << 16ull) | (uint64_t(sort_bits) << 32ull);
 	}
 	// transparent sorting
 	//	Priority is distance for correct alpha blending (back to front rendering)
 	//	mesh index is second priority for instancing
+	//	The key is inverted, so that sorting it in ascending order results in back to front order
+	constexpr uint64_t GetTransparentSortKey() const
+	{
+		return ~(uint64_t(meshIndex & 0xFFFF) | (uint64_t(sort_bits) << 16ull) | (uint64_t(distance) << 48ull));
+	}
+	constexpr bool operator<(const RenderBatch& other) const
+	{
+		return GetOpaqueSortKey() < other.GetOpaqueSortKey();
+	}
 	constexpr bool operator>(const RenderBatch& other) const
 	{
-		union SortKey
-		{
-			struct
-			{
-				// The order of members is important here, it means the sort priority (low to high)!
-				uint64_t meshIndex : 16;
-				uint64_t sort_bits : 32;
-				uint64_t distance : 16;
-			} bits;
-			uint64_t value;
-		};
-		static_assert(sizeof(SortKey) == sizeof(uint64_t));
-		SortKey a = {};
-		a.bits.distance = distance;
-		a.bits.sort_bits = sort_bits;
-		a.bits.meshIndex = meshIndex;
-		SortKey b = {};
-		b.bits.distance = other.distance;
-		b.bits.sort_bits = other.sort_bits;
-		b.bits.meshIndex = other.meshIndex;
-		return a.value > b.value;
+		return GetTransparentSortKey() < other.GetTransparentSortKey();
 	}
 };
 static_assert(sizeof(RenderBatch) == 16ull);
@@ -291,6 +263,16 @@ struct RenderQueue
 {
 	wi::vector<RenderBatch> batches;
 
+	// Queues that are bigger than these are filled and sorted by multiple jobs:
+	static constexpr uint32_t PARALLEL_FILL_THRESHOLD = 4096;
+	static constexpr uint32_t PARALLEL_FILL_GROUPSIZE = 1024;
+	static constexpr size_t PARALLEL_SORT_THRESHOLD = 65536;
+	static constexpr size_t PARALLEL_SORT_BLOCKSIZE = 16384;
+
+	wi::vector<RenderBatch> sort_scratch;
+	wi::vector<uint32_t> group_counts;
+	wi::vector<uint32_t> block_offsets;
+
 	inline void init()
 	{
 		batches.clear();
@@ -299,13 +281,192 @@ struct RenderQueue
 	{
 		batches.emplace_back().Create(meshIndex, instanceIndex, distance, sort_bits, camera_mask);
 	}
+	// Add batches from itemCount items, fill(itemIndex, batch) creates the batch and returns true if the item should be added
+	//	Large queues are filled by multiple jobs, each group writes its own range that is compacted afterwards,
+	//	so there is no locking and the result is the same as a serial fill
+	template<typename F>
+	inline void add_parallel(uint32_t itemCount, const F& fill)
+	{
+		if (itemCount < PARALLEL_FILL_THRESHOLD)
+		{
+			RenderBatch batch;
+			for (uint32_t i = 0; i < itemCount; ++i)
+			{
+				if (fill(i, batch))
+				{
+					batches.push_back(batch);
+				}
+			}
+			return;
+		}
+
+		const size_t offset = batches.size();
+		batches.resize(offset + itemCount);
+		const uint32_t groupCount = wi::jobsystem::DispatchGroupCount(itemCount, PARALLEL_FILL_GROUPSIZE);
+		group_counts.resize(groupCount);
+		wi::jobsystem::context ctx;
+		wi::jobsystem::Dispatch(ctx, groupCount, 1, [&](wi::jobsystem::JobArgs args) {
+			const uint32_t begin = args.jobIndex * PARALLEL_FILL_GROUPSIZE;
+			const uint32_t end = std::min(begin + PARALLEL_FILL_GROUPSIZE, itemCount);
+			RenderBatch* dst = batches.data() + offset + begin;
+			uint32_t count = 0;
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				if (fill(i, dst[count]))
+				{
+					count++;
+				}
+			}
+			group_counts[args.jobIndex] = count;
+		});
+		wi::jobsystem::Wait(ctx);
+
+		size_t write = offset;
+		for (uint32_t group = 0; group < groupCount; ++group)
+		{
+			const size_t read = offset + group * PARALLEL_FILL_GROUPSIZE;
+			if (write != read)
+			{
+				std::memmove(batches.data() + write, batches.data() + read, group_counts[group] * sizeof(RenderBatch));
+			}
+			write += group_counts[group];
+		}
+		batches.resize(write);
+	}
 	inline void sort_transparent()
 	{
-		std::sort(batches.begin(), batches.end(), std::greater<RenderBatch>());
+		sort(true);
 	}
 	inline void sort_opaque()
 	{
-		std::sort(batches.begin(), batches.end(), std::less<RenderBatch>());
+		sort(false);
+	}
+	void sort(bool transparent)
+	{
+		const size_t count = batches.size();
+		if (count < 2)
+			return;
+		if (count < 256)
+		{
+			if (transparent)
+			{
+				std::sort(batches.begin(), batches.end(), std::greater<RenderBatch>());
+			}
+			else
+			{
+				std::sort(batches.begin(), batches.end(), std::less<RenderBatch>());
+			}
+			return;
+		}
+
+		if (transparent)
+		{
+			radix_sort([](const RenderBatch& batch) { return batch.GetTransparentSortKey(); });
+		}
+		else
+		{
+			radix_sort([](const RenderBatch& batch) { return batch.GetOpaqueSortKey(); });
+		}
+	}
+	// Stable LSD radix sort over the 64-bit key with 8-bit digits, digits that are the same for every batch are skipped
+	template<typename K>
+	void radix_sort(const K& key)
+	{
+		const size_t count = batches.size();
+		sort_scratch.resize(count);
+		RenderBatch* src = batches.data();
+		RenderBatch* dst = sort_scratch.data();
+		const uint64_t first_key = key(src[0]);
+
+		if (count < PARALLEL_SORT_THRESHOLD)
+		{
+			uint32_t histograms[8][256] = {};
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint64_t k = key(src[i]);
+				for (uint32_t digit = 0; digit < 8; ++digit)
+				{
+					histograms[digit][(k >> (digit * 8)) & 0xFF]++;
+				}
+			}
+			for (uint32_t digit = 0; digit < 8; ++digit)
+			{
+				const uint32_t shift = digit * 8;
+				if (histograms[digit][(first_key >> shift) & 0xFF] == count)
+					continue;
+				uint32_t offsets[256];
+				uint32_t sum = 0;
+				for (uint32_t value = 0; value < 256; ++value)
+				{
+					offsets[value] = sum;
+					sum += histograms[digit][value];
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[offsets[(key(src[i]) >> shift) & 0xFF]++] = src[i];
+				}
+				std::swap(src, dst);
+			}
+		}
+		else
+		{
+			// Every block counts and scatters its own range, block offsets are laid out so that the sort remains stable:
+			const uint32_t blockCount = wi::jobsystem::DispatchGroupCount((uint32_t)count, (uint32_t)PARALLEL_SORT_BLOCKSIZE);
+			block_offsets.resize(blockCount * 256);
+			for (uint32_t digit = 0; digit < 8; ++digit)
+			{
+				const uint32_t shift = digit * 8;
+				wi::jobsystem::context ctx;
+				wi::jobsystem::Dispatch(ctx, blockCount, 1, [&](wi::jobsystem::JobArgs args) {
+					uint32_t* histogram = block_offsets.data() + args.jobIndex * 256;
+					std::fill(histogram, histogram + 256, 0u);
+					const size_t begin = args.jobIndex * PARALLEL_SORT_BLOCKSIZE;
+					const size_t end = std::min(begin + PARALLEL_SORT_BLOCKSIZE, count);
+					for (size_t i = begin; i < end; ++i)
+					{
+						histogram[(key(src[i]) >> shift) & 0xFF]++;
+					}
+				});
+				wi::jobsystem::Wait(ctx);
+
+				uint32_t sum = 0;
+				bool trivial = false;
+				for (uint32_t value = 0; value < 256; ++value)
+				{
+					const uint32_t value_begin = sum;
+					for (uint32_t block = 0; block < blockCount; ++block)
+					{
+						const uint32_t block_count = block_offsets[block * 256 + value];
+						block_offsets[block * 256 + value] = sum;
+						sum += block_count;
+					}
+					if (sum - value_begin == count)
+					{
+						trivial = true;
+						break;
+					}
+				}
+				if (trivial)
+					continue;
+
+				wi::jobsystem::Dispatch(ctx, blockCount, 1, [&](wi::jobsystem::JobArgs args) {
+					uint32_t* offsets = block_offsets.data() + args.jobIndex * 256;
+					const size_t begin = args.jobIndex * PARALLEL_SORT_BLOCKSIZE;
+					const size_t end = std::min(begin + PARALLEL_SORT_BLOCKSIZE, count);
+					for (size_t i = begin; i < end; ++i)
+					{
+						dst[offsets[(key(src[i]) >> shift) & 0xFF]++] = src[i];
+					}
+				});
+				wi::jobsystem::Wait(ctx);
+				std::swap(src, dst);
+			}
+		}
+
+		if (src != batches.data())
+		{
+			batches.swap(sort_scratch);
+		}
 	}
 	inline bool empty() const
 	{
@@ -317,6 +478,134 @@ struct RenderQueue
 	}
 };
 
+// Rendering scratch objects (render queues, culling masks) are taken from a pool for the duration of a call instead of being thread_local:
+//	the parallel fill/sort of RenderQueue and CullObjects() wait for their jobs, and the waiting thread can run another rendering job
+//	in the meantime, which would reuse the same thread_local object while it's still being written
+template<typename T>
+struct PooledScratch
+{
+	inline static std::mutex locker;
+	inline static wi::vector<std::unique_ptr<T>> pool;
+	std::unique_ptr<T> item;
+
+	PooledScratch()
+	{
+		std::scoped_lock lck(locker);
+		if (pool.empty())
+		{
+			item = std::make_unique<T>();
+		}
+		else
+		{
+			item = std::move(pool.back());
+			pool.pop_back();
+		}
+	}
+	~PooledScratch()
+	{
+		std::scoped_lock lck(locker);
+		pool.push_back(std::move(item));
+	}
+	PooledScratch(const PooledScratch&) = delete;
+	PooledScratch& operator=(const PooledScratch&) = delete;
+
+	T& operator*() { return *item; }
+};
+
+// Above this object count the object BVH traversal is faster than testing every object bounds
+static constexpr uint32_t HIERARCHICAL_CULLING_THRESHOLD = 16384;
+
+// Cull the scene objects against multiple frusta, masks[i] receives the bit of every frustum that object i is visible from
+//	Above HIERARCHICAL_CULLING_THRESHOLD objects the object BVH is traversed once for all frusta, if it's up to date
+//	Otherwise the SoA culling stream of the scene is used when it's up to date, which tests AABBStream::WIDTH objects at once
+void CullObjects(const Scene& scene, uint32_t layerMask, const Frustum* frusta, uint32_t frustum_count, wi::vector<uint16_t>& masks)
+{
+	assert(frustum_count <= 16);
+	const uint32_t object_count = (uint32_t)scene.aabb_objects.size();
+	masks.resize(object_count);
+
+	// Very large scenes are culled hierarchically with the object BVH, all frusta are served by one traversal:
+	if (object_count >= HIERARCHICAL_CULLING_THRESHOLD && scene.object_bvh.IsValid() && scene.object_bvh.leaf_count == object_count)
+	{
+		std::fill(masks.begin(), masks.end(), uint16_t(0));
+		scene.object_bvh.CullFrusta(frusta, frustum_count, scene.aabb_objects.data(), [&](uint32_t index, uint16_t mask) {
+			if (scene.aabb_objects[index].layerMask & layerMask)
+			{
+				masks[index] = mask;
+			}
+		});
+		return;
+	}
+
+	const AABBStream& stream = scene.aabb_objects_stream;
+	if (stream.size() != object_count)
+	{
+		for (uint32_t i = 0; i < object_count; ++i)
+		{
+			const AABB& aabb = scene.aabb_objects[i];
+			uint16_t mask = 0;
+			if (aabb.layerMask & layerMask)
+			{
+				for (uint32_t f = 0; f < frustum_count; ++f)
+				{
+					if (frusta[f].CheckBoxFast(aabb))
+					{
+						mask |= 1 << f;
+					}
+				}
+			}
+			masks[i] = mask;
+		}
+		return;
+	}
+
+	static constexpr uint32_t chunkSize = 1024;
+	static_assert(chunkSize % AABBStream::WIDTH == 0);
+	auto cull_chunk = [&](uint32_t chunk) {
+		const uint32_t begin = chunk * chunkSize;
+		const uint32_t end = std::min(begin + chunkSize, object_count);
+		std::fill(masks.begin() + begin, masks.begin() + end, uint16_t(0));
+		uint32_t list[chunkSize];
+		for (uint32_t f = 0; f < frustum_count; ++f)
+		{
+			const uint32_t count = frusta[f].CheckBoxesFast(stream, layerMask, begin, end, list);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				masks[list[i]] |= 1 << f;
+			}
+		}
+	};
+	const uint32_t chunkCount = (object_count + chunkSize - 1) / chunkSize;
+	if (chunkCount < 8)
+	{
+		for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			cull_chunk(chunk);
+		}
+	}
+	else
+	{
+		wi::jobsystem::context ctx;
+		wi::jobsystem::Dispatch(ctx, chunkCount, 1, [&](wi::jobsystem::JobArgs args) {
+			cull_chunk(args.jobIndex);
+		});
+		wi::jobsystem::Wait(ctx);
+	}
+}
+
+// Check whether the shadow casters of the queue need the transparent shadow pass too
+bool IsTransparentShadowRequested(const Scene& scene, const RenderQueue& renderQueue)
+{
+	for (const RenderBatch& batch : renderQueue.batches)
+	{
+		const uint32_t filterMask = scene.objects[batch.GetInstanceIndex()].GetFilterMask();
+		if (filterMask & FILTER_TRANSPARENT || filterMask & FILTER_WATER)
+		{
+			return true;
+		}
+	}
+	return false;
+}
 
 const Sampler* GetSampler(SAMPLERTYPES id)
 {
@@ -3370,6 +3659,8 @@ void UpdateVisibility(Visibility& vis)
 	assert(vis.scene != nullptr); // User must provide a scene!
 	assert(vis.camera != nullptr); // User must provide a camera!
 
+	vis.generation = visibility_generation.fetch_add(1) + 1;
+
 	// The parallel frustum culling is first performed in shared memory, 
 	//	then each group writes out it's local list to global memory
 	//	The shared memory approach reduces atomics and helps the list to remain
@@ -3459,79 +3750,128 @@ void UpdateVisibility(Visibility& vis)
 		// Cull objects:
 		const uint32_t object_loop = (uint32_t)std::min(vis.scene->aabb_objects.size(), vis.scene->objects.GetCount());
 		vis.visibleObjects.resize(object_loop);
-		wi::jobsystem::Dispatch(ctx, object_loop, groupSize, [&](wi::jobsystem::JobArgs args) {
 
-			// Setup stream compaction:
-			StreamCompaction& stream_compaction = *(StreamCompaction*)args.sharedmemory;
-			if (args.isFirstJobInGroup)
+		// This is called for every object that is inside the frustum:
+		auto object_visible = [&](uint32_t objectIndex) {
+			const AABB& aabb = vis.scene->aabb_objects[objectIndex];
+			const ObjectComponent& object = vis.scene->objects[objectIndex];
+			Scene::OcclusionResult& occlusion_result = vis.scene->occlusion_results_objects[objectIndex];
+			bool occluded = false;
+			if (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING)
 			{
-				stream_compaction.count = 0; // first thread initializes local counter
+				occluded = occlusion_result.IsOccluded();
 			}
 
-			const AABB& aabb = vis.scene->aabb_objects[args.jobIndex];
-
-			if ((aabb.layerMask & vis.layerMask) && vis.frustum.CheckBoxFast(aabb))
+			if ((vis.flags & Visibility::ALLOW_REQUEST_REFLECTION) && object.IsRequestPlanarReflection() && !occluded)
 			{
-				// Local stream compaction:
-				stream_compaction.list[stream_compaction.count++] = args.groupIndex;
-
-				const ObjectComponent& object = vis.scene->objects[args.jobIndex];
-				Scene::OcclusionResult& occlusion_result = vis.scene->occlusion_results_objects[args.jobIndex];
-				bool occluded = false;
-				if (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING)
+				// Planar reflection priority request:
+				float dist = wi::math::DistanceEstimated(vis.camera->Eye, object.center);
+				vis.locker.lock();
+				if (dist < vis.closestRefPlane)
 				{
-					occluded = occlusion_result.IsOccluded();
+					vis.closestRefPlane = dist;
+					XMVECTOR P = XMLoadFloat3(&object.center);
+					XMVECTOR N = XMVectorSet(0, 1, 0, 0);
+					N = XMVector3TransformNormal(N, XMLoadFloat4x4(&vis.scene->matrix_objects[objectIndex]));
+					N = XMVector3Normalize(N);
+					XMVECTOR _refPlane = XMPlaneFromPointNormal(P, N);
+					XMStoreFloat4(&vis.reflectionPlane, _refPlane);
+
+					vis.planar_reflection_visible = true;
 				}
+				vis.locker.unlock();
+			}
 
-				if ((vis.flags & Visibility::ALLOW_REQUEST_REFLECTION) && object.IsRequestPlanarReflection() && !occluded)
+			if (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING)
+			{
+				if (object.IsRenderable() && occlusion_result.occlusionQueries[vis.scene->queryheap_idx] < 0)
 				{
-					// Planar reflection priority request:
-					float dist = wi::math::DistanceEstimated(vis.camera->Eye, object.center);
-					vis.locker.lock();
-					if (dist < vis.closestRefPlane)
+					if (aabb.intersects(vis.camera->Eye))
 					{
-						vis.closestRefPlane = dist;
-						XMVECTOR P = XMLoadFloat3(&object.center);
-						XMVECTOR N = XMVectorSet(0, 1, 0, 0);
-						N = XMVector3TransformNormal(N, XMLoadFloat4x4(&vis.scene->matrix_objects[args.jobIndex]));
-						N = XMVector3Normalize(N);
-						XMVECTOR _refPlane = XMPlaneFromPointNormal(P, N);
-						XMStoreFloat4(&vis.reflectionPlane, _refPlane);
-
-						vis.planar_reflection_visible = true;
+						// camera is inside the instance, mark it as visible in this frame:
+						occlusion_result.occlusionHistory |= 1;
+					}
+					else
+					{
+						occlusion_result.occlusionQueries[vis.scene->queryheap_idx] = vis.scene->queryAllocator.fetch_add(1); // allocate new occlusion query from heap
 					}
-					vis.locker.unlock();
 				}
+			}
+		};
 
-				if (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING)
-				{
-					if (object.IsRenderable() && occlusion_result.occlusionQueries[vis.scene->queryheap_idx] < 0)
+		// note: the jobs must copy the locals of this scope, because they are only waited at the end of UpdateVisibility
+		if (object_loop >= HIERARCHICAL_CULLING_THRESHOLD && vis.scene->object_bvh.IsValid() && vis.scene->object_bvh.leaf_count == object_loop)
+		{
+			// Very large scenes are culled hierarchically with the object BVH, then the visible objects are processed in parallel:
+			wi::jobsystem::Execute(ctx, [&vis, &ctx, object_visible](wi::jobsystem::JobArgs args) {
+				uint32_t count = 0;
+				vis.scene->object_bvh.CullFrusta(&vis.frustum, 1, vis.scene->aabb_objects.data(), [&](uint32_t index, uint16_t mask) {
+					if (vis.scene->aabb_objects[index].layerMask & vis.layerMask)
 					{
-						if (aabb.intersects(vis.camera->Eye))
-						{
-							// camera is inside the instance, mark it as visible in this frame:
-							occlusion_result.occlusionHistory |= 1;
-						}
-						else
-						{
-							occlusion_result.occlusionQueries[vis.scene->queryheap_idx] = vis.scene->queryAllocator.fetch_add(1); // allocate new occlusion query from heap
-						}
+						vis.visibleObjects[count++] = index;
 					}
+				});
+				vis.object_counter.store(count);
+				wi::jobsystem::Dispatch(ctx, count, groupSize, [&vis, object_visible](wi::jobsystem::JobArgs args) {
+					object_visible(vis.visibleObjects[args.jobIndex]);
+				});
+			});
+		}
+		else if (vis.scene->aabb_objects_stream.size() == object_loop)
+		{
+			// The SoA culling stream is tested AABBStream::WIDTH boxes at a time, each job culls a chunk into its local list:
+			static constexpr uint32_t chunkSize = 256;
+			static_assert(chunkSize % AABBStream::WIDTH == 0);
+			const uint32_t chunkCount = (object_loop + chunkSize - 1) / chunkSize;
+			wi::jobsystem::Dispatch(ctx, chunkCount, 1, [&vis, object_visible, object_loop](wi::jobsystem::JobArgs args) {
+				const uint32_t begin = args.jobIndex * chunkSize;
+				const uint32_t end = std::min(begin + chunkSize, object_loop);
+				uint32_t list[chunkSize];
+				const uint32_t count = vis.frustum.CheckBoxesFast(vis.scene->aabb_objects_stream, vis.layerMask, begin, end, list);
+				if (count == 0)
+					return;
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					object_visible(list[i]);
 				}
-			}
+				uint32_t prev_count = vis.object_counter.fetch_add(count);
+				std::memcpy(vis.visibleObjects.data() + prev_count, list, count * sizeof(uint32_t));
+			});
+		}
+		else
+		{
+			wi::jobsystem::Dispatch(ctx, object_loop, groupSize, [&vis, object_visible](wi::jobsystem::JobArgs args) {
 
-			// Global stream compaction:
-			if (args.isLastJobInGroup && stream_compaction.count > 0)
-			{
-				uint32_t prev_count = vis.object_counter.fetch_add(stream_compaction.count);
-				uint32_t groupOffset = args.groupID * groupSize;
-				for (uint32_t i = 0; i < stream_compaction.count; ++i)
+				// Setup stream compaction:
+				StreamCompaction& stream_compaction = *(StreamCompaction*)args.sharedmemory;
+				if (args.isFirstJobInGroup)
 				{
-					vis.visibleObjects[prev_count + i] = groupOffset + stream_compaction.list[i];
+					stream_compaction.count = 0; // first thread initializes local counter
 				}
-			}
 
-			}, sharedmemory_size);
+				const AABB& aabb = vis.scene->aabb_objects[args.jobIndex];
+
+				if ((aabb.layerMask & vis.layerMask) && vis.frustum.CheckBoxFast(aabb))
+				{
+					// Local stream compaction:
+					stream_compaction.list[stream_compaction.count++] = args.groupIndex;
+
+					object_visible(args.jobIndex);
+				}
+
+				// Global stream compaction:
+				if (args.isLastJobInGroup && stream_compaction.count > 0)
+				{
+					uint32_t prev_count = vis.object_counter.fetch_add(stream_compaction.count);
+					uint32_t groupOffset = args.groupID * groupSize;
+					for (uint32_t i = 0; i < stream_compaction.count; ++i)
+					{
+						vis.visibleObjects[prev_count + i] = groupOffset + stream_compaction.list[i];
+					}
+				}
+
+				}, sharedmemory_size);
+		}
 	}
 
 	if (vis.flags & Visibility::ALLOW_DECALS)
@@ -6110,7 +6450,10 @@ void DrawShadowmaps(
 		cam_frustum.Transform(cam_frustum, vis.camera->GetInvView());
 		XMStoreFloat4(&cam_frustum.Orientation, XMQuaternionNormalize(XMLoadFloat4(&cam_frustum.Orientation)));
 
-		static thread_local RenderQueue renderQueue;
+		PooledScratch<RenderQueue> renderQueue_scratch;
+		RenderQueue& renderQueue = *renderQueue_scratch;
+		PooledScratch<wi::vector<uint16_t>> culling_masks_scratch;
+		wi::vector<uint16_t>& culling_masks = *culling_masks_scratch;
 		CameraCB cb;
 		cb.init();
 
@@ -6161,38 +6504,38 @@ void DrawShadowmaps(
 				SHCAM* shcams = (SHCAM*)alloca(sizeof(SHCAM) * cascade_count);
 				CreateDirLightShadowCams(light, *vis.camera, shcams, cascade_count, shadow_rect);
 
-				renderQueue.init();
-				bool transparentShadowsRequested = false;
-				for (size_t i = 0; i < vis.scene->aabb_objects.size(); ++i)
+				// Determine which cascades the objects are contained in:
+				Frustum* frusta = (Frustum*)alloca(sizeof(Frustum) * cascade_count);
+				for (uint32_t cascade = 0; cascade < cascade_count; ++cascade)
 				{
-					const AABB& aabb = vis.scene->aabb_objects[i];
-					if (aabb.layerMask & vis.layerMask)
-					{
-						const ObjectComponent& object = vis.scene->objects[i];
-						if (object.IsRenderable() && object.IsCastingShadow())
-						{
-							// Determine which cascades the object is contained in:
-							uint16_t camera_mask = 0;
-							for (uint32_t cascade = 0; cascade < cascade_count; ++cascade)
-							{
-								if ((cascade < (cascade_count - object.cascadeMask)) && shcams[cascade].frustum.CheckBoxFast(aabb))
-								{
-									camera_mask |= 1 << cascade;
-								}
-							}
-							if (camera_mask == 0)
-								continue;
+					frusta[cascade] = shcams[cascade].frustum;
+				}
+				CullObjects(*vis.scene, vis.layerMask, frusta, cascade_count, culling_masks);
+				const uint16_t* masks = culling_masks.data();
 
-							renderQueue.add(object.mesh_index, uint32_t(i), 0, object.sort_bits, camera_mask);
+				renderQueue.init();
+				renderQueue.add_parallel((uint32_t)vis.scene->aabb_objects.size(), [&](uint32_t i, RenderBatch& batch) {
+					uint16_t camera_mask = masks[i];
+					if (camera_mask == 0)
+						return false;
+					const ObjectComponent& object = vis.scene->objects[i];
+					if (!object.IsRenderable() || !object.IsCastingShadow())
+						return false;
 
-							const uint32_t filterMask = object.GetFilterMask();
-							if (filterMask & FILTER_TRANSPARENT || filterMask & FILTER_WATER)
-							{
-								transparentShadowsRequested = true;
-							}
+					for (uint32_t cascade = 0; cascade < cascade_count; ++cascade)
+					{
+						if (!(cascade < (cascade_count - object.cascadeMask)))
+						{
+							camera_mask &= ~(1 << cascade);
 						}
 					}
-				}
+					if (camera_mask == 0)
+						return false;
+
+					batch.Create(object.mesh_index, i, 0, object.sort_bits, camera_mask);
+					return true;
+				});
+				const bool transparentShadowsRequested = IsTransparentShadowRequested(*vis.scene, renderQueue);
 
 				if (!renderQueue.empty())
 				{
@@ -6279,26 +6622,21 @@ void DrawShadowmaps(
 				if (!cam_frustum.Intersects(shcam.boundingfrustum))
 					break;
 
+				CullObjects(*vis.scene, vis.layerMask, &shcam.frustum, 1, culling_masks);
+				const uint16_t* masks = culling_masks.data();
+
 				renderQueue.init();
-				bool transparentShadowsRequested = false;
-				for (size_t i = 0; i < vis.scene->aabb_objects.size(); ++i)
-				{
-					const AABB& aabb = vis.scene->aabb_objects[i];
-					if ((aabb.layerMask & vis.layerMask) && shcam.frustum.CheckBoxFast(aabb))
-					{
-						const ObjectComponent& object = vis.scene->objects[i];
-						if (object.IsRenderable() && object.IsCastingShadow())
-						{
-							renderQueue.add(object.mesh_index, uint32_t(i), 0, object.sort_bits);
+				renderQueue.add_parallel((uint32_t)vis.scene->aabb_objects.size(), [&](uint32_t i, RenderBatch& batch) {
+					if (masks[i] == 0)
+						return false;
+					const ObjectComponent& object = vis.scene->objects[i];
+					if (!object.IsRenderable() || !object.IsCastingShadow())
+						return false;
 
-							const uint32_t filterMask = object.GetFilterMask();
-							if (filterMask & FILTER_TRANSPARENT || filterMask & FILTER_WATER)
-							{
-								transparentShadowsRequested = true;
-							}
-						}
-					}
-				}
+					batch.Create(object.mesh_index, i, 0, object.sort_bits);
+					return true;
+				});
+				const bool transparentShadowsRequested = IsTransparentShadowRequested(*vis.scene, renderQueue);
 
 				if (predicationRequest && light.occlusionquery >= 0)
 				{
@@ -6427,38 +6765,23 @@ void DrawShadowmaps(
 					}
 				}
 
-				renderQueue.init();
-				bool transparentShadowsRequested = false;
-				for (size_t i = 0; i < vis.scene->aabb_objects.size(); ++i)
-				{
-					const AABB& aabb = vis.scene->aabb_objects[i];
-					if ((aabb.layerMask & vis.layerMask) && boundingsphere.intersects(aabb))
-					{
-						const ObjectComponent& object = vis.scene->objects[i];
-						if (object.IsRenderable() && object.IsCastingShadow())
-						{
-							// Check for each frustum, if object is visible from it:
-							uint16_t camera_mask = 0;
-							for (uint32_t camera_index = 0; camera_index < camera_count; ++camera_index)
-							{
-								if (frusta[camera_index].CheckBoxFast(aabb))
-								{
-									camera_mask |= 1 << camera_index;
-								}
-							}
-							if (camera_mask == 0)
-								continue;
+				// Check for each frustum, if objects are visible from it:
+				CullObjects(*vis.scene, vis.layerMask, frusta, camera_count, culling_masks);
+				const uint16_t* masks = culling_masks.data();
 
-							renderQueue.add(object.mesh_index, uint32_t(i), 0, object.sort_bits, camera_mask);
+				renderQueue.init();
+				renderQueue.add_parallel((uint32_t)vis.scene->aabb_objects.size(), [&](uint32_t i, RenderBatch& batch) {
+					const uint16_t camera_mask = masks[i];
+					if (camera_mask == 0 || !boundingsphere.intersects(vis.scene->aabb_objects[i]))
+						return false;
+					const ObjectComponent& object = vis.scene->objects[i];
+					if (!object.IsRenderable() || !object.IsCastingShadow())
+						return false;
 
-							const uint32_t filterMask = object.GetFilterMask();
-							if (filterMask & FILTER_TRANSPARENT || filterMask & FILTER_WATER)
-							{
-								transparentShadowsRequested = true;
-							}
-						}
-					}
-				}
+					batch.Create(object.mesh_index, i, 0, object.sort_bits, camera_mask);
+					return true;
+				});
+				const bool transparentShadowsRequested = IsTransparentShadowRequested(*vis.scene, renderQueue);
 
 				if (predicationRequest && light.occlusionquery >= 0)
 				{
@@ -6598,6 +6921,127 @@ void DrawShadowmaps(
 	}
 }
 
+uint32_t GetDrawSceneFilterMask(uint32_t flags)
+{
+	if (IsWireRender())
+		return FILTER_ALL;
+	uint32_t filterMask = 0;
+	if (flags & DRAWSCENE_OPAQUE)
+	{
+		filterMask |= FILTER_OPAQUE;
+	}
+	if (flags & DRAWSCENE_TRANSPARENT)
+	{
+		filterMask |= FILTER_TRANSPARENT;
+		filterMask |= FILTER_WATER;
+	}
+	return filterMask;
+}
+// The sorted DrawScene() queues are kept for the passes that draw the same visibility result again with the same flags (eg. depth prepass and color pass),
+//	a queue is identified by the visibility generation, the camera and the pass flags, so a new UpdateVisibility() invalidates it
+struct DrawSceneQueueCache
+{
+	static constexpr size_t SLOT_COUNT = 8;
+	static constexpr size_t MIN_BATCH_COUNT = 256; // smaller queues are cheaper to rebuild than to copy through the cache
+	struct Slot
+	{
+		uint64_t generation = 0;
+		const CameraComponent* camera = nullptr;
+		uint32_t flags = 0;
+		uint32_t filterMask = 0;
+		wi::vector<RenderBatch> batches;
+	};
+	Slot slots[SLOT_COUNT];
+	uint32_t next_slot = 0;
+	std::mutex locker;
+
+	Slot* find(uint64_t generation, const CameraComponent* camera, uint32_t flags, uint32_t filterMask)
+	{
+		for (auto& slot : slots)
+		{
+			if (slot.generation == generation && slot.camera == camera && slot.flags == flags && slot.filterMask == filterMask)
+				return &slot;
+		}
+		return nullptr;
+	}
+};
+static DrawSceneQueueCache drawSceneQueueCache;
+
+// Gathers the visible opaque/transparent objects of DrawScene() into the render queue and sorts it
+void BuildDrawSceneQueue(const Visibility& vis, uint32_t flags, uint32_t filterMask, RenderQueue& renderQueue)
+{
+	const bool cacheable = vis.generation != 0; // visibility that wasn't filled by UpdateVisibility() is never cached
+	if (cacheable)
+	{
+		std::scoped_lock lck(drawSceneQueueCache.locker);
+		const DrawSceneQueueCache::Slot* slot = drawSceneQueueCache.find(vis.generation, vis.camera, flags, filterMask);
+		if (slot != nullptr)
+		{
+			renderQueue.batches = slot->batches;
+			return;
+		}
+	}
+
+	const bool transparent = flags & DRAWSCENE_TRANSPARENT;
+	const bool occlusion = (flags & DRAWSCENE_OCCLUSIONCULLING) && (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING) && GetOcclusionCullingEnabled();
+	const bool skip_planar_reflection_objects = flags & DRAWSCENE_SKIP_PLANAR_REFLECTION_OBJECTS;
+	const bool foreground = flags & DRAWSCENE_FOREGROUND_ONLY;
+	const bool maincamera = flags & DRAWSCENE_MAINCAMERA;
+
+	renderQueue.init();
+	renderQueue.add_parallel((uint32_t)vis.visibleObjects.size(), [&](uint32_t i, RenderBatch& batch) {
+		const uint32_t instanceIndex = vis.visibleObjects[i];
+		if (occlusion && vis.scene->occlusion_results_objects[instanceIndex].IsOccluded())
+			return false;
+
+		const ObjectComponent& object = vis.scene->objects[instanceIndex];
+		if (!object.IsRenderable())
+			return false;
+		if (foreground != object.IsForeground())
+			return false;
+		if (maincamera && object.IsNotVisibleInMainCamera())
+			return false;
+		if (skip_planar_reflection_objects && object.IsNotVisibleInReflections())
+			return false;
+		if ((object.GetFilterMask() & filterMask) == 0)
+			return false;
+
+		const float distance = wi::math::Distance(vis.camera->Eye, object.center);
+		if (distance > object.fadeDistance + object.radius)
+			return false;
+
+		batch.Create(object.mesh_index, instanceIndex, distance, object.sort_bits);
+		return true;
+	});
+	if (!renderQueue.empty())
+	{
+		if (transparent)
+		{
+			renderQueue.sort_transparent();
+		}
+		else
+		{
+			renderQueue.sort_opaque();
+		}
+	}
+
+	if (cacheable && renderQueue.batches.size() >= DrawSceneQueueCache::MIN_BATCH_COUNT)
+	{
+		std::scoped_lock lck(drawSceneQueueCache.locker);
+		DrawSceneQueueCache::Slot* slot = drawSceneQueueCache.find(vis.generation, vis.camera, flags, filterMask);
+		if (slot == nullptr)
+		{
+			slot = &drawSceneQueueCache.slots[drawSceneQueueCache.next_slot];
+			drawSceneQueueCache.next_slot = (drawSceneQueueCache.next_slot + 1) % DrawSceneQueueCache::SLOT_COUNT;
+			slot->generation = vis.generation;
+			slot->camera = vis.camera;
+			slot->flags = flags;
+			slot->filterMask = filterMask;
+			slot->batches = renderQueue.batches;
+		}
+	}
+}
+
 void DrawScene(
 	const Visibility& vis,
 	RENDERPASS renderPass,
@@ -6612,8 +7056,6 @@ void DrawScene(
 	const bool occlusion = (flags & DRAWSCENE_OCCLUSIONCULLING) && (vis.flags & Visibility::ALLOW_OCCLUSION_CULLING) && GetOcclusionCullingEnabled();
 	const bool ocean = flags & DRAWSCENE_OCEAN;
 	const bool skip_planar_reflection_objects = flags & DRAWSCENE_SKIP_PLANAR_REFLECTION_OBJECTS;
-	const bool foreground = flags & DRAWSCENE_FOREGROUND_ONLY;
-	const bool maincamera = flags & DRAWSCENE_MAINCAMERA;
 
 	device->EventBegin("DrawScene", cmd);
 	device->BindShadingRate(ShadingRate::RATE_1X1, cmd);
@@ -6628,59 +7070,15 @@ void DrawScene(
 		}
 	}
 
-	uint32_t filterMask = 0;
-	if (opaque)
-	{
-		filterMask |= FILTER_OPAQUE;
-	}
-	if (transparent)
-	{
-		filterMask |= FILTER_TRANSPARENT;
-		filterMask |= FILTER_WATER;
-	}
-
-	if (IsWireRender())
-	{
-		filterMask = FILTER_ALL;
-	}
+	const uint32_t filterMask = GetDrawSceneFilterMask(flags);
 
 	if (opaque || transparent)
 	{
-		static thread_local RenderQueue renderQueue;
-		renderQueue.init();
-		for (uint32_t instanceIndex : vis.visibleObjects)
-		{
-			if (occlusion && vis.scene->occlusion_results_objects[instanceIndex].IsOccluded())
-				continue;
-
-			const ObjectComponent& object = vis.scene->objects[instanceIndex];
-			if (!object.IsRenderable())
-				continue;
-			if (foreground != object.IsForeground())
-				continue;
-			if (maincamera && object.IsNotVisibleInMainCamera())
-				continue;
-			if (skip_planar_reflection_objects && object.IsNotVisibleInReflections())
-				continue;
-			if ((object.GetFilterMask() & filterMask) == 0)
-				continue;
-
-			const float distance = wi::math::Distance(vis.camera->Eye, object.center);
-			if (distance > object.fadeDistance + object.radius)
-				continue;
-
-			renderQueue.add(object.mesh_index, instanceIndex, distance, object.sort_bits);
-		}
+		PooledScratch<RenderQueue> renderQueue_scratch;
+		RenderQueue& renderQueue = *renderQueue_scratch;
+		BuildDrawSceneQueue(vis, flags, filterMask, renderQueue);
 		if (!renderQueue.empty())
 		{
-			if (transparent)
-			{
-				renderQueue.sort_transparent();
-			}
-			else
-			{
-				renderQueue.sort_opaque();
-			}
 			RenderMeshes(vis, renderQueue, renderPass, filterMask, cmd, flags);
 		}
 	}
@@ -6710,6 +7108,90 @@ void DrawScene(
 
 }
 
+
+// Queues that are smaller than this are not split further into chunks:
+static constexpr uint32_t DRAWSCENE_CHUNK_MIN_BATCHES = 512;
+
+struct DrawSceneChunks_Internal
+{
+	RenderQueue renderQueue;
+	wi::vector<RenderQueue> chunk_queues;
+	uint32_t flags = 0;
+	uint32_t filterMask = 0;
+};
+void PrepareDrawSceneChunks(
+	const Visibility& vis,
+	uint32_t flags,
+	uint32_t chunk_count,
+	DrawSceneChunks& chunks
+)
+{
+	if (chunks.internal_state == nullptr)
+	{
+		chunks.internal_state = std::make_shared<DrawSceneChunks_Internal>();
+	}
+	DrawSceneChunks_Internal& internal_state = *(DrawSceneChunks_Internal*)chunks.internal_state.get();
+	internal_state.flags = flags;
+	internal_state.filterMask = GetDrawSceneFilterMask(flags);
+	chunks.chunk_count = 0;
+
+	if ((flags & (DRAWSCENE_OPAQUE | DRAWSCENE_TRANSPARENT)) == 0)
+		return;
+
+	RenderQueue& renderQueue = internal_state.renderQueue;
+	BuildDrawSceneQueue(vis, flags, internal_state.filterMask, renderQueue);
+	if (renderQueue.empty())
+		return;
+
+	// Small queues are not worth splitting, every chunk gets at least DRAWSCENE_CHUNK_MIN_BATCHES:
+	const uint32_t batch_count = (uint32_t)renderQueue.size();
+	chunk_count = std::max(1u, std::min(chunk_count, batch_count / DRAWSCENE_CHUNK_MIN_BATCHES));
+	if (internal_state.chunk_queues.size() < chunk_count)
+	{
+		internal_state.chunk_queues.resize(chunk_count);
+	}
+
+	uint32_t begin = 0;
+	for (uint32_t chunk = 0; chunk < chunk_count && begin < batch_count; ++chunk)
+	{
+		uint32_t end = chunk == chunk_count - 1 ? batch_count : std::max(begin + 1, (uint32_t)((uint64_t)batch_count * (chunk + 1) / chunk_count));
+		// Batches of the same mesh are kept in the same chunk, so they can still be instanced together:
+		while (end > 0 && end < batch_count && renderQueue.batches[end].GetMeshIndex() == renderQueue.batches[end - 1].GetMeshIndex())
+		{
+			end++;
+		}
+		RenderQueue& chunk_queue = internal_state.chunk_queues[chunks.chunk_count++];
+		chunk_queue.init();
+		chunk_queue.batches.insert(chunk_queue.batches.end(), renderQueue.batches.begin() + begin, renderQueue.batches.begin() + end);
+		begin = end;
+	}
+}
+void DrawSceneChunk(
+	const Visibility& vis,
+	const DrawSceneChunks& chunks,
+	uint32_t chunk,
+	RENDERPASS renderPass,
+	CommandList cmd
+)
+{
+	if (chunk >= chunks.chunk_count)
+		return;
+	const DrawSceneChunks_Internal& internal_state = *(const DrawSceneChunks_Internal*)chunks.internal_state.get();
+	const RenderQueue& renderQueue = internal_state.chunk_queues[chunk];
+	if (renderQueue.empty())
+		return;
+
+	device->EventBegin("DrawSceneChunk", cmd);
+	device->BindShadingRate(ShadingRate::RATE_1X1, cmd);
+
+	BindCommonResources(cmd);
+
+	RenderMeshes(vis, renderQueue, renderPass, internal_state.filterMask, cmd, internal_state.flags);
+
+	device->BindShadingRate(ShadingRate::RATE_1X1, cmd);
+	device->EventEnd(cmd);
+}
+
 void DrawDebugWorld(
 	const Scene& scene,
 	const CameraComponent& camera,
@@ -8648,31 +9130,31 @@ void RefreshEnvProbes(const Visibility& vis, CommandList cmd)
 		{
 			Sphere culler(probe.position, zFarP);
 
-			static thread_local RenderQueue renderQueue;
-			renderQueue.init();
-			for (size_t i = 0; i < vis.scene->aabb_objects.size(); ++i)
+			Frustum frusta[arraysize(cameras)];
+			for (uint32_t camera_index = 0; camera_index < arraysize(cameras); ++camera_index)
 			{
-				const AABB& aabb = vis.scene->aabb_objects[i];
-				if ((aabb.layerMask & vis.layerMask) && (aabb.layerMask & probe_aabb.layerMask) && culler.intersects(aabb))
-				{
-					const ObjectComponent& object = vis.scene->objects[i];
-					if (object.IsRenderable() && !object.IsNotVisibleInReflections())
-					{
-						uint16_t camera_mask = 0;
-						for (uint32_t camera_index = 0; camera_index < arraysize(cameras); ++camera_index)
-						{
-							if (cameras[camera_index].frustum.CheckBoxFast(aabb))
-							{
-								camera_mask |= 1 << camera_index;
-							}
-						}
-						if (camera_mask == 0)
-							continue;
-
-						renderQueue.add(object.mesh_index, uint32_t(i), 0, object.sort_bits, camera_mask);
-					}
-				}
+				frusta[camera_index] = cameras[camera_index].frustum;
 			}
+			PooledScratch<wi::vector<uint16_t>> culling_masks_scratch;
+			wi::vector<uint16_t>& culling_masks = *culling_masks_scratch;
+			CullObjects(*vis.scene, vis.layerMask, frusta, arraysize(cameras), culling_masks);
+			const uint16_t* masks = culling_masks.data();
+
+			PooledScratch<RenderQueue> renderQueue_scratch;
+			RenderQueue& renderQueue = *renderQueue_scratch;
+			renderQueue.init();
+			renderQueue.add_parallel((uint32_t)vis.scene->aabb_objects.size(), [&](uint32_t i, RenderBatch& batch) {
+				const AABB& aabb = vis.scene->aabb_objects[i];
+				const uint16_t camera_mask = masks[i];
+				if (camera_mask == 0 || (aabb.layerMask & probe_aabb.layerMask) == 0 || !culler.intersects(aabb))
+					return false;
+				const ObjectComponent& object = vis.scene->objects[i];
+				if (!object.IsRenderable() || object.IsNotVisibleInReflections())
+					return false;
+
+				batch.Create(object.mesh_index, i, 0, object.sort_bits, camera_mask);
+				return true;
+			});
 
 			if (!renderQueue.empty())
 			{
@@ -9193,7 +9675,8 @@ void VXGI_Voxelize(
 	AABB bbox;
 	bbox.createFromHalfWidth(clipmap.center, clipmap.extents);
 
-	static thread_local RenderQueue renderQueue;
+	PooledScratch<RenderQueue> renderQueue_scratch;
+	RenderQueue& renderQueue = *renderQueue_scratch;
 	renderQueue.init();
 	for (size_t i = 0; i < scene.aabb_objects.size(); ++i)
 	{
@@ -17902,6 +18385,10 @@ void ComputeReprojectedDepthPyramid(
 
 
 Ray GetPickRay(long cursorX, long cursorY, const wi::Canvas& canvas, const CameraComponent& camera)
+{
+	return GetPickRay((float)cursorX, (float)cursorY, canvas, camera);
+}
+Ray GetPickRay(float cursorX, float cursorY, const wi::Canvas& canvas, const CameraComponent& camera)
 {
 	float screenW = canvas.GetLogicalWidth();
 	float screenH = canvas.GetLogicalHeight();
@@ -17909,8 +18396,8 @@ Ray GetPickRay(long cursorX, long cursorY, const wi::Canvas& canvas, const Camer
 	XMMATRIX V = camera.GetView();
 	XMMATRIX P = camera.GetProjection();
 	XMMATRIX W = XMMatrixIdentity();
-	XMVECTOR lineStart = XMVector3Unproject(XMVectorSet((float)cursorX, (float)cursorY, 1, 1), 0, 0, screenW, screenH, 0.0f, 1.0f, P, V, W);
-	XMVECTOR lineEnd = XMVector3Unproject(XMVectorSet((float)cursorX, (float)cursorY, 0, 1), 0, 0, screenW, screenH, 0.0f, 1.0f, P, V, W);
+	XMVECTOR lineStart = XMVector3Unproject(XMVectorSet(cursorX, cursorY, 1, 1), 0, 0, screenW, screenH, 0.0f, 1.0f, P, V, W);
+	XMVECTOR lineEnd = XMVector3Unproject(XMVectorSet(cursorX, cursorY, 0, 1), 0, 0, screenW, screenH, 0.0f, 1.0f, P, V, W);
 	XMVECTOR rayDirection = XMVector3Normalize(XMVectorSubtract(lineEnd, lineStart));
 	return Ray(lineStart, rayDirection);
 }
@@ -18094,6 +18581,8 @@ void SetOcclusionCullingEnabled(bool value)
 	occlusionCulling = value;
 }
 bool GetOcclusionCullingEnabled() { return occlusionCulling; }
+void SetDrawSceneChunkCount(uint32_t value) { drawSceneChunkCount = std::max(1u, value); }
+uint32_t GetDrawSceneChunkCount() { return drawSceneChunkCount; }
 void SetTemporalAAEnabled(bool enabled) { temporalAA = enabled; }
 bool GetTemporalAAEnabled() { return temporalAA; }
 void SetTemporalAADebugEnabled(bool enabled) { temporalAADEBUG = enabled; }
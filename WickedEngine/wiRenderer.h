@@ -136,6 +136,7 @@ namespace wi::renderer
 		wi::rectpacker::State shadow_packer;
 		wi::rectpacker::Rect rain_blocker_shadow_rect;
 		wi::vector<wi::rectpacker::Rect> visibleLightShadowRects;
+		uint64_t generation = 0; // unique for every UpdateVisibility() call, identifies the result for the DrawScene() queue cache
 
 		std::atomic<uint32_t> object_counter;
 		std::atomic<uint32_t> light_counter;
@@ -250,6 +251,30 @@ namespace wi::renderer
 		uint32_t flags = DRAWSCENE_OPAQUE
 	);
 
+	// The render queue of DrawScene() split into chunks that can be recorded into multiple command lists in parallel
+	struct DrawSceneChunks
+	{
+		std::shared_ptr<void> internal_state;
+		uint32_t chunk_count = 0;
+	};
+	// Gathers and sorts the opaque/transparent objects of DrawScene() once and splits them into at most chunk_count chunks
+	//	Small queues are split into fewer chunks, chunk_count of the result can be 0 if there is nothing to draw
+	void PrepareDrawSceneChunks(
+		const Visibility& vis,
+		uint32_t flags,
+		uint32_t chunk_count,
+		DrawSceneChunks& chunks
+	);
+	// Draw one chunk of PrepareDrawSceneChunks(), the chunks can be recorded by different threads into command lists that are submitted in the order of the chunks
+	//	The ocean, impostors and hair particles are not part of the chunks, they must be drawn with DrawScene()
+	void DrawSceneChunk(
+		const Visibility& vis,
+		const DrawSceneChunks& chunks,
+		uint32_t chunk,
+		wi::enums::RENDERPASS renderPass,
+		wi::graphics::CommandList cmd
+	);
+
 	// Process deferred requests such as AddDeferredMIPGen and AddDeferredBlockCompression:
 	void ProcessDeferredTextureRequests(wi::graphics::CommandList cmd);
 
@@ -1070,6 +1095,9 @@ namespace wi::renderer
 	bool GetVariableRateShadingClassificationDebug();
 	void SetOcclusionCullingEnabled(bool enabled);
 	bool GetOcclusionCullingEnabled();
+	// Number of command lists that the opaque passes of the main camera are recorded into in parallel (1 = single command list)
+	void SetDrawSceneChunkCount(uint32_t value);
+	uint32_t GetDrawSceneChunkCount();
 	void SetTemporalAAEnabled(bool enabled);
 	bool GetTemporalAAEnabled();
 	void SetTemporalAADebugEnabled(bool enabled);
@@ -1120,6 +1148,8 @@ namespace wi::renderer
 
 	// Gets pick ray according to the current screen resolution and pointer coordinates. Can be used as input into RayIntersectWorld()
 	wi::primitive::Ray GetPickRay(long cursorX, long cursorY, const wi::Canvas& canvas, const wi::scene::CameraComponent& camera = wi::scene::GetCamera());
+	// Sub-pixel version of GetPickRay(), the coordinates are unprojected without rounding
+	wi::primitive::Ray GetPickRay(float cursorX, float cursorY, const wi::Canvas& canvas, const wi::scene::CameraComponent& camera = wi::scene::GetCamera());
 
 
 	// Add box to render in next frame. It will be rendered in DrawDebugWorld()
@@ -196,34 +196,53 @@ namespace wi::scene
 			queryAllocator.store(0);
 		}
 
-		if (dt > 0)
-		{
-			// Scan objects to check if lightmap rendering is requested:
-			lightmap_request_allocator.store(0);
-			lightmap_requests.reserve(objects.GetCount());
-			wi::jobsystem::Dispatch(ctx, (uint32_t)objects.GetCount(), small_subtask_groupsize, [this](wi::jobsystem::JobArgs args) {
-				ObjectComponent& object = objects[args.jobIndex];
-				if (object.IsLightmapRenderRequested())
-				{
-					uint32_t request_index = lightmap_request_allocator.fetch_add(1);
-					*(lightmap_requests.data() + request_index) = args.jobIndex;
-				}
-			});
+		// Systems are executed as a task graph, so that each system can start as soon as the systems that it depends on finished:
+		wi::jobsystem::TaskGraph graph;
+
+		// The system tasks are recorded into the profiler timeline, including the jobs that they put on their contexts:
+		auto ProfiledTask = [](const char* name, auto&& task) {
+			return [name, task](wi::jobsystem::context& ctx) {
+				wi::profiler::ScopedEventCPU event(name);
+				task(ctx);
+				wi::jobsystem::Wait(ctx);
+			};
+		};
 
-			// Scan mesh subset counts and skinning data sizes to allocate GPU geometry data:
-			geometryAllocator.store(0u);
-			skinningAllocator.store(0u);
-			wi::jobsystem::Dispatch(ctx, (uint32_t)meshes.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
-				MeshComponent& mesh = meshes[args.jobIndex];
-				mesh.geometryOffset = geometryAllocator.fetch_add((uint32_t)mesh.subsets.size());
-				skinningAllocator.fetch_add(uint32_t(mesh.morph_targets.size() * sizeof(MorphTargetGPU)));
-			});
-			wi::jobsystem::Dispatch(ctx, (uint32_t)armatures.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
-				ArmatureComponent& armature = armatures[args.jobIndex];
-				skinningAllocator.fetch_add(uint32_t(armature.boneCollection.size() * sizeof(ShaderTransform)));
-			});
+		// Object, particle and impostor systems allocate meshlets concurrently:
+		meshletAllocator.store(0u);
 
-			wi::jobsystem::Execute(ctx, [&](wi::jobsystem::JobArgs args) {
+		const uint32_t scan_task = graph.Add(ProfiledTask("Scan", [this, dt](wi::jobsystem::context& ctx) {
+			if (dt > 0)
+			{
+				// Scan objects to check if lightmap rendering is requested:
+				lightmap_request_allocator.store(0);
+				lightmap_requests.reserve(objects.GetCount());
+				wi::jobsystem::Dispatch(ctx, (uint32_t)objects.GetCount(), small_subtask_groupsize, [this](wi::jobsystem::JobArgs args) {
+					ObjectComponent& object = objects[args.jobIndex];
+					if (object.IsLightmapRenderRequested())
+					{
+						uint32_t request_index = lightmap_request_allocator.fetch_add(1);
+						*(lightmap_requests.data() + request_index) = args.jobIndex;
+					}
+				});
+
+				// Scan mesh subset counts and skinning data sizes to allocate GPU geometry data:
+				geometryAllocator.store(0u);
+				skinningAllocator.store(0u);
+				wi::jobsystem::Dispatch(ctx, (uint32_t)meshes.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
+					MeshComponent& mesh = meshes[args.jobIndex];
+					mesh.geometryOffset = geometryAllocator.fetch_add((uint32_t)mesh.subsets.size());
+					skinningAllocator.fetch_add(uint32_t(mesh.morph_targets.size() * sizeof(MorphTargetGPU)));
+				});
+				wi::jobsystem::Dispatch(ctx, (uint32_t)armatures.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
+					ArmatureComponent& armature = armatures[args.jobIndex];
+					skinningAllocator.fetch_add(uint32_t(armature.boneCollection.size() * sizeof(ShaderTransform)));
+				});
+			}
+		}));
+		const uint32_t instance_init_task = graph.Add(ProfiledTask("Instance Init", [this, dt](wi::jobsystem::context& ctx) {
+			if (dt > 0)
+			{
 				// Must not keep inactive instances, so init them for safety:
 				ShaderMeshInstance inst;
 				inst.init();
@@ -231,162 +250,148 @@ namespace wi::scene
 				{
 					std::memcpy(instanceArrayMapped + i, &inst, sizeof(inst));
 				}
-			});
-		}
-
-		RunCharacterUpdateSystem(ctx);
-
-		RunAnimationUpdateSystem(ctx);
-
-		wi::physics::RunPhysicsUpdateSystem(ctx, *this, dt);
-
-		RunTransformUpdateSystem(ctx);
-
-		wi::jobsystem::Wait(ctx); // dependencies
-
-		RunHierarchyUpdateSystem(ctx);
+			}
+		}));
 
-		// Lightmap requests are determined at this point, so we know if we need TLAS or not:
-		if (lightmap_request_allocator.load() > 0)
-		{
-			SetAccelerationStructureUpdateRequested(true);
-		}
+		const uint32_t character_task = graph.Add(ProfiledTask("Character", [this](wi::jobsystem::context& ctx) { RunCharacterUpdateSystem(ctx); }));
+		const uint32_t animation_task = graph.Add(ProfiledTask("Animation", [this](wi::jobsystem::context& ctx) { RunAnimationUpdateSystem(ctx); }), { character_task });
+		const uint32_t physics_task = graph.Add(ProfiledTask("Physics", [this, dt](wi::jobsystem::context& ctx) { wi::physics::RunPhysicsUpdateSystem(ctx, *this, dt); }), { animation_task });
+		const uint32_t transform_task = graph.Add(ProfiledTask("Transform", [this](wi::jobsystem::context& ctx) { RunTransformUpdateSystem(ctx); }), { physics_task });
+		const uint32_t hierarchy_task = graph.Add(ProfiledTask("Hierarchy", [this](wi::jobsystem::context& ctx) { RunHierarchyUpdateSystem(ctx); }), { transform_task });
 
-		// This must be after lightmap requests were determined:
-		TLAS_instancesMapped = nullptr;
-		if (IsAccelerationStructureUpdateRequested() && device->CheckCapability(GraphicsDeviceCapability::RAYTRACING))
-		{
-			GPUBufferDesc desc;
-			desc.stride = (uint32_t)device->GetTopLevelAccelerationStructureInstanceSize();
-			desc.size = desc.stride * instanceArraySize * 2; // *2 to grow fast
-			desc.usage = Usage::UPLOAD;
-			if (TLAS_instancesUpload->desc.size < desc.size)
+		// GPU data allocation depends on the scan results:
+		const uint32_t allocation_task = graph.Add(ProfiledTask("Allocation", [this, device](wi::jobsystem::context& ctx) {
+			// Lightmap requests are determined at this point, so we know if we need TLAS or not:
+			if (lightmap_request_allocator.load() > 0)
 			{
-				for (int i = 0; i < arraysize(TLAS_instancesUpload); ++i)
-				{
-					device->CreateBuffer(&desc, nullptr, &TLAS_instancesUpload[i]);
-					device->SetName(&TLAS_instancesUpload[i], "Scene::TLAS_instancesUpload");
-				}
+				SetAccelerationStructureUpdateRequested(true);
 			}
-			TLAS_instancesMapped = TLAS_instancesUpload[device->GetBufferIndex()].mapped_data;
 
-			wi::jobsystem::Execute(ctx, [&](wi::jobsystem::JobArgs args) {
-				// Must not keep inactive TLAS instances, so zero them out for safety:
-				std::memset(TLAS_instancesMapped, 0, TLAS_instancesUpload->desc.size);
-				});
-		}
-
-		// GPU subset count allocation is ready at this point:
-		geometryArraySize = geometryAllocator.load();
-		geometryArraySize += hairs.GetCount();
-		geometryArraySize += emitters.GetCount();
-		if (impostors.GetCount() > 0)
-		{
-			impostorGeometryOffset = uint32_t(geometryArraySize);
-			geometryArraySize += 1;
-		}
-		if (weathers.GetCount() > 0 && weathers[0].rain_amount > 0)
-		{
-			rainGeometryOffset = uint32_t(geometryArraySize);
-			geometryArraySize += 1;
-		}
-		if (geometryUploadBuffer[0].desc.size < (geometryArraySize * sizeof(ShaderGeometry)))
-		{
-			GPUBufferDesc desc;
-			desc.stride = sizeof(ShaderGeometry);
-			desc.size = desc.stride * geometryArraySize * 2; // *2 to grow fast
-			desc.bind_flags = BindFlag::SHADER_RESOURCE;
-			desc.misc_flags = ResourceMiscFlag::BUFFER_STRUCTURED;
-			if (!device->CheckCapability(GraphicsDeviceCapability::CACHE_COHERENT_UMA))
+			// This must be after lightmap requests were determined:
+			TLAS_instancesMapped = nullptr;
+			if (IsAccelerationStructureUpdateRequested() && device->CheckCapability(GraphicsDeviceCapability::RAYTRACING))
 			{
-				// Non-UMA: separate Default usage buffer
-				device->CreateBuffer(&desc, nullptr, &geometryBuffer);
-				device->SetName(&geometryBuffer, "Scene::geometryBuffer");
+				GPUBufferDesc desc;
+				desc.stride = (uint32_t)device->GetTopLevelAccelerationStructureInstanceSize();
+				desc.size = desc.stride * instanceArraySize * 2; // *2 to grow fast
+				desc.usage = Usage::UPLOAD;
+				if (TLAS_instancesUpload->desc.size < desc.size)
+				{
+					for (int i = 0; i < arraysize(TLAS_instancesUpload); ++i)
+					{
+						device->CreateBuffer(&desc, nullptr, &TLAS_instancesUpload[i]);
+						device->SetName(&TLAS_instancesUpload[i], "Scene::TLAS_instancesUpload");
+					}
+				}
+				TLAS_instancesMapped = TLAS_instancesUpload[device->GetBufferIndex()].mapped_data;
 
-				// Upload buffer shouldn't be used by shaders with Non-UMA:
-				desc.bind_flags = BindFlag::NONE;
-				desc.misc_flags = ResourceMiscFlag::NONE;
+				wi::jobsystem::Execute(ctx, [&](wi::jobsystem::JobArgs args) {
+					// Must not keep inactive TLAS instances, so zero them out for safety:
+					std::memset(TLAS_instancesMapped, 0, TLAS_instancesUpload->desc.size);
+					});
 			}
 
-			desc.usage = Usage::UPLOAD;
-			for (int i = 0; i < arraysize(geometryUploadBuffer); ++i)
+			// GPU subset count allocation is ready at this point:
+			geometryArraySize = geometryAllocator.load();
+			geometryArraySize += hairs.GetCount();
+			geometryArraySize += emitters.GetCount();
+			if (impostors.GetCount() > 0)
 			{
-				device->CreateBuffer(&desc, nullptr, &geometryUploadBuffer[i]);
-				device->SetName(&geometryUploadBuffer[i], "Scene::geometryUploadBuffer");
+				impostorGeometryOffset = uint32_t(geometryArraySize);
+				geometryArraySize += 1;
 			}
-		}
-		geometryArrayMapped = (ShaderGeometry*)geometryUploadBuffer[device->GetBufferIndex()].mapped_data;
-
-		// Skinning data size is ready at this point:
-		skinningDataSize = skinningAllocator.load();
-		skinningAllocator.store(0);
-		if (skinningUploadBuffer[0].desc.size < skinningDataSize)
-		{
-			GPUBufferDesc desc;
-			desc.size = skinningDataSize * 2; // *2 to grow fast
-			desc.bind_flags = BindFlag::SHADER_RESOURCE;
-			desc.misc_flags = ResourceMiscFlag::BUFFER_RAW;
-			if (!device->CheckCapability(GraphicsDeviceCapability::CACHE_COHERENT_UMA))
+			if (weathers.GetCount() > 0 && weathers[0].rain_amount > 0)
 			{
-				// Non-UMA: separate Default usage buffer
-				device->CreateBuffer(&desc, nullptr, &skinningBuffer);
-				device->SetName(&skinningBuffer, "Scene::skinningBuffer");
-
-				// Upload buffer shouldn't be used by shaders with Non-UMA:
-				desc.bind_flags = BindFlag::NONE;
-				desc.misc_flags = ResourceMiscFlag::NONE;
+				rainGeometryOffset = uint32_t(geometryArraySize);
+				geometryArraySize += 1;
 			}
-
-			desc.usage = Usage::UPLOAD;
-			for (int i = 0; i < arraysize(skinningUploadBuffer); ++i)
+			if (geometryUploadBuffer[0].desc.size < (geometryArraySize * sizeof(ShaderGeometry)))
 			{
-				device->CreateBuffer(&desc, nullptr, &skinningUploadBuffer[i]);
-				device->SetName(&skinningUploadBuffer[i], "Scene::skinningUploadBuffer");
-			}
-		}
-		skinningDataMapped = skinningUploadBuffer[device->GetBufferIndex()].mapped_data;
-
-		RunExpressionUpdateSystem(ctx);
-
-		RunMeshUpdateSystem(ctx);
-
-		RunMaterialUpdateSystem(ctx);
-
-		wi::jobsystem::Wait(ctx); // dependencies
-
-		RunProceduralAnimationUpdateSystem(ctx);
-
-		RunArmatureUpdateSystem(ctx);
-
-		RunWeatherUpdateSystem(ctx);
-
-		wi::jobsystem::Wait(ctx); // dependencies
-
-		RunObjectUpdateSystem(ctx);
-
-		RunCameraUpdateSystem(ctx);
-
-		RunDecalUpdateSystem(ctx);
-
-		RunProbeUpdateSystem(ctx);
-
-		RunForceUpdateSystem(ctx);
-
-		RunLightUpdateSystem(ctx);
-
-		RunParticleUpdateSystem(ctx);
-
-		RunSoundUpdateSystem(ctx);
-
-		RunVideoUpdateSystem(ctx);
-
-		RunImpostorUpdateSystem(ctx);
+				GPUBufferDesc desc;
+				desc.stride = sizeof(ShaderGeometry);
+				desc.size = desc.stride * geometryArraySize * 2; // *2 to grow fast
+				desc.bind_flags = BindFlag::SHADER_RESOURCE;
+				desc.misc_flags = ResourceMiscFlag::BUFFER_STRUCTURED;
+				if (!device->CheckCapability(GraphicsDeviceCapability::CACHE_COHERENT_UMA))
+				{
+					// Non-UMA: separate Default usage buffer
+					device->CreateBuffer(&desc, nullptr, &geometryBuffer);
+					device->SetName(&geometryBuffer, "Scene::geometryBuffer");
 
-		RunSpriteUpdateSystem(ctx);
+					// Upload buffer shouldn't be used by shaders with Non-UMA:
+					desc.bind_flags = BindFlag::NONE;
+					desc.misc_flags = ResourceMiscFlag::NONE;
+				}
 
-		RunFontUpdateSystem(ctx);
+				desc.usage = Usage::UPLOAD;
+				for (int i = 0; i < arraysize(geometryUploadBuffer); ++i)
+				{
+					device->CreateBuffer(&desc, nullptr, &geometryUploadBuffer[i]);
+					device->SetName(&geometryUploadBuffer[i], "Scene::geometryUploadBuffer");
+				}
+			}
+			geometryArrayMapped = (ShaderGeometry*)geometryUploadBuffer[device->GetBufferIndex()].mapped_data;
 
-		wi::jobsystem::Wait(ctx); // dependencies
+			// Skinning data size is ready at this point:
+			skinningDataSize = skinningAllocator.load();
+			skinningAllocator.store(0);
+			if (skinningUploadBuffer[0].desc.size < skinningDataSize)
+			{
+				GPUBufferDesc desc;
+				desc.size = skinningDataSize * 2; // *2 to grow fast
+				desc.bind_flags = BindFlag::SHADER_RESOURCE;
+				desc.misc_flags = ResourceMiscFlag::BUFFER_RAW;
+				if (!device->CheckCapability(GraphicsDeviceCapability::CACHE_COHERENT_UMA))
+				{
+					// Non-UMA: separate Default usage buffer
+					device->CreateBuffer(&desc, nullptr, &skinningBuffer);
+					device->SetName(&skinningBuffer, "Scene::skinningBuffer");
+
+					// Upload buffer shouldn't be used by shaders with Non-UMA:
+					desc.bind_flags = BindFlag::NONE;
+					desc.misc_flags = ResourceMiscFlag::NONE;
+				}
+
+				desc.usage = Usage::UPLOAD;
+				for (int i = 0; i < arraysize(skinningUploadBuffer); ++i)
+				{
+					device->CreateBuffer(&desc, nullptr, &skinningUploadBuffer[i]);
+					device->SetName(&skinningUploadBuffer[i], "Scene::skinningUploadBuffer");
+				}
+			}
+			skinningDataMapped = skinningUploadBuffer[device->GetBufferIndex()].mapped_data;
+		}), { scan_task });
+
+		// Expressions and materials can be animated:
+		const uint32_t expression_task = graph.Add(ProfiledTask("Expression", [this](wi::jobsystem::context& ctx) { RunExpressionUpdateSystem(ctx); }), { animation_task });
+		const uint32_t material_task = graph.Add(ProfiledTask("Material", [this](wi::jobsystem::context& ctx) { RunMaterialUpdateSystem(ctx); }), { animation_task });
+		const uint32_t mesh_task = graph.Add(ProfiledTask("Mesh", [this](wi::jobsystem::context& ctx) { RunMeshUpdateSystem(ctx); }), { expression_task, physics_task, allocation_task });
+
+		// Procedural animations need the final hierarchy, and their ray casts read meshes and materials:
+		const uint32_t procedural_animation_task = graph.Add(ProfiledTask("Procedural Animation", [this](wi::jobsystem::context& ctx) { RunProceduralAnimationUpdateSystem(ctx); }), { hierarchy_task, mesh_task, material_task });
+		const uint32_t armature_task = graph.Add(ProfiledTask("Armature", [this](wi::jobsystem::context& ctx) { RunArmatureUpdateSystem(ctx); }), { procedural_animation_task, allocation_task });
+		// The weather is read by physics, characters and springs, so it can only be replaced after those:
+		const uint32_t weather_task = graph.Add(ProfiledTask("Weather", [this](wi::jobsystem::context& ctx) { RunWeatherUpdateSystem(ctx); }), { procedural_animation_task, instance_init_task, allocation_task });
+
+		const uint32_t object_task = graph.Add(ProfiledTask("Object", [this](wi::jobsystem::context& ctx) { RunObjectUpdateSystem(ctx); }), { armature_task, instance_init_task });
+		graph.Add(ProfiledTask("Object BVH", [this](wi::jobsystem::context& ctx) { RunObjectBVHUpdateSystem(ctx); }), { object_task });
+		const uint32_t mesh_bvh_skinning_task = graph.Add(ProfiledTask("Mesh BVH Skinning", [this](wi::jobsystem::context& ctx) { RunMeshBVHSkinningSystem(ctx); }), { armature_task });
+		graph.Add(ProfiledTask("Mesh BVH Refit", [this](wi::jobsystem::context& ctx) { RunMeshBVHRefitSystem(ctx); }), { mesh_bvh_skinning_task });
+		graph.Add(ProfiledTask("Camera", [this](wi::jobsystem::context& ctx) { RunCameraUpdateSystem(ctx); }), { procedural_animation_task });
+		graph.Add(ProfiledTask("Decal", [this](wi::jobsystem::context& ctx) { RunDecalUpdateSystem(ctx); }), { procedural_animation_task });
+		graph.Add(ProfiledTask("Probe", [this](wi::jobsystem::context& ctx) { RunProbeUpdateSystem(ctx); }), { procedural_animation_task });
+		graph.Add(ProfiledTask("Force", [this](wi::jobsystem::context& ctx) { RunForceUpdateSystem(ctx); }), { procedural_animation_task });
+		graph.Add(ProfiledTask("Light", [this](wi::jobsystem::context& ctx) { RunLightUpdateSystem(ctx); }), { weather_task }); // lights write the sun into weather
+		graph.Add(ProfiledTask("Particle", [this](wi::jobsystem::context& ctx) { RunParticleUpdateSystem(ctx); }), { weather_task });
+		// Sounds are read by expressions and fonts:
+		const uint32_t sound_task = graph.Add(ProfiledTask("Sound", [this](wi::jobsystem::context& ctx) { RunSoundUpdateSystem(ctx); }), { procedural_animation_task });
+		graph.Add(ProfiledTask("Font", [this](wi::jobsystem::context& ctx) { RunFontUpdateSystem(ctx); }), { sound_task });
+		graph.Add(ProfiledTask("Impostor", [this](wi::jobsystem::context& ctx) { RunImpostorUpdateSystem(ctx); }), { mesh_task, instance_init_task });
+		graph.Add(ProfiledTask("Video", [this](wi::jobsystem::context& ctx) { RunVideoUpdateSystem(ctx); }));
+		graph.Add(ProfiledTask("Sprite", [this](wi::jobsystem::context& ctx) { RunSpriteUpdateSystem(ctx); }));
+
+		graph.Run(ctx);
+		wi::jobsystem::Wait(ctx);
 
 		// Merge parallel bounds computation (depends on object update system):
 		bounds = AABB();
@@ -409,6 +414,42 @@ namespace wi::scene
 			device->SetName(&meshletBuffer, "meshletBuffer");
 		}
 
+		if (IsAccelerationStructureUpdateRequested())
+		{
+			// The acceleration structure rebuild can be skipped if nothing changed since the last rebuild:
+			const uint64_t generation = componentLibrary.GetGeneration();
+			bool changed =
+				generation != acceleration_structure_generation ||
+				transforms.IsAnyDirty() ||
+				materials.IsAnyDirty() ||
+				TLAS_instances_changed.load() ||
+				hairs.GetCount() > 0 ||
+				emitters.GetCount() > 0 ||
+				softbodies.GetCount() > 0 ||
+				(weathers.GetCount() > 0 && weathers[0].rain_amount > 0)
+				;
+			if (device->CheckCapability(GraphicsDeviceCapability::RAYTRACING))
+			{
+				for (size_t i = 0; i < meshes.GetCount() && !changed; ++i)
+				{
+					changed = meshes[i].BLAS_state != MeshComponent::BLAS_STATE_COMPLETE;
+				}
+			}
+			for (size_t i = 0; i < objects.GetCount() && !changed; ++i)
+			{
+				changed = objects[i].IsDynamic();
+			}
+
+			if (changed)
+			{
+				acceleration_structure_generation = generation;
+			}
+			else
+			{
+				SetAccelerationStructureUpdateRequested(false);
+			}
+		}
+
 		if (IsAccelerationStructureUpdateRequested())
 		{
 			if (device->CheckCapability(GraphicsDeviceCapability::RAYTRACING))
@@ -1030,6 +1071,10 @@ namespace wi::scene
 			shaderscene.voxelgrid.voxelSize = voxelgrid.voxelSize;
 			shaderscene.voxelgrid.voxelSize_rcp = voxelgrid.voxelSize_rcp;
 		}
+
+		// Changes are tracked from one update to the next:
+		transforms.ClearDirty();
+		materials.ClearDirty();
 	}
 	void Scene::Clear()
 	{
@@ -1047,6 +1092,7 @@ namespace wi::scene
 		ocean = {};
 
 		aabb_objects.clear();
+		aabb_objects_stream.resize(0);
 		aabb_lights.clear();
 		aabb_decals.clear();
 		aabb_probes.clear();
@@ -2808,17 +2854,72 @@ namespace wi::scene
 		wi::jobsystem::Dispatch(ctx, (uint32_t)transforms.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
 
 			TransformComponent& transform = transforms[args.jobIndex];
+			if (transform.IsDirty())
+			{
+				transforms.SetDirtyIndex(args.jobIndex);
+			}
 			transform.UpdateTransform();
 		});
 	}
 	void Scene::RunHierarchyUpdateSystem(wi::jobsystem::context& ctx)
 	{
-		wi::jobsystem::Dispatch(ctx, (uint32_t)hierarchy.GetCount(), small_subtask_groupsize, [&](wi::jobsystem::JobArgs args) {
+		// Incremental update is possible when the hierarchy structure, parents and layers are the same as in the previous update
+		//	Springs, inverse kinematics and humanoids write world matrices directly after this system, so those need full update
+		const uint64_t generation = transforms.GetGeneration() + hierarchy.GetGeneration() + layers.GetGeneration();
+		bool incremental = generation == hierarchy_generation && springs.GetCount() == 0 && inverse_kinematics.GetCount() == 0 && humanoids.GetCount() == 0;
+		hierarchy_generation = generation;
+
+		hierarchy_parents_prev.resize(hierarchy.GetCount());
+		for (size_t i = 0; i < hierarchy.GetCount(); ++i)
+		{
+			if (hierarchy_parents_prev[i] != hierarchy[i].parentID)
+			{
+				hierarchy_parents_prev[i] = hierarchy[i].parentID;
+				incremental = false;
+			}
+		}
+		layer_masks_prev.resize(layers.GetCount());
+		for (size_t i = 0; i < layers.GetCount(); ++i)
+		{
+			if (layer_masks_prev[i] != layers[i].layerMask)
+			{
+				layer_masks_prev[i] = layers[i].layerMask;
+				incremental = false;
+			}
+		}
+
+		if (incremental && !transforms.IsAnyDirty())
+			return; // nothing moved
+
+		// The jobs read the dirty flags of the parents, so the recomputed transforms are flagged in a separate array,
+		//	which is merged into the dirty flags when all the jobs are finished (descendants of changed transforms are also changed)
+		hierarchy_recomputed.resize(transforms.GetCount());
+		std::fill(hierarchy_recomputed.begin(), hierarchy_recomputed.end(), uint8_t(0));
+		wi::jobsystem::context hierarchy_ctx;
+		hierarchy_ctx.priority = ctx.priority;
+		wi::jobsystem::Dispatch(hierarchy_ctx, (uint32_t)hierarchy.GetCount(), small_subtask_groupsize, [this, incremental](wi::jobsystem::JobArgs args) {
 
 			HierarchyComponent& hier = hierarchy[args.jobIndex];
 			Entity entity = hierarchy.GetEntity(args.jobIndex);
 
-			TransformComponent* transform_child = transforms.GetComponent(entity);
+			const size_t transform_index = transforms.GetIndex(entity);
+			if (incremental)
+			{
+				// Only the changed transforms and their descendants need to be recomputed:
+				bool changed = transform_index != ~0ull && transforms.IsDirtyIndex(transform_index);
+				Entity parentID = hier.parentID;
+				while (!changed && parentID != INVALID_ENTITY)
+				{
+					const size_t parent_index = transforms.GetIndex(parentID);
+					changed = parent_index != ~0ull && transforms.IsDirtyIndex(parent_index);
+					const HierarchyComponent* hier_recursive = hierarchy.GetComponent(parentID);
+					parentID = hier_recursive != nullptr ? hier_recursive->parentID : INVALID_ENTITY;
+				}
+				if (!changed)
+					return;
+			}
+
+			TransformComponent* transform_child = transform_index != ~0ull ? &transforms[transform_index] : nullptr;
 			XMMATRIX worldmatrix;
 			if (transform_child != nullptr)
 			{
@@ -2863,9 +2964,19 @@ namespace wi::scene
 			if (transform_child != nullptr)
 			{
 				XMStoreFloat4x4(&transform_child->world, worldmatrix);
+				hierarchy_recomputed[transform_index] = 1;
 			}
 
 		});
+		wi::jobsystem::Wait(hierarchy_ctx);
+
+		for (size_t i = 0; i < hierarchy_recomputed.size(); ++i)
+		{
+			if (hierarchy_recomputed[i])
+			{
+				transforms.SetDirtyIndex(i);
+			}
+		}
 	}
 	void Scene::RunExpressionUpdateSystem(wi::jobsystem::context& ctx)
 	{
@@ -4072,6 +4183,7 @@ namespace wi::scene
 
 			if (material.IsDirty())
 			{
+				materials.SetDirtyIndex(args.jobIndex);
 				material.SetDirty(false);
 			}
 
@@ -4260,11 +4372,16 @@ namespace wi::scene
 	void Scene::RunObjectUpdateSystem(wi::jobsystem::context& ctx)
 	{
 		aabb_objects.resize(objects.GetCount());
+		aabb_objects_stream.resize(objects.GetCount());
 		matrix_objects.resize(objects.GetCount());
 		matrix_objects_prev.resize(objects.GetCount());
 		occlusion_results_objects.resize(objects.GetCount());
 
-		meshletAllocator.store(0u);
+		if (TLAS_instancesMapped != nullptr)
+		{
+			TLAS_instances_prev.resize(objects.GetCount());
+			TLAS_instances_changed.store(false);
+		}
 
 		parallel_bounds.clear();
 		parallel_bounds.resize((size_t)wi::jobsystem::DispatchGroupCount((uint32_t)objects.GetCount(), small_subtask_groupsize));
@@ -4550,6 +4667,20 @@ namespace wi::scene
 
 					void* dest = (void*)((size_t)TLAS_instancesMapped + (size_t)args.jobIndex * device->GetTopLevelAccelerationStructureInstanceSize());
 					device->WriteTopLevelAccelerationStructureInstance(&instance, dest);
+
+					// Compare with the previous instance, the TLAS doesn't need rebuild if none of them changed:
+					RaytracingAccelerationStructureDesc::TopLevel::Instance& instance_prev = TLAS_instances_prev[args.jobIndex];
+					if (
+						std::memcmp(instance.transform, instance_prev.transform, sizeof(instance.transform)) != 0 ||
+						instance.instance_id != instance_prev.instance_id ||
+						instance.instance_mask != instance_prev.instance_mask ||
+						instance.flags != instance_prev.flags ||
+						instance.bottom_level != instance_prev.bottom_level
+						)
+					{
+						instance_prev = instance;
+						TLAS_instances_changed.store(true, std::memory_order_relaxed);
+					}
 				}
 
 				// lightmap things:
@@ -4613,6 +4744,81 @@ namespace wi::scene
 				}
 			}
 
+			aabb_objects_stream.set(args.jobIndex, aabb);
+
+		});
+	}
+	void Scene::RunObjectBVHUpdateSystem(wi::jobsystem::context& ctx)
+	{
+		const uint32_t objectCount = (uint32_t)aabb_objects.size();
+		if (objectCount == 0)
+		{
+			object_bvh = {};
+			object_bvh_generation = ~0ull;
+			return;
+		}
+
+		// The tree is only rebuilt when objects were added/removed/reordered or the refitted tree became too loose:
+		const uint64_t generation = objects.GetGeneration();
+		if (object_bvh.IsValid() && object_bvh.leaf_count == objectCount && object_bvh_generation == generation)
+		{
+			const float cost = object_bvh.Refit(aabb_objects.data());
+			if (cost <= object_bvh_cost * 2)
+				return;
+		}
+
+		object_bvh.Build(aabb_objects.data(), objectCount);
+		object_bvh_cost = object_bvh.GetCost();
+		object_bvh_generation = generation;
+	}
+	void Scene::RunMeshBVHSkinningSystem(wi::jobsystem::context& ctx)
+	{
+		// The CPU BVH of skinned meshes is built in bind pose, so the positions are skinned once per update here and the tree is refitted to them,
+		//	instead of intersection queries skinning every triangle that they visit
+		bvh_refit_meshes.clear();
+		for (size_t i = 0; i < meshes.GetCount(); ++i)
+		{
+			MeshComponent& mesh = meshes[i];
+			if (!mesh.bvh.IsValid())
+				continue;
+
+			const wi::vector<ShaderTransform>* boneData = nullptr;
+			const SoftBodyPhysicsComponent* softbody = softbodies.GetComponent(meshes.GetEntity(i));
+			if (softbody != nullptr && !softbody->boneData.empty())
+			{
+				boneData = &softbody->boneData;
+			}
+			else if (mesh.IsSkinned())
+			{
+				const ArmatureComponent* armature = armatures.GetComponent(mesh.armatureID);
+				if (armature != nullptr && !armature->boneData.empty())
+				{
+					boneData = &armature->boneData;
+				}
+			}
+
+			if (boneData == nullptr)
+			{
+				if (!mesh.bvh_skinned_positions.empty())
+				{
+					// no longer skinned, refit back to the bind pose:
+					mesh.bvh_skinned_positions.clear();
+					bvh_refit_meshes.push_back(i);
+				}
+				continue;
+			}
+
+			mesh.bvh_skinned_positions.resize(mesh.vertex_positions.size());
+			wi::jobsystem::Dispatch(ctx, (uint32_t)mesh.vertex_positions.size(), 256, [&mesh, boneData](wi::jobsystem::JobArgs args) {
+				XMStoreFloat3(&mesh.bvh_skinned_positions[args.jobIndex], SkinVertex(mesh, *boneData, args.jobIndex));
+			});
+			bvh_refit_meshes.push_back(i);
+		}
+	}
+	void Scene::RunMeshBVHRefitSystem(wi::jobsystem::context& ctx)
+	{
+		wi::jobsystem::Dispatch(ctx, (uint32_t)bvh_refit_meshes.size(), 1, [this](wi::jobsystem::JobArgs args) {
+			meshes[bvh_refit_meshes[args.jobIndex]].RefitBVH();
 		});
 	}
 	void Scene::RunCameraUpdateSystem(wi::jobsystem::context& ctx)
@@ -5684,6 +5890,25 @@ namespace wi::scene
 		wi::jobsystem::Wait(ctx);
 	}
 
+	// Visits the objects whose AABB can intersect the primitive, through the object BVH if it is up to date with the objects, otherwise all of them
+	//	Returning true from callback will immediately exit the search
+	template <typename T>
+	static bool IntersectsObjects(const Scene& scene, const T& primitive, const std::function<bool(uint32_t objectIndex)>& callback)
+	{
+		const uint32_t objectCount = (uint32_t)std::min(scene.objects.GetCount(), scene.aabb_objects.size());
+		if (scene.object_bvh.IsValid() && scene.object_bvh.leaf_count == objectCount)
+		{
+			return scene.object_bvh.IntersectsFirst(primitive, [&](uint32_t objectIndex) {
+				return objectIndex < objectCount && callback(objectIndex);
+			});
+		}
+		for (uint32_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+		{
+			if (callback(objectIndex))
+				return true;
+		}
+		return false;
+	}
 	Scene::RayIntersectionResult Scene::Intersects(const Ray& ray, uint32_t filterMask, uint32_t layerMask, uint32_t lod) const
 	{
 		RayIntersectionResult result;
@@ -5741,24 +5966,23 @@ namespace wi::scene
 
 		if (filterMask & FILTER_OBJECT_ALL)
 		{
-			const size_t objectCount = std::min(objects.GetCount(), aabb_objects.size());
-			for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+			auto intersect_object = [&](uint32_t objectIndex)
 			{
 				const AABB& aabb = aabb_objects[objectIndex];
 				if ((layerMask & aabb.layerMask) == 0)
-					continue;
+					return false;
 				if (!ray.intersects(aabb))
-					continue;
+					return false;
 
 				const ObjectComponent& object = objects[objectIndex];
 				if (object.meshID == INVALID_ENTITY)
-					continue;
+					return false;
 				if ((filterMask & object.GetFilterMask()) == 0)
-					continue;
+					return false;
 
 				const MeshComponent* mesh = meshes.GetComponent(object.meshID);
 				if (mesh == nullptr)
-					continue;
+					return false;
 
 				const Entity entity = objects.GetEntity(objectIndex);
 				const SoftBodyPhysicsComponent* softbody = softbodies.GetComponent(object.meshID);
@@ -5778,7 +6002,13 @@ namespace wi::scene
 					XMVECTOR p0;
 					XMVECTOR p1;
 					XMVECTOR p2;
-					if (softbody != nullptr && !softbody->boneData.empty())
+					if (mesh->IsBVHSkinned())
+					{
+						p0 = XMLoadFloat3(&mesh->bvh_skinned_positions[i0]);
+						p1 = XMLoadFloat3(&mesh->bvh_skinned_positions[i1]);
+						p2 = XMLoadFloat3(&mesh->bvh_skinned_positions[i2]);
+					}
+					else if (softbody != nullptr && !softbody->boneData.empty())
 					{
 						p0 = SkinVertex(*mesh, *softbody, i0);
 						p1 = SkinVertex(*mesh, *softbody, i1);
@@ -5901,8 +6131,9 @@ namespace wi::scene
 						}
 					}
 				}
-
-			}
+				return false;
+			};
+			IntersectsObjects(*this, ray, intersect_object);
 		}
 
 		if (filterMask & FILTER_RAGDOLL)
@@ -5947,6 +6178,50 @@ namespace wi::scene
 
 		return result;
 	}
+	void Scene::IntersectsBatch(const Ray* rays, size_t count, RayIntersectionResult* results, uint32_t filterMask, uint32_t layerMask, uint32_t lod) const
+	{
+		if (count == 0)
+			return;
+
+		// Rays are traced in an order sorted by direction octant, then by the morton code of their origin,
+		//	so that rays processed by the same job walk through similar BVH nodes and triangles
+		AABB bounds;
+		for (size_t i = 0; i < count; ++i)
+		{
+			bounds = AABB::Merge(bounds, AABB(rays[i].origin, rays[i].origin));
+		}
+		const XMVECTOR bounds_min = XMLoadFloat3(&bounds._min);
+		const XMVECTOR bounds_extent = XMVectorMax(XMVectorSubtract(XMLoadFloat3(&bounds._max), bounds_min), XMVectorReplicate(std::numeric_limits<float>::epsilon()));
+		auto expand_bits = [](uint32_t v) {
+			v = (v * 0x00010001u) & 0xFF0000FFu;
+			v = (v * 0x00000101u) & 0x0F00F00Fu;
+			v = (v * 0x00000011u) & 0xC30C30C3u;
+			v = (v * 0x00000005u) & 0x49249249u;
+			return v;
+		};
+
+		wi::vector<uint64_t> order(count); // high 32 bits: sort key, low 32 bits: ray index
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Ray& ray = rays[i];
+			XMFLOAT3 cell;
+			XMStoreFloat3(&cell, XMVectorClamp(XMVectorDivide(XMVectorSubtract(XMLoadFloat3(&ray.origin), bounds_min), bounds_extent), XMVectorZero(), XMVectorSplatOne()) * 511.0f);
+			uint32_t key = 0;
+			key |= ray.direction.x < 0 ? (1u << 29u) : 0;
+			key |= ray.direction.y < 0 ? (1u << 30u) : 0;
+			key |= ray.direction.z < 0 ? (1u << 31u) : 0;
+			key |= (expand_bits((uint32_t)cell.x) << 2u) | (expand_bits((uint32_t)cell.y) << 1u) | expand_bits((uint32_t)cell.z);
+			order[i] = (uint64_t(key) << 32ull) | uint64_t(i);
+		}
+		std::sort(order.begin(), order.end());
+
+		wi::jobsystem::context ctx;
+		wi::jobsystem::Dispatch(ctx, (uint32_t)count, 64, [&](wi::jobsystem::JobArgs args) {
+			const uint32_t index = uint32_t(order[args.jobIndex] & 0xFFFFFFFFull);
+			results[index] = Intersects(rays[index], filterMask, layerMask, lod);
+		});
+		wi::jobsystem::Wait(ctx);
+	}
 	bool Scene::IntersectsFirst(const Ray& ray, uint32_t filterMask, uint32_t layerMask, uint32_t lod) const
 	{
 		bool result = false;
@@ -5995,24 +6270,23 @@ namespace wi::scene
 
 		if (filterMask & FILTER_OBJECT_ALL)
 		{
-			const size_t objectCount = std::min(objects.GetCount(), aabb_objects.size());
-			for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+			auto intersect_object = [&](uint32_t objectIndex)
 			{
 				const AABB& aabb = aabb_objects[objectIndex];
 				if ((layerMask & aabb.layerMask) == 0)
-					continue;
+					return false;
 				if (!ray.intersects(aabb))
-					continue;
+					return false;
 
 				const ObjectComponent& object = objects[objectIndex];
 				if (object.meshID == INVALID_ENTITY)
-					continue;
+					return false;
 				if ((filterMask & object.GetFilterMask()) == 0)
-					continue;
+					return false;
 
 				const MeshComponent* mesh = meshes.GetComponent(object.meshID);
 				if (mesh == nullptr)
-					continue;
+					return false;
 
 				const Entity entity = objects.GetEntity(objectIndex);
 				const SoftBodyPhysicsComponent* softbody = softbodies.GetComponent(object.meshID);
@@ -6032,7 +6306,13 @@ namespace wi::scene
 					XMVECTOR p0;
 					XMVECTOR p1;
 					XMVECTOR p2;
-					if (softbody != nullptr && !softbody->boneData.empty())
+					if (mesh->IsBVHSkinned())
+					{
+						p0 = XMLoadFloat3(&mesh->bvh_skinned_positions[i0]);
+						p1 = XMLoadFloat3(&mesh->bvh_skinned_positions[i1]);
+						p2 = XMLoadFloat3(&mesh->bvh_skinned_positions[i2]);
+					}
+					else if (softbody != nullptr && !softbody->boneData.empty())
 					{
 						p0 = SkinVertex(*mesh, *softbody, i0);
 						p1 = SkinVertex(*mesh, *softbody, i1);
@@ -6108,8 +6388,10 @@ namespace wi::scene
 						}
 					}
 				}
-
-			}
+				return result;
+			};
+			if (IntersectsObjects(*this, ray, intersect_object))
+				return true;
 		}
 
 		if (filterMask & FILTER_RAGDOLL)
@@ -6195,24 +6477,23 @@ namespace wi::scene
 
 		if (filterMask & FILTER_OBJECT_ALL)
 		{
-			const size_t objectCount = std::min(objects.GetCount(), aabb_objects.size());
-			for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+			auto intersect_object = [&](uint32_t objectIndex)
 			{
 				const AABB& aabb = aabb_objects[objectIndex];
 				if ((layerMask & aabb.layerMask) == 0)
-					continue;
+					return false;
 				if (!sphere.intersects(aabb))
-					continue;
+					return false;
 
 				const ObjectComponent& object = objects[objectIndex];
 				if (object.meshID == INVALID_ENTITY)
-					continue;
+					return false;
 				if ((filterMask & object.GetFilterMask()) == 0)
-					continue;
+					return false;
 
 				const MeshComponent* mesh = meshes.GetComponent(object.meshID);
 				if (mesh == nullptr)
-					continue;
+					return false;
 
 				const Entity entity = objects.GetEntity(objectIndex);
 				const SoftBodyPhysicsComponent* softbody = softbodies.GetComponent(object.meshID);
@@ -6230,7 +6511,13 @@ namespace wi::scene
 					XMVECTOR p0;
 					XMVECTOR p1;
 					XMVECTOR p2;
-					if (softbody != nullptr && !softbody->boneData.empty())
+					if (mesh->IsBVHSkinned())
+					{
+						p0 = XMLoadFloat3(&mesh->bvh_skinned_positions[i0]);
+						p1 = XMLoadFloat3(&mesh->bvh_skinned_positions[i1]);
+						p2 = XMLoadFloat3(&mesh->bvh_skinned_positions[i2]);
+					}
+					else if (softbody != nullptr && !softbody->boneData.empty())
 					{
 						p0 = SkinVertex(*mesh, *softbody, i0);
 						p1 = SkinVertex(*mesh, *softbody, i1);
@@ -6410,8 +6697,9 @@ namespace wi::scene
 						}
 					}
 				}
-
-			}
+				return false;
+			};
+			IntersectsObjects(*this, sphere, intersect_object);
 		}
 
 		if (filterMask & FILTER_RAGDOLL)
@@ -6511,25 +6799,24 @@ namespace wi::scene
 
 		if (filterMask & FILTER_OBJECT_ALL)
 		{
-			const size_t objectCount = std::min(objects.GetCount(), aabb_objects.size());
-			for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+			auto intersect_object = [&](uint32_t objectIndex)
 			{
 				const AABB& aabb = aabb_objects[objectIndex];
 				if ((layerMask & aabb.layerMask) == 0)
-					continue;
+					return false;
 				if (capsule_aabb.intersects(aabb) == AABB::INTERSECTION_TYPE::OUTSIDE)
-					continue;
+					return false;
 
 				const ObjectComponent& object = objects[objectIndex];
 
 				if (object.meshID == INVALID_ENTITY)
-					continue;
+					return false;
 				if ((filterMask & object.GetFilterMask()) == 0)
-					continue;
+					return false;
 
 				const MeshComponent* mesh = meshes.GetComponent(object.meshID);
 				if (mesh == nullptr)
-					continue;
+					return false;
 
 				const Entity entity = objects.GetEntity(objectIndex);
 				const SoftBodyPhysicsComponent* softbody = softbodies.GetComponent(object.meshID);
@@ -6547,7 +6834,13 @@ namespace wi::scene
 					XMVECTOR p0;
 					XMVECTOR p1;
 					XMVECTOR p2;
-					if (softbody != nullptr && !softbody->boneData.empty())
+					if (mesh->IsBVHSkinned())
+					{
+						p0 = XMLoadFloat3(&mesh->bvh_skinned_positions[i0]);
+						p1 = XMLoadFloat3(&mesh->bvh_skinned_positions[i1]);
+						p2 = XMLoadFloat3(&mesh->bvh_skinned_positions[i2]);
+					}
+					else if (softbody != nullptr && !softbody->boneData.empty())
 					{
 						p0 = SkinVertex(*mesh, *softbody, i0);
 						p1 = SkinVertex(*mesh, *softbody, i1);
@@ -6841,8 +7134,9 @@ namespace wi::scene
 						}
 					}
 				}
-
-			}
+				return false;
+			};
+			IntersectsObjects(*this, capsule_aabb, intersect_object);
 		}
 
 		if (filterMask & FILTER_RAGDOLL)
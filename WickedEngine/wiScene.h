@@ -33,7 +33,7 @@ namespace wi::scene
 		wi::ecs::ComponentManager<TransformComponent>& transforms = componentLibrary.Register<TransformComponent>("wi::scene::Scene::transforms");
 		wi::ecs::ComponentManager<HierarchyComponent>& hierarchy = componentLibrary.Register<HierarchyComponent>("wi::scene::Scene::hierarchy");
 		wi::ecs::ComponentManager<MaterialComponent>& materials = componentLibrary.Register<MaterialComponent>("wi::scene::Scene::materials", 8); // version = 8
-		wi::ecs::ComponentManager<MeshComponent>& meshes = componentLibrary.Register<MeshComponent>("wi::scene::Scene::meshes", 4); // version = 4
+		wi::ecs::ComponentManager<MeshComponent>& meshes = componentLibrary.Register<MeshComponent>("wi::scene::Scene::meshes", 5); // version = 5
 		wi::ecs::ComponentManager<ImpostorComponent>& impostors = componentLibrary.Register<ImpostorComponent>("wi::scene::Scene::impostors");
 		wi::ecs::ComponentManager<ObjectComponent>& objects = componentLibrary.Register<ObjectComponent>("wi::scene::Scene::objects", 4); // version = 4
 		wi::ecs::ComponentManager<RigidBodyPhysicsComponent>& rigidbodies = componentLibrary.Register<RigidBodyPhysicsComponent>("wi::scene::Scene::rigidbodies", 4); // version = 4
@@ -86,11 +86,21 @@ namespace wi::scene
 		mutable bool acceleration_structure_update_requested = false;
 		void SetAccelerationStructureUpdateRequested(bool value = true) { acceleration_structure_update_requested = value; }
 		bool IsAccelerationStructureUpdateRequested() const { return acceleration_structure_update_requested; }
+		uint64_t acceleration_structure_generation = 0; // component generation at the last full acceleration structure update (0: not built yet)
+		wi::vector<wi::graphics::RaytracingAccelerationStructureDesc::TopLevel::Instance> TLAS_instances_prev; // last written TLAS instances, to detect changes without reading back upload memory
+		std::atomic_bool TLAS_instances_changed{ false };
+
+		// Change tracking of the hierarchy update, when none of these change, only the changed transforms and their descendants are updated:
+		uint64_t hierarchy_generation = 0;
+		wi::vector<wi::ecs::Entity> hierarchy_parents_prev;
+		wi::vector<uint32_t> layer_masks_prev;
+		wi::vector<uint8_t> hierarchy_recomputed; // transforms recomputed by the hierarchy jobs, merged into the dirty flags after the jobs
 		wi::Archive optimized_instatiation_data;
 		wi::vector<wi::primitive::Capsule> character_capsules;
 
 		// AABB culling streams:
 		wi::vector<wi::primitive::AABB> aabb_objects;
+		wi::primitive::AABBStream aabb_objects_stream; // SoA mirror of aabb_objects for batched culling, written by the object update system
 		wi::vector<wi::primitive::AABB> aabb_lights;
 		wi::vector<wi::primitive::AABB> aabb_probes;
 		wi::vector<wi::primitive::AABB> aabb_decals;
@@ -279,6 +289,12 @@ namespace wi::scene
 		ColliderComponent* colliders_cpu = nullptr;
 		ColliderComponent* colliders_gpu = nullptr;
 		wi::BVH collider_bvh;
+		// BVH over aabb_objects for the CPU intersection queries, it is refitted every update and rebuilt when the objects change
+		wi::BVH object_bvh;
+		uint64_t object_bvh_generation = ~0ull;
+		float object_bvh_cost = 0;
+		// Meshes whose BVH is refitted in the current update because they are skinned (or stopped being skinned):
+		wi::vector<size_t> bvh_refit_meshes;
 
 		// Ocean GPU state:
 		wi::Ocean ocean;
@@ -448,7 +464,9 @@ namespace wi::scene
 		void Component_DetachChildren(wi::ecs::Entity parent);
 
 		// Read/write whole scene into an archive
-		void Serialize(wi::Archive& archive);
+		//	precomputed_data: also write the derived data of components (mesh BVH, meshlets) so that loading doesn't need to rebuild them.
+		//	 This makes the archive larger and dependent on the platform's data layout, so it is meant for caches
+		void Serialize(wi::Archive& archive, bool precomputed_data = false);
 
 		void RunAnimationUpdateSystem(wi::jobsystem::context& ctx);
 		void RunTransformUpdateSystem(wi::jobsystem::context& ctx);
@@ -460,6 +478,9 @@ namespace wi::scene
 		void RunMaterialUpdateSystem(wi::jobsystem::context& ctx);
 		void RunImpostorUpdateSystem(wi::jobsystem::context& ctx);
 		void RunObjectUpdateSystem(wi::jobsystem::context& ctx);
+		void RunObjectBVHUpdateSystem(wi::jobsystem::context& ctx);
+		void RunMeshBVHSkinningSystem(wi::jobsystem::context& ctx);
+		void RunMeshBVHRefitSystem(wi::jobsystem::context& ctx);
 		void RunCameraUpdateSystem(wi::jobsystem::context& ctx);
 		void RunDecalUpdateSystem(wi::jobsystem::context& ctx);
 		void RunProbeUpdateSystem(wi::jobsystem::context& ctx);
@@ -511,6 +532,15 @@ namespace wi::scene
 		//	lod				:	specify min level of detail for meshes
 		bool IntersectsFirst(const wi::primitive::Ray& ray, uint32_t filterMask = wi::enums::FILTER_OPAQUE, uint32_t layerMask = ~0, uint32_t lod = 0) const;
 
+		// Given an array of rays, finds the closest intersection for each of them, distributed across job system threads
+		//	rays			:	the incoming rays that will be traced
+		//	count			:	number of rays (and results)
+		//	results			:	receives the closest intersection of rays[i] in results[i]
+		//	filterMask		:	filter based on type
+		//	layerMask		:	filter based on layer
+		//	lod				:	specify min level of detail for meshes
+		void IntersectsBatch(const wi::primitive::Ray* rays, size_t count, RayIntersectionResult* results, uint32_t filterMask = wi::enums::FILTER_OPAQUE, uint32_t layerMask = ~0, uint32_t lod = 0) const;
+
 		struct SphereIntersectionResult
 		{
 			wi::ecs::Entity entity = wi::ecs::INVALID_ENTITY;
@@ -835,102 +835,21 @@ namespace wi::scene
 
 		if (wi::renderer::IsMeshShaderAllowed())
 		{
-			const size_t max_vertices = MESHLET_VERTEX_COUNT;
-			const size_t max_triangles = MESHLET_TRIANGLE_COUNT;
-			const float cone_weight = 0.5f;
-
-			const uint32_t lod_count = GetLODCount();
-			for (uint32_t lod = 0; lod < lod_count; ++lod)
+			ClusterData cluster_data;
+			uint32_t first_subset = 0;
+			uint32_t last_subset = 0;
+			GetLODSubsetRange(GetLODCount() - 1, first_subset, last_subset);
+			if (precomputed_clusters.cluster_ranges.size() == last_subset)
 			{
-				uint32_t first_subset = 0;
-				uint32_t last_subset = 0;
-				GetLODSubsetRange(lod, first_subset, last_subset);
-				for (uint32_t subsetIndex = first_subset; subsetIndex < last_subset; ++subsetIndex)
-				{
-					const MeshSubset& subset = subsets[subsetIndex];
-					SubsetClusterRange& meshlet_range = cluster_ranges.emplace_back();
-
-					if (subset.indexCount == 0)
-						continue;
-
-					size_t max_meshlets = meshopt_buildMeshletsBound(subset.indexCount, max_vertices, max_triangles);
-					std::vector<meshopt_Meshlet> meshopt_meshlets(max_meshlets);
-					std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
-					std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
-
-					size_t meshlet_count = meshopt_buildMeshlets(
-						meshopt_meshlets.data(),
-						meshlet_vertices.data(),
-						meshlet_triangles.data(),
-						&indices[subset.indexOffset],
-						subset.indexCount,
-						&vertex_positions[0].x,
-						vertex_positions.size(),
-						sizeof(XMFLOAT3),
-						max_vertices,
-						max_triangles,
-						cone_weight
-					);
-
-					clusters.reserve(clusters.size() + meshlet_count);
-					cluster_bounds.reserve(cluster_bounds.size() + meshlet_count);
-
-					meshlet_range.clusterOffset = (uint32_t)clusters.size();
-					meshlet_range.clusterCount = (uint32_t)meshlet_count;
-
-					const meshopt_Meshlet& last = meshopt_meshlets[meshlet_count - 1];
-
-					meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
-					meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
-					meshopt_meshlets.resize(meshlet_count);
-
-					for (size_t i = 0; i < meshopt_meshlets.size(); ++i)
-					{
-						const meshopt_Meshlet& meshlet = meshopt_meshlets[i];
-						meshopt_optimizeMeshlet(
-							&meshlet_vertices[meshlet.vertex_offset],
-							&meshlet_triangles[meshlet.triangle_offset],
-							meshlet.triangle_count,
-							meshlet.vertex_count
-						);
-
-						meshopt_Bounds bounds = meshopt_computeMeshletBounds(
-							&meshlet_vertices[meshlet.vertex_offset],
-							&meshlet_triangles[meshlet.triangle_offset],
-							meshlet.triangle_count,
-							&vertex_positions[0].x,
-							vertex_positions.size(),
-							sizeof(XMFLOAT3)
-						);
-
-						ShaderClusterBounds& clusterbound = cluster_bounds.emplace_back();
-						clusterbound.sphere.center.x = bounds.center[0];
-						clusterbound.sphere.center.y = bounds.center[1];
-						clusterbound.sphere.center.z = bounds.center[2];
-						clusterbound.sphere.radius = bounds.radius;
-						clusterbound.cone_axis.x = -bounds.cone_axis[0];
-						clusterbound.cone_axis.y = -bounds.cone_axis[1];
-						clusterbound.cone_axis.z = -bounds.cone_axis[2];
-						clusterbound.cone_cutoff = bounds.cone_cutoff;
-
-						ShaderCluster& cluster = clusters.emplace_back();
-						cluster.vertexCount = meshlet.vertex_count;
-						cluster.triangleCount = meshlet.triangle_count;
-						for (size_t tri = 0; tri < meshlet.triangle_count; ++tri)
-						{
-							cluster.triangles[tri].init(
-								meshlet_triangles[meshlet.triangle_offset + tri * 3 + 0],
-								meshlet_triangles[meshlet.triangle_offset + tri * 3 + 1],
-								meshlet_triangles[meshlet.triangle_offset + tri * 3 + 2]
-							);
-						}
-						for (size_t vert = 0; vert < meshlet.vertex_count; ++vert)
-						{
-							cluster.vertices[vert] = meshlet_vertices[meshlet.vertex_offset + vert];
-						}
-					}
-				}
+				cluster_data = std::move(precomputed_clusters);
 			}
+			else
+			{
+				BuildClusters(cluster_data);
+			}
+			clusters = std::move(cluster_data.clusters);
+			cluster_bounds = std::move(cluster_data.cluster_bounds);
+			cluster_ranges = std::move(cluster_data.cluster_ranges);
 
 			bd.size = AlignTo(bd.size, sizeof(ShaderCluster));
 			bd.size = AlignTo(bd.size + clusters.size() * sizeof(ShaderCluster), alignment);
@@ -938,6 +857,7 @@ namespace wi::scene
 			bd.size = AlignTo(bd.size, sizeof(ShaderClusterBounds));
 			bd.size = AlignTo(bd.size + cluster_bounds.size() * sizeof(ShaderClusterBounds), alignment);
 		}
+		precomputed_clusters = {};
 
 		auto init_callback = [&](void* dest) {
 			uint8_t* buffer_data = (uint8_t*)dest;
@@ -1431,9 +1351,111 @@ namespace wi::scene
 			device->SetName(&BLASes[lod], std::string("MeshComponent::BLAS[LOD" + std::to_string(lod) + "]").c_str());
 		}
 	}
-	void MeshComponent::BuildBVH()
+	void MeshComponent::BuildClusters(ClusterData& data) const
+	{
+		data = {};
+
+		const size_t max_vertices = MESHLET_VERTEX_COUNT;
+		const size_t max_triangles = MESHLET_TRIANGLE_COUNT;
+		const float cone_weight = 0.5f;
+
+		const uint32_t lod_count = GetLODCount();
+		for (uint32_t lod = 0; lod < lod_count; ++lod)
+		{
+			uint32_t first_subset = 0;
+			uint32_t last_subset = 0;
+			GetLODSubsetRange(lod, first_subset, last_subset);
+			for (uint32_t subsetIndex = first_subset; subsetIndex < last_subset; ++subsetIndex)
+			{
+				const MeshSubset& subset = subsets[subsetIndex];
+				SubsetClusterRange& meshlet_range = data.cluster_ranges.emplace_back();
+
+				if (subset.indexCount == 0)
+					continue;
+
+				size_t max_meshlets = meshopt_buildMeshletsBound(subset.indexCount, max_vertices, max_triangles);
+				std::vector<meshopt_Meshlet> meshopt_meshlets(max_meshlets);
+				std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+				std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+				size_t meshlet_count = meshopt_buildMeshlets(
+					meshopt_meshlets.data(),
+					meshlet_vertices.data(),
+					meshlet_triangles.data(),
+					&indices[subset.indexOffset],
+					subset.indexCount,
+					&vertex_positions[0].x,
+					vertex_positions.size(),
+					sizeof(XMFLOAT3),
+					max_vertices,
+					max_triangles,
+					cone_weight
+				);
+
+				data.clusters.reserve(data.clusters.size() + meshlet_count);
+				data.cluster_bounds.reserve(data.cluster_bounds.size() + meshlet_count);
+
+				meshlet_range.clusterOffset = (uint32_t)data.clusters.size();
+				meshlet_range.clusterCount = (uint32_t)meshlet_count;
+
+				const meshopt_Meshlet& last = meshopt_meshlets[meshlet_count - 1];
+
+				meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
+				meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+				meshopt_meshlets.resize(meshlet_count);
+
+				for (size_t i = 0; i < meshopt_meshlets.size(); ++i)
+				{
+					const meshopt_Meshlet& meshlet = meshopt_meshlets[i];
+					meshopt_optimizeMeshlet(
+						&meshlet_vertices[meshlet.vertex_offset],
+						&meshlet_triangles[meshlet.triangle_offset],
+						meshlet.triangle_count,
+						meshlet.vertex_count
+					);
+
+					meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+						&meshlet_vertices[meshlet.vertex_offset],
+						&meshlet_triangles[meshlet.triangle_offset],
+						meshlet.triangle_count,
+						&vertex_positions[0].x,
+						vertex_positions.size(),
+						sizeof(XMFLOAT3)
+					);
+
+					ShaderClusterBounds& clusterbound = data.cluster_bounds.emplace_back();
+					clusterbound.sphere.center.x = bounds.center[0];
+					clusterbound.sphere.center.y = bounds.center[1];
+					clusterbound.sphere.center.z = bounds.center[2];
+					clusterbound.sphere.radius = bounds.radius;
+					clusterbound.cone_axis.x = -bounds.cone_axis[0];
+					clusterbound.cone_axis.y = -bounds.cone_axis[1];
+					clusterbound.cone_axis.z = -bounds.cone_axis[2];
+					clusterbound.cone_cutoff = bounds.cone_cutoff;
+
+					ShaderCluster& cluster = data.clusters.emplace_back();
+					cluster.vertexCount = meshlet.vertex_count;
+					cluster.triangleCount = meshlet.triangle_count;
+					for (size_t tri = 0; tri < meshlet.triangle_count; ++tri)
+					{
+						cluster.triangles[tri].init(
+							meshlet_triangles[meshlet.triangle_offset + tri * 3 + 0],
+							meshlet_triangles[meshlet.triangle_offset + tri * 3 + 1],
+							meshlet_triangles[meshlet.triangle_offset + tri * 3 + 2]
+						);
+					}
+					for (size_t vert = 0; vert < meshlet.vertex_count; ++vert)
+					{
+						cluster.vertices[vert] = meshlet_vertices[meshlet.vertex_offset + vert];
+					}
+				}
+			}
+		}
+	}
+	void MeshComponent::BuildBVH(wi::BVH::BuildMode mode)
 	{
 		bvh_leaf_aabbs.clear();
+		bvh_skinned_positions.clear();
 		uint32_t first_subset = 0;
 		uint32_t last_subset = 0;
 		GetLODSubsetRange(0, first_subset, last_subset);
@@ -1458,7 +1480,25 @@ namespace wi::scene
 				bvh_leaf_aabbs.push_back(aabb);
 			}
 		}
-		bvh.Build(bvh_leaf_aabbs.data(), (uint32_t)bvh_leaf_aabbs.size());
+		bvh.Build(bvh_leaf_aabbs.data(), (uint32_t)bvh_leaf_aabbs.size(), mode);
+	}
+	void MeshComponent::RefitBVH()
+	{
+		if (!bvh.IsValid() || bvh.leaf_count != (uint32_t)bvh_leaf_aabbs.size())
+			return;
+		const XMFLOAT3* positions = IsBVHSkinned() ? bvh_skinned_positions.data() : vertex_positions.data();
+		for (AABB& aabb : bvh_leaf_aabbs)
+		{
+			const uint32_t triangleIndex = aabb.layerMask;
+			const uint32_t subsetIndex = aabb.userdata;
+			const uint32_t indexOffset = subsets[subsetIndex].indexOffset;
+			const XMFLOAT3& p0 = positions[indices[indexOffset + triangleIndex * 3 + 0]];
+			const XMFLOAT3& p1 = positions[indices[indexOffset + triangleIndex * 3 + 1]];
+			const XMFLOAT3& p2 = positions[indices[indexOffset + triangleIndex * 3 + 2]];
+			aabb._min = wi::math::Min(p0, wi::math::Min(p1, p2));
+			aabb._max = wi::math::Max(p0, wi::math::Max(p1, p2));
+		}
+		bvh.Refit(bvh_leaf_aabbs.data());
 	}
 	void MeshComponent::ComputeNormals(COMPUTE_NORMALS compute)
 	{
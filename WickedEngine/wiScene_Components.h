@@ -471,6 +471,8 @@ namespace wi::scene
 
 		wi::vector<wi::primitive::AABB> bvh_leaf_aabbs;
 		wi::BVH bvh;
+		// Positions skinned on the CPU by the armature or soft body that bvh and bvh_leaf_aabbs are currently refitted to (empty when not skinned):
+		wi::vector<XMFLOAT3> bvh_skinned_positions;
 
 		struct SubsetClusterRange
 		{
@@ -479,6 +481,16 @@ namespace wi::scene
 		};
 		wi::vector<SubsetClusterRange> cluster_ranges;
 
+		// Meshlet clusters that were built offline (for example loaded from a scene cache)
+		//	They are consumed by the next CreateRenderData() instead of rebuilding the clusters
+		struct ClusterData
+		{
+			wi::vector<ShaderCluster> clusters;
+			wi::vector<ShaderClusterBounds> cluster_bounds;
+			wi::vector<SubsetClusterRange> cluster_ranges;
+		};
+		ClusterData precomputed_clusters;
+
 		inline void SetRenderable(bool value) { if (value) { _flags |= RENDERABLE; } else { _flags &= ~RENDERABLE; } }
 		inline void SetDoubleSided(bool value) { if (value) { _flags |= DOUBLE_SIDED; } else { _flags &= ~DOUBLE_SIDED; } }
 		inline void SetDoubleSidedShadow(bool value) { if (value) { _flags |= DOUBLE_SIDED_SHADOW; } else { _flags &= ~DOUBLE_SIDED_SHADOW; } }
@@ -487,7 +499,7 @@ namespace wi::scene
 		// Enable disable CPU-side BVH acceleration structure
 		//	true: BVH will be built immediately if it doesn't exist yet
 		//	false: BVH will be deleted immediately if it exists
-		inline void SetBVHEnabled(bool value) { if (value) { _flags |= BVH_ENABLED; if (!bvh.IsValid()) { BuildBVH(); } } else { _flags &= ~BVH_ENABLED; bvh = {}; bvh_leaf_aabbs.clear(); } }
+		inline void SetBVHEnabled(bool value) { if (value) { _flags |= BVH_ENABLED; if (!bvh.IsValid()) { BuildBVH(); } } else { _flags &= ~BVH_ENABLED; bvh = {}; bvh_leaf_aabbs.clear(); bvh_skinned_positions.clear(); } }
 
 		// Disable quantization of position GPU data. You can use this if you notice inaccuracy in positions.
 		//	This should be enabled for connecting meshes like terrain chunks if their AABB is not consistent with each other
@@ -531,7 +543,17 @@ namespace wi::scene
 		void CreateRaytracingRenderData();
 
 		// Rebuilds CPU-side BVH acceleration structure
-		void BuildBVH();
+		//	mode	:	SAH gives faster queries, FAST is for meshes that are modified and rebuilt interactively
+		void BuildBVH(wi::BVH::BuildMode mode = wi::BVH::BuildMode::SAH);
+
+		// Refits the CPU-side BVH to bvh_skinned_positions (or the bind pose when it is empty) without changing the tree
+		void RefitBVH();
+
+		// Whether the CPU-side BVH was refitted to skinned positions, then intersection queries should read the triangles from bvh_skinned_positions
+		inline bool IsBVHSkinned() const { return !bvh_skinned_positions.empty() && bvh_skinned_positions.size() == vertex_positions.size(); }
+
+		// Builds the meshlet clusters of all subsets (this is what CreateRenderData() uploads when mesh shaders are allowed)
+		void BuildClusters(ClusterData& data) const;
 
 		size_t GetMemoryUsageCPU() const;
 		size_t GetMemoryUsageGPU() const;
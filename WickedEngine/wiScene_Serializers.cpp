@@ -5,6 +5,7 @@
 #include "wiHelper.h"
 #include "wiBacklog.h"
 #include "wiTimer.h"
+#include "wiRenderer.h"
 #include "wiVector.h"
 #include "shaders/ShaderInterop_DDGI.h"
 
@@ -423,6 +424,12 @@ namespace wi::scene
 			}
 		}
 	}
+	// Flags of the precomputed (derived) mesh data blocks:
+	enum MESH_PRECOMPUTED
+	{
+		PRECOMPUTED_BVH = 1 << 0,
+		PRECOMPUTED_CLUSTERS = 1 << 1,
+	};
 	void MeshComponent::Serialize(wi::Archive& archive, EntitySerializer& seri)
 	{
 		if (archive.IsReadMode())
@@ -512,10 +519,53 @@ namespace wi::scene
 				archive >> vertex_boneweights2;
 			}
 
-			wi::jobsystem::Execute(seri.ctx, [&](wi::jobsystem::JobArgs args) {
+			bool bvh_loaded = false;
+			if (seri.GetVersion() >= 5)
+			{
+				uint8_t precomputed = 0;
+				archive >> precomputed;
+				if (precomputed & PRECOMPUTED_BVH)
+				{
+					bvh.Serialize(archive);
+					size_t leaf_count = 0;
+					archive >> leaf_count;
+					if (!archive.CheckReadCount(leaf_count, sizeof(wi::primitive::AABB)))
+					{
+						leaf_count = 0;
+					}
+					bvh_leaf_aabbs.resize(leaf_count);
+					bvh_loaded = archive.ReadRaw(bvh_leaf_aabbs.data(), sizeof(wi::primitive::AABB) * leaf_count);
+				}
+				if (precomputed & PRECOMPUTED_CLUSTERS)
+				{
+					size_t count = 0;
+					archive >> count;
+					if (!archive.CheckReadCount(count, sizeof(ShaderCluster) + sizeof(ShaderClusterBounds)))
+					{
+						count = 0;
+					}
+					precomputed_clusters.clusters.resize(count);
+					archive.ReadRaw(precomputed_clusters.clusters.data(), sizeof(ShaderCluster) * count);
+					precomputed_clusters.cluster_bounds.resize(count);
+					archive.ReadRaw(precomputed_clusters.cluster_bounds.data(), sizeof(ShaderClusterBounds) * count);
+					archive >> count;
+					if (!archive.CheckReadCount(count, sizeof(SubsetClusterRange)))
+					{
+						count = 0;
+					}
+					precomputed_clusters.cluster_ranges.resize(count);
+					archive.ReadRaw(precomputed_clusters.cluster_ranges.data(), sizeof(SubsetClusterRange) * count);
+					if (archive.IsReadFailed())
+					{
+						precomputed_clusters = {};
+					}
+				}
+			}
+
+			wi::jobsystem::Execute(seri.ctx, [this, bvh_loaded](wi::jobsystem::JobArgs args) {
 				CreateRenderData();
 
-				if (IsBVHEnabled())
+				if (IsBVHEnabled() && !bvh_loaded)
 				{
 					BuildBVH();
 				}
@@ -604,6 +654,40 @@ namespace wi::scene
 				archive << vertex_boneweights2;
 			}
 
+			if (seri.GetVersion() >= 5)
+			{
+				uint8_t precomputed = 0;
+				ClusterData cluster_data;
+				if (seri.precomputed_data)
+				{
+					if (IsBVHEnabled() && bvh.IsValid())
+					{
+						precomputed |= PRECOMPUTED_BVH;
+					}
+					if (wi::renderer::IsMeshShaderAllowed())
+					{
+						// The clusters are not kept on the CPU after they are uploaded, so they are rebuilt here:
+						BuildClusters(cluster_data);
+						precomputed |= PRECOMPUTED_CLUSTERS;
+					}
+				}
+				archive << precomputed;
+				if (precomputed & PRECOMPUTED_BVH)
+				{
+					bvh.Serialize(archive);
+					archive << bvh_leaf_aabbs.size();
+					archive.WriteRaw(bvh_leaf_aabbs.data(), sizeof(wi::primitive::AABB) * bvh_leaf_aabbs.size());
+				}
+				if (precomputed & PRECOMPUTED_CLUSTERS)
+				{
+					archive << cluster_data.clusters.size();
+					archive.WriteRaw(cluster_data.clusters.data(), sizeof(ShaderCluster) * cluster_data.clusters.size());
+					archive.WriteRaw(cluster_data.cluster_bounds.data(), sizeof(ShaderClusterBounds) * cluster_data.cluster_bounds.size());
+					archive << cluster_data.cluster_ranges.size();
+					archive.WriteRaw(cluster_data.cluster_ranges.data(), sizeof(SubsetClusterRange) * cluster_data.cluster_ranges.size());
+				}
+			}
+
 		}
 	}
 	void ImpostorComponent::Serialize(wi::Archive& archive, EntitySerializer& seri)
@@ -2295,7 +2379,7 @@ namespace wi::scene
 		}
 	}
 
-	void Scene::Serialize(wi::Archive& archive)
+	void Scene::Serialize(wi::Archive& archive, bool precomputed_data)
 	{
 		wi::Timer timer;
 
@@ -2345,6 +2429,7 @@ namespace wi::scene
 		// With this we will ensure that serialized entities are unique and persistent across the scene:
 		EntitySerializer seri;
 		seri.ctx.priority = wi::jobsystem::Priority::Low; // serialization tasks will be low priority to not block rendering if scene loading is asynchronous
+		seri.precomputed_data = precomputed_data;
 
 		if(archive.GetVersion() >= 84)
 		{